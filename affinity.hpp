@@ -0,0 +1,461 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/affinity.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_AFFINITY_HPP
+#define DMITIGR_OS_AFFINITY_HPP
+
+#include "../base/assert.hpp"
+#include "cpu.hpp"
+#include "exceptions.hpp"
+#include "pid.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace dmitigr::os {
+
+// -----------------------------------------------------------------------------
+// Cpu_set
+// -----------------------------------------------------------------------------
+
+namespace detail {
+
+/**
+ * @returns The number of CPUs of the CPU mask of the kernel (`nr_cpu_ids`),
+ * but not less than `CPU_SETSIZE`.
+ *
+ * @details The kernel rejects the masks which are too small to hold all the
+ * possible CPUs by `EINVAL`, so the value is taken from
+ * `/sys/devices/system/cpu/possible` or, if it's unavailable, from
+ * `cpu_topology()`.
+ */
+inline std::size_t cpu_mask_size()
+{
+  static const std::size_t result = []
+  {
+    std::size_t size{CPU_SETSIZE};
+    const auto possible = read_sysfs(std::string{sysfs_cpu_root} + "possible");
+    const auto cpus = possible ? to_cpu_list(*possible) : std::nullopt;
+    if (cpus && !cpus->empty())
+      size = std::max<std::size_t>(size,
+        *std::max_element(cpus->cbegin(), cpus->cend()) + std::size_t{1});
+    else {
+      for (const auto& cpu : cpu_topology().cpus())
+        size = std::max<std::size_t>(size, cpu.id + std::size_t{1});
+    }
+    return size;
+  }();
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief A set of logical CPUs.
+ *
+ * @details The set has the layout of the CPU mask of the kernel, so it's
+ * passed to the system calls as is. The mask is allocated by the size of
+ * `CPU_ALLOC_SIZE(detail::cpu_mask_size())` bytes, so the systems with more
+ * than `CPU_SETSIZE` CPUs are supported. The mask grows if the CPU beyond
+ * its size is added.
+ */
+class Cpu_set final {
+  using Word = unsigned long;
+  static constexpr std::size_t word_bits{sizeof(Word) * CHAR_BIT};
+
+public:
+  /// Constructs an empty set.
+  Cpu_set()
+    : words_(CPU_ALLOC_SIZE(detail::cpu_mask_size()) / sizeof(Word))
+  {}
+
+  /// Constructs the set of `cpus`.
+  Cpu_set(const std::initializer_list<unsigned> cpus)
+    : Cpu_set{}
+  {
+    for (const auto cpu : cpus)
+      set(cpu);
+  }
+
+  /// @returns The maximum number of CPUs of the set without growing.
+  std::size_t max_size() const noexcept
+  {
+    return words_.size() * word_bits;
+  }
+
+  /// @returns `true` if the `cpu` is in the set.
+  bool test(const unsigned cpu) const noexcept
+  {
+    return cpu < max_size() && (words_[cpu / word_bits] & mask(cpu));
+  }
+
+  /// Adds the `cpu` to the set.
+  Cpu_set& set(const unsigned cpu)
+  {
+    if (!(cpu < max_size()))
+      words_.resize(CPU_ALLOC_SIZE(cpu + std::size_t{1}) / sizeof(Word));
+    words_[cpu / word_bits] |= mask(cpu);
+    return *this;
+  }
+
+  /// Removes the `cpu` from the set.
+  Cpu_set& reset(const unsigned cpu) noexcept
+  {
+    if (cpu < max_size())
+      words_[cpu / word_bits] &= ~mask(cpu);
+    return *this;
+  }
+
+  /// Removes all the CPUs from the set.
+  void clear() noexcept
+  {
+    std::fill(words_.begin(), words_.end(), 0);
+  }
+
+  /// @returns The number of CPUs in the set.
+  std::size_t count() const noexcept
+  {
+    std::size_t result{};
+    for (const auto word : words_)
+      result += __builtin_popcountl(word);
+    return result;
+  }
+
+  /// @returns `true` if the set is empty.
+  bool empty() const noexcept
+  {
+    return std::all_of(words_.cbegin(), words_.cend(),
+      [](const Word word){return !word;});
+  }
+
+  /// @returns The CPUs of the set in ascending order.
+  std::vector<unsigned> cpus() const
+  {
+    std::vector<unsigned> result;
+    for (std::size_t i{}; i < words_.size(); ++i) {
+      for (auto word = words_[i]; word; word &= word - 1)
+        result.push_back(static_cast<unsigned>(i * word_bits +
+            __builtin_ctzl(word)));
+    }
+    return result;
+  }
+
+  /// Adds the CPUs of `rhs` to this set.
+  Cpu_set& operator|=(const Cpu_set& rhs)
+  {
+    if (words_.size() < rhs.words_.size())
+      words_.resize(rhs.words_.size());
+    for (std::size_t i{}; i < rhs.words_.size(); ++i)
+      words_[i] |= rhs.words_[i];
+    return *this;
+  }
+
+  /// Removes the CPUs which are not in `rhs` from this set.
+  Cpu_set& operator&=(const Cpu_set& rhs) noexcept
+  {
+    for (std::size_t i{}; i < words_.size(); ++i)
+      words_[i] &= i < rhs.words_.size() ? rhs.words_[i] : 0;
+    return *this;
+  }
+
+  /// @returns `true` if the sets contain the same CPUs.
+  friend bool operator==(const Cpu_set& lhs, const Cpu_set& rhs) noexcept
+  {
+    const auto& [shorter, longer] = lhs.words_.size() < rhs.words_.size() ?
+      std::tie(lhs.words_, rhs.words_) : std::tie(rhs.words_, lhs.words_);
+    return std::equal(shorter.cbegin(), shorter.cend(), longer.cbegin()) &&
+      std::all_of(longer.cbegin() + shorter.size(), longer.cend(),
+        [](const Word word){return !word;});
+  }
+
+  /// @returns `true` if the sets are not equal.
+  friend bool operator!=(const Cpu_set& lhs, const Cpu_set& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  /// @returns The pointer to the CPU mask.
+  const cpu_set_t* native() const noexcept
+  {
+    return reinterpret_cast<const cpu_set_t*>(words_.data());
+  }
+
+  /// @overload
+  cpu_set_t* native() noexcept
+  {
+    return reinterpret_cast<cpu_set_t*>(words_.data());
+  }
+
+  /// @returns The size of the CPU mask in bytes.
+  std::size_t native_size() const noexcept
+  {
+    return words_.size() * sizeof(Word);
+  }
+
+private:
+  std::vector<Word> words_;
+
+  static Word mask(const unsigned cpu) noexcept
+  {
+    return Word{1} << (cpu % word_bits);
+  }
+};
+
+/// @returns The set of all the CPUs of the `topology`.
+inline Cpu_set to_cpu_set(const Cpu_topology& topology)
+{
+  Cpu_set result;
+  for (const auto& cpu : topology.cpus())
+    result.set(cpu.id);
+  return result;
+}
+
+/// @returns The set of the SMT siblings of the `core` of the `topology`.
+inline Cpu_set to_cpu_set(const Cpu_topology& topology,
+  const Cpu_topology::Core& core)
+{
+  Cpu_set result;
+  for (const auto cpu : topology.cpus(core))
+    result.set(cpu);
+  return result;
+}
+
+/// @returns The set of the CPUs of the `node` of the `topology`.
+inline Cpu_set to_cpu_set(const Cpu_topology& topology,
+  const Cpu_topology::Node& node)
+{
+  Cpu_set result;
+  for (const auto cpu : topology.cpus(node))
+    result.set(cpu);
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// Thread affinity
+// -----------------------------------------------------------------------------
+
+/**
+ * @returns The affinity of the `thread`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline Cpu_set thread_affinity(const std::thread::native_handle_type thread)
+{
+  Cpu_set result;
+  if (const int err = pthread_getaffinity_np(thread, result.native_size(),
+      result.native()))
+    throw Sys_exception{err, "cannot get thread CPU affinity"};
+  return result;
+}
+
+/// @overload
+inline Cpu_set thread_affinity()
+{
+  return thread_affinity(pthread_self());
+}
+
+/**
+ * @brief Sets the affinity of the `thread` to `cpus`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void set_thread_affinity(const std::thread::native_handle_type thread,
+  const Cpu_set& cpus)
+{
+  if (const int err = pthread_setaffinity_np(thread, cpus.native_size(),
+      cpus.native()))
+    throw Sys_exception{err, "cannot set thread CPU affinity"};
+}
+
+/// @overload
+inline void set_thread_affinity(const Cpu_set& cpus)
+{
+  set_thread_affinity(pthread_self(), cpus);
+}
+
+// -----------------------------------------------------------------------------
+// Process affinity
+// -----------------------------------------------------------------------------
+
+/**
+ * @returns The affinity of the main thread of the process `pid`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline Cpu_set process_affinity(const Pid pid = os::pid())
+{
+  Cpu_set result;
+  if (sched_getaffinity(pid, result.native_size(), result.native()))
+    throw Sys_exception{"cannot get CPU affinity of process "
+      +std::to_string(pid)};
+  return result;
+}
+
+/**
+ * @brief Sets the affinity of all the threads of the process `pid` to `cpus`.
+ *
+ * @details The threads are enumerated by `/proc/<pid>/task`. The threads
+ * created after that inherit the affinity of their creators.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void set_process_affinity(const Pid pid, const Cpu_set& cpus)
+{
+  const auto what = "cannot set CPU affinity of process "+std::to_string(pid);
+  const auto path = "/proc/"+std::to_string(pid)+"/task";
+  const std::unique_ptr<DIR, int(*)(DIR*)> dir{::opendir(path.c_str()),
+    &::closedir};
+  if (!dir)
+    throw Sys_exception{what};
+
+  errno = 0;
+  while (const auto* const entry = ::readdir(dir.get())) {
+    const auto tid = detail::to_unsigned<Pid>(entry->d_name);
+    if (tid && sched_setaffinity(*tid, cpus.native_size(), cpus.native())) {
+      // The thread may have exited since enumeration.
+      if (errno != ESRCH)
+        throw Sys_exception{what};
+    }
+    errno = 0;
+  }
+  if (errno)
+    throw Sys_exception{what};
+}
+
+/// @overload
+inline void set_process_affinity(const Cpu_set& cpus)
+{
+  set_process_affinity(pid(), cpus);
+}
+
+// -----------------------------------------------------------------------------
+// Pinning
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Pins the calling thread to the logical `cpu`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void pin_thread_to_cpu(const unsigned cpu)
+{
+  set_thread_affinity(Cpu_set{cpu});
+}
+
+/**
+ * @brief Pins the calling thread to the SMT siblings of the physical core.
+ *
+ * @param core The index of the core in `topology.cores()`.
+ *
+ * @par Requires
+ * `(core < topology.cores().size())`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void pin_thread_to_core(const unsigned core,
+  const Cpu_topology& topology = cpu_topology())
+{
+  DMITIGR_ASSERT(core < topology.cores().size());
+  set_thread_affinity(to_cpu_set(topology, topology.cores()[core]));
+}
+
+/**
+ * @brief Pins the calling thread to the CPUs of the NUMA node.
+ *
+ * @param node The index of the node in `topology.nodes()`.
+ *
+ * @par Requires
+ * `(node < topology.nodes().size())`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void pin_thread_to_node(const unsigned node,
+  const Cpu_topology& topology = cpu_topology())
+{
+  DMITIGR_ASSERT(node < topology.nodes().size());
+  set_thread_affinity(to_cpu_set(topology, topology.nodes()[node]));
+}
+
+/**
+ * @returns The affinities for `thread_count` threads spread across the CPUs
+ * of the NUMA node: one CPU per thread, the distinct physical cores first,
+ * then the remaining SMT siblings. If there are more threads than CPUs, the
+ * CPUs are reused round-robin.
+ *
+ * @param node The index of the node in `topology.nodes()`.
+ *
+ * @par Requires
+ * `(node < topology.nodes().size())`.
+ */
+inline std::vector<Cpu_set> spread_across_node(const unsigned node,
+  const std::size_t thread_count, const Cpu_topology& topology = cpu_topology())
+{
+  DMITIGR_ASSERT(node < topology.nodes().size());
+
+  // Order the CPUs of the node by the sibling rank within their cores.
+  std::vector<std::pair<unsigned, unsigned>> order; // {rank, cpu}
+  for (const auto cpu : topology.cpus(topology.nodes()[node])) {
+    const auto siblings = topology.cpus(topology.cores()[topology.cpu(cpu)->core]);
+    const auto rank = std::find(siblings.begin(), siblings.end(), cpu) -
+      siblings.begin();
+    order.emplace_back(static_cast<unsigned>(rank), cpu);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<Cpu_set> result;
+  if (!order.empty()) {
+    result.reserve(thread_count);
+    for (std::size_t i{}; i < thread_count; ++i)
+      result.push_back(Cpu_set{order[i % order.size()].second});
+  }
+  return result;
+}
+
+/**
+ * @returns The affinities for one thread per physical core of the
+ * `topology`, in the order of `topology.cores()`. Each thread is allowed to
+ * run on the first SMT sibling of its core only.
+ */
+inline std::vector<Cpu_set> one_thread_per_core(
+  const Cpu_topology& topology = cpu_topology())
+{
+  std::vector<Cpu_set> result;
+  result.reserve(topology.cores().size());
+  for (const auto& core : topology.cores())
+    result.push_back(Cpu_set{topology.cpus(core)[0]});
+  return result;
+}
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_AFFINITY_HPP
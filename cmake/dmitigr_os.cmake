@@ -31,6 +31,7 @@ set(dmitigr_libs_os_deps base)
 # ------------------------------------------------------------------------------
 
 set(dmitigr_os_headers
+  cpu.hpp
   environment.hpp
   error.hpp
   exceptions.hpp
@@ -44,6 +45,22 @@ set(dmitigr_os_implementations
 
 if(WIN32)
   list(APPEND dmitigr_os_headers windows.hpp)
+else()
+  list(APPEND dmitigr_os_headers posix.hpp)
+endif()
+
+if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  list(APPEND dmitigr_os_headers
+    affinity.hpp
+    hugepages.hpp
+    io.hpp
+    ipc_pipe.hpp
+    ipc_ring.hpp
+    ipc_socket.hpp
+    numa.hpp
+    process.hpp
+    process_sampler.hpp
+    )
 endif()
 
 # ------------------------------------------------------------------------------
@@ -62,6 +79,10 @@ endif()
 # ------------------------------------------------------------------------------
 
 if(DMITIGR_LIBS_TESTS)
-  set(dmitigr_os_tests smbios)
+  set(dmitigr_os_tests benchmark_smbios cpu environment smbios smbios_decode smbios_fuzz)
+  if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    list(APPEND dmitigr_os_tests affinity hugepages io ipc_pipe ipc_ring ipc_socket
+      numa process process_sampler)
+  endif()
   set(dmitigr_os_tests_target_link_libraries dmitigr_base)
 endif()
@@ -0,0 +1,921 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DMITIGR_OS_CPU_HPP
+#define DMITIGR_OS_CPU_HPP
+
+#include "../base/assert.hpp"
+#if defined(_WIN32) || defined(__linux__)
+#include "smbios.hpp"
+#endif
+#ifndef _WIN32
+#include "posix.hpp"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace dmitigr::os {
+
+namespace detail {
+
+/// @returns The unsigned integer `str`, or `std::nullopt` on failure.
+template<typename T = unsigned>
+std::optional<T> to_unsigned(const std::string_view str) noexcept
+{
+  T result{};
+  const auto* const end = str.data() + str.size();
+  const auto [ptr, ec] = std::from_chars(str.data(), end, result);
+  return ec == std::errc{} && ptr == end ? std::make_optional(result) :
+    std::nullopt;
+}
+
+/// @returns The size like "48K" in bytes, or `std::nullopt` on failure.
+inline std::optional<std::size_t> to_size(std::string_view str) noexcept
+{
+  std::size_t multiplier{1};
+  if (!str.empty()) {
+    switch (str.back()) {
+    case 'K': multiplier = std::size_t{1} << 10; break;
+    case 'M': multiplier = std::size_t{1} << 20; break;
+    case 'G': multiplier = std::size_t{1} << 30; break;
+    }
+    if (multiplier != 1)
+      str.remove_suffix(1);
+  }
+  const auto result = to_unsigned<std::size_t>(str);
+  return result ? std::make_optional(*result * multiplier) : std::nullopt;
+}
+
+/**
+ * @returns The CPU list like "0-3,8,10-11" as the vector of CPU numbers, or
+ * `std::nullopt` on failure.
+ */
+inline std::optional<std::vector<unsigned>> to_cpu_list(std::string_view str)
+{
+  std::vector<unsigned> result;
+  while (!str.empty()) {
+    const auto comma = str.find(',');
+    const auto range = str.substr(0, comma);
+    const auto dash = range.find('-');
+    const auto first = to_unsigned(range.substr(0, dash));
+    const auto last = dash == std::string_view::npos ? first :
+      to_unsigned(range.substr(dash + 1));
+    if (!first || !last || *first > *last)
+      return std::nullopt;
+    for (auto cpu = *first; cpu <= *last; ++cpu)
+      result.push_back(cpu);
+    str.remove_prefix(comma == std::string_view::npos ? str.size() : comma + 1);
+  }
+  return result;
+}
+
+#ifdef __linux__
+/// The root directory of the CPUs in sysfs.
+constexpr const char* sysfs_cpu_root{"/sys/devices/system/cpu/"};
+
+/**
+ * @returns The value of the sysfs attribute at `path` without the trailing
+ * whitespace, or `std::nullopt` if the attribute cannot be read.
+ */
+inline std::optional<std::string> read_sysfs(const std::string& path)
+{
+  const posix::Fd_guard fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd.fd() == -1)
+    return std::nullopt;
+
+  // The sysfs attribute can't be larger than the page.
+  std::array<char, 4096> buf;
+  const auto size = posix::pread_full(fd, buf.data(), buf.size());
+  if (size < 0)
+    return std::nullopt;
+  std::string_view result{buf.data(), static_cast<std::size_t>(size)};
+  while (!result.empty() && (result.back() == '\n' || result.back() == ' '))
+    result.remove_suffix(1);
+  return std::string{result};
+}
+
+/// @returns The unsigned integer attribute of sysfs at `path`.
+inline std::optional<unsigned> read_sysfs_unsigned(const std::string& path)
+{
+  const auto value = read_sysfs(path);
+  return value ? to_unsigned(*value) : std::nullopt;
+}
+#endif  // __linux__
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Cpu_cache
+// -----------------------------------------------------------------------------
+
+/// A CPU cache.
+struct Cpu_cache final {
+  /// A cache type.
+  enum class Type {
+    unified,
+    data,
+    instruction
+  };
+
+  /// The level starting from `1`.
+  unsigned level{};
+  /// The type.
+  Type type{Type::unified};
+  /// The size in bytes.
+  std::size_t size{};
+  /// The line size in bytes, or `0` if unknown.
+  std::size_t line_size{};
+  /// The number of ways, or `0` if the cache is fully associative or unknown.
+  unsigned associativity{};
+  /// The logical CPUs which share the cache, or empty if unknown.
+  std::vector<unsigned> shared_cpus;
+#if defined(_WIN32) || defined(__linux__)
+  /// The matching cache structure of the SMBIOS table if any.
+  std::optional<firmware::Smbios_view::Cache_info> firmware_info;
+#endif
+};
+
+namespace detail {
+
+/**
+ * @returns The caches of the logical `cpu` reported by the system in no
+ * particular order.
+ */
+inline std::vector<Cpu_cache> system_cpu_caches(const unsigned cpu)
+{
+  std::vector<Cpu_cache> result;
+#ifdef __linux__
+  const auto cpu_root = detail::sysfs_cpu_root + ("cpu" + std::to_string(cpu));
+  for (unsigned i{};; ++i) {
+    const auto root = cpu_root + "/cache/index" + std::to_string(i) + "/";
+    const auto level = detail::read_sysfs_unsigned(root + "level");
+    if (!level)
+      break;
+    Cpu_cache cache;
+    cache.level = *level;
+    if (const auto type = detail::read_sysfs(root + "type")) {
+      if (*type == "Data")
+        cache.type = Cpu_cache::Type::data;
+      else if (*type == "Instruction")
+        cache.type = Cpu_cache::Type::instruction;
+    }
+    if (const auto size = detail::read_sysfs(root + "size"))
+      cache.size = detail::to_size(*size).value_or(0);
+    cache.line_size = detail::read_sysfs_unsigned(root +
+      "coherency_line_size").value_or(0);
+    cache.associativity = detail::read_sysfs_unsigned(root +
+      "ways_of_associativity").value_or(0);
+    if (const auto list = detail::read_sysfs(root + "shared_cpu_list"))
+      cache.shared_cpus = detail::to_cpu_list(*list).value_or(
+        std::vector<unsigned>{});
+    result.push_back(std::move(cache));
+  }
+#else
+  (void)cpu;
+#endif
+  return result;
+}
+
+/// Sorts the `caches` by level and type.
+inline void sort_cpu_caches(std::vector<Cpu_cache>& caches)
+{
+  std::sort(caches.begin(), caches.end(), [](const auto& lhs, const auto& rhs)
+  {
+    return std::tie(lhs.level, lhs.type) < std::tie(rhs.level, rhs.type);
+  });
+}
+
+#if defined(_WIN32) || defined(__linux__)
+
+/// @returns The number of ways denoted by SMBIOS cache associativity.
+inline unsigned smbios_cache_associativity(const std::uint8_t value) noexcept
+{
+  constexpr std::array<unsigned, 15> ways{0, 0, 0, 1, 2, 4, 0, 8, 16, 12, 24,
+    32, 48, 64, 20};
+  return value < ways.size() ? ways[value] : 0;
+}
+
+/// @returns `true` if the SMBIOS cache `info` may describe the cache `type`.
+inline bool is_smbios_cache_type(const firmware::Smbios_view::Cache_info& info,
+  const Cpu_cache::Type type) noexcept
+{
+  switch (info.system_cache_type) {
+  case 0x03: return type == Cpu_cache::Type::instruction;
+  case 0x04: return type == Cpu_cache::Type::data;
+  case 0x05: return type == Cpu_cache::Type::unified;
+  // Other or unknown.
+  default: return true;
+  }
+}
+
+/// The position of the physical package among the packages of the system.
+struct Package_position final {
+  /// The index of the package in the order of the package ids.
+  unsigned index{};
+  /// The number of the packages.
+  unsigned count{};
+};
+
+/**
+ * @returns The position of the physical package of the logical `cpu` among
+ * the packages of the online CPUs, or `std::nullopt` if it's unknown.
+ */
+inline std::optional<Package_position> package_position(const unsigned cpu)
+{
+#ifdef __linux__
+  const std::string cpu_root{detail::sysfs_cpu_root};
+  const auto package_of = [&cpu_root](const unsigned value)
+  {
+    return detail::read_sysfs_unsigned(cpu_root + "cpu" +
+      std::to_string(value) + "/topology/physical_package_id");
+  };
+  const auto package = package_of(cpu);
+  const auto online = detail::read_sysfs(cpu_root + "online");
+  const auto ids = online ? detail::to_cpu_list(*online) : std::nullopt;
+  if (!package || !ids)
+    return std::nullopt;
+  std::vector<unsigned> packages;
+  for (const auto id : *ids) {
+    if (const auto value = package_of(id))
+      packages.push_back(*value);
+    else
+      return std::nullopt;
+  }
+  std::sort(packages.begin(), packages.end());
+  packages.erase(std::unique(packages.begin(), packages.end()),
+    packages.end());
+  const auto i = std::lower_bound(packages.cbegin(), packages.cend(), *package);
+  if (i == packages.cend() || *i != *package)
+    return std::nullopt;
+  return Package_position{static_cast<unsigned>(i - packages.cbegin()),
+    static_cast<unsigned>(packages.size())};
+#else
+  (void)cpu;
+  return std::nullopt;
+#endif
+}
+
+/**
+ * @returns The SMBIOS caches referenced by the processor of the package at
+ * `position`, or an empty vector if the processor cannot be determined.
+ *
+ * @details SMBIOS doesn't relate the processor structures to the packages of
+ * the system, so the populated processor structures are assumed to be listed
+ * in the order of the package ids. The processor is selected by the position
+ * only if the number of the populated processors equals the number of the
+ * packages. The single populated processor is selected if the position is
+ * unknown.
+ */
+inline std::vector<firmware::Smbios_view::Cache_info>
+smbios_caches(const firmware::Smbios_view& smbios,
+  const std::optional<Package_position>& position)
+{
+  std::vector<firmware::Smbios_view::Cache_info> result;
+  auto processors = smbios.processors_info<std::string_view>();
+  processors.erase(std::remove_if(processors.begin(), processors.end(),
+    [](const auto& p){return !(p.status & 0x40);}), processors.end());
+  const auto count = position ? position->count : 1;
+  if (processors.size() != count)
+    return result;
+  const auto& processor = processors[position ? position->index : 0];
+  for (const auto handle : {processor.l1_cache_handle,
+      processor.l2_cache_handle, processor.l3_cache_handle}) {
+    // Handle 0xFFFF denotes that the cache is not provided.
+    if (handle != 0xFFFF) {
+      if (auto info = smbios.cache_info(handle))
+        result.push_back(std::move(*info));
+    }
+  }
+  return result;
+}
+
+/**
+ * @returns The SMBIOS table of the system, or `nullptr` if it's not
+ * accessible (for example, to the unprivileged users).
+ *
+ * @details The result of the first call is cached, so the failure to access
+ * the table is paid only once.
+ */
+inline const firmware::Smbios_table* system_smbios_table() noexcept
+{
+  static const firmware::Smbios_table* const result = []() noexcept
+    -> const firmware::Smbios_table*
+  {
+    try {
+      return &firmware::Smbios_table::system();
+    } catch (...) {
+      return nullptr;
+    }
+  }();
+  return result;
+}
+#endif
+
+} // namespace detail
+
+#if defined(_WIN32) || defined(__linux__)
+/**
+ * @returns The caches of the logical `cpu` ordered by level and type.
+ *
+ * @param smbios The SMBIOS table to fuse the result with, or `nullptr`. The
+ * processor structure is selected by the physical package of `cpu` (see
+ * `detail::smbios_caches()`), and its cache handles are followed to the cache
+ * structures, which are matched to the caches of the system by level and
+ * type. If the processor cannot be determined, the result is not fused.
+ *
+ * @details On Linux, the caches are described by
+ * `/sys/devices/system/cpu/cpu<N>/cache/index<M>`. If this information is not
+ * available, the result is made from the SMBIOS cache structures only (the
+ * line sizes and the sharing CPUs are unknown in this case).
+ */
+inline std::vector<Cpu_cache> cpu_caches(const unsigned cpu,
+  const firmware::Smbios_view* const smbios)
+{
+  auto result = detail::system_cpu_caches(cpu);
+  if (smbios) {
+    auto infos = detail::smbios_caches(*smbios, detail::package_position(cpu));
+    if (result.empty()) {
+      for (auto& info : infos) {
+        Cpu_cache cache;
+        cache.level = info.level();
+        switch (info.system_cache_type) {
+        case 0x03: cache.type = Cpu_cache::Type::instruction; break;
+        case 0x04: cache.type = Cpu_cache::Type::data; break;
+        }
+        cache.size = static_cast<std::size_t>(info.installed_size_bytes());
+        cache.associativity = detail::smbios_cache_associativity(
+          info.associativity);
+        cache.firmware_info = std::move(info);
+        result.push_back(std::move(cache));
+      }
+    } else {
+      for (auto& cache : result) {
+        const auto i = std::find_if(infos.cbegin(), infos.cend(),
+          [&cache](const auto& info)
+          {
+            return info.level() == cache.level &&
+              detail::is_smbios_cache_type(info, cache.type);
+          });
+        if (i != infos.cend())
+          cache.firmware_info = *i;
+      }
+    }
+  }
+  detail::sort_cpu_caches(result);
+  return result;
+}
+
+/**
+ * @overload
+ *
+ * @details The result is fused with `firmware::Smbios_table::system()` if
+ * the SMBIOS table of the system is available.
+ */
+inline std::vector<Cpu_cache> cpu_caches(const unsigned cpu = 0)
+{
+  // The firmware tables are not always accessible (for example, to the
+  // unprivileged users), so the result is just not fused in this case.
+  if (const auto* const table = detail::system_smbios_table()) {
+    const auto smbios = table->view();
+    return cpu_caches(cpu, &smbios);
+  }
+  return cpu_caches(cpu, nullptr);
+}
+#else
+/// @returns The caches of the logical `cpu` ordered by level and type.
+inline std::vector<Cpu_cache> cpu_caches(const unsigned cpu = 0)
+{
+  auto result = detail::system_cpu_caches(cpu);
+  detail::sort_cpu_caches(result);
+  return result;
+}
+#endif
+
+/**
+ * @returns The data (or unified) cache of the given `level` of the logical
+ * `cpu`, or `std::nullopt` if there is no such a cache.
+ */
+inline std::optional<Cpu_cache> cpu_cache(const unsigned level,
+  const unsigned cpu = 0)
+{
+  auto caches = cpu_caches(cpu);
+  for (auto& cache : caches) {
+    if (cache.level == level && cache.type != Cpu_cache::Type::instruction)
+      return std::move(cache);
+  }
+  return std::nullopt;
+}
+
+/**
+ * @returns The last level cache of the logical `cpu`, or `std::nullopt` if
+ * the caches are unknown.
+ */
+inline std::optional<Cpu_cache> last_level_cache(const unsigned cpu = 0)
+{
+  auto caches = cpu_caches(cpu);
+  for (auto i = caches.rbegin(); i != caches.rend(); ++i) {
+    if (i->type != Cpu_cache::Type::instruction)
+      return std::move(*i);
+  }
+  return std::nullopt;
+}
+
+
+// -----------------------------------------------------------------------------
+// Cpu_topology
+// -----------------------------------------------------------------------------
+
+class Cpu_topology;
+
+namespace detail {
+
+/// The raw description of the logical CPU.
+struct Raw_cpu final {
+  /// The logical CPU number.
+  unsigned id{};
+  /// The package identifier.
+  unsigned package{};
+  /// The core identifier within the package (or die, or cluster).
+  unsigned core{};
+  /// The least number of the SMT siblings of the CPU (including itself).
+  unsigned first_sibling{};
+  /// The NUMA node identifier.
+  unsigned node{};
+};
+
+/// The raw description of the online NUMA node.
+struct Raw_node final {
+  /// The node identifier.
+  unsigned id{};
+  /// The distances to the online nodes in the order of their identifiers.
+  std::vector<unsigned> distances;
+};
+
+/**
+ * @returns The topology of the `cpus` and the `nodes`.
+ *
+ * @details Used by `Cpu_topology::from_system()`, and by the tests to check
+ * the synthetic topologies.
+ */
+inline Cpu_topology make_cpu_topology(std::vector<Raw_cpu> cpus,
+  const std::vector<Raw_node>& nodes);
+
+} // namespace detail
+
+/**
+ * @brief The topology of the logical CPUs: packages, cores, SMT siblings and
+ * NUMA nodes.
+ *
+ * @details All the data is stored in a few flat arrays. The cores of each
+ * package and the CPUs of each core and of each node are contiguous, so they
+ * are accessed as ranges without any indirection.
+ */
+class Cpu_topology final {
+public:
+  /// A contiguous range of the topology elements.
+  template<typename T>
+  class Range final {
+  public:
+    /// Constructs an empty range.
+    Range() noexcept = default;
+
+    /// Constructs the range of `size` elements starting from `data`.
+    Range(const T* const data, const std::size_t size) noexcept
+      : begin_{data}
+      , end_{data + size}
+    {}
+
+    const T* begin() const noexcept { return begin_; }
+    const T* end() const noexcept { return end_; }
+    std::size_t size() const noexcept { return end_ - begin_; }
+    bool empty() const noexcept { return begin_ == end_; }
+
+    const T& operator[](const std::size_t index) const noexcept
+    {
+      DMITIGR_ASSERT(index < size());
+      return begin_[index];
+    }
+
+  private:
+    const T* begin_{};
+    const T* end_{};
+  };
+
+  /// A logical CPU.
+  struct Cpu final {
+    /// The logical CPU number.
+    unsigned id{};
+    /// The index of the core in `cores()`.
+    unsigned core{};
+    /// The index of the package in `packages()`.
+    unsigned package{};
+    /// The index of the NUMA node in `nodes()`.
+    unsigned node{};
+  };
+
+  /// A physical core.
+  struct Core final {
+    /// The core identifier reported by the system (unique per die or cluster).
+    unsigned id{};
+    /// The index of the package in `packages()`.
+    unsigned package{};
+    /// The position of the first CPU of the core in the CPU array.
+    unsigned cpus_offset{};
+    /// The number of the SMT siblings (logical CPUs) of the core.
+    unsigned cpu_count{};
+  };
+
+  /// A physical package (socket).
+  struct Package final {
+    /// The package identifier as reported by the system.
+    unsigned id{};
+    /// The index of the first core of the package in `cores()`.
+    unsigned cores_offset{};
+    /// The number of cores of the package.
+    unsigned core_count{};
+    /// The number of logical CPUs of the package.
+    unsigned cpu_count{};
+  };
+
+  /// A NUMA node.
+  struct Node final {
+    /// The node identifier as reported by the system.
+    unsigned id{};
+    /// The position of the first CPU of the node in the CPU array.
+    unsigned cpus_offset{};
+    /// The number of logical CPUs of the node.
+    unsigned cpu_count{};
+  };
+
+  /// A discrepancy between the topology and the SMBIOS table.
+  struct Mismatch final {
+    /// The mismatch code.
+    enum class Code {
+      /// The number of packages differs from the number of populated sockets.
+      package_count = 1,
+      /// The number of cores of the package differs from the firmware one.
+      core_count,
+      /// The number of CPUs of the package differs from the firmware one.
+      thread_count
+    };
+
+    /// The mismatch code.
+    Code code{};
+    /// The index of the package, or `0` for `Code::package_count`.
+    unsigned package{};
+    /// The value reported by the firmware.
+    unsigned firmware_value{};
+    /// The value reported by the system.
+    unsigned system_value{};
+  };
+
+  /// Constructs an empty topology.
+  Cpu_topology() = default;
+
+  /**
+   * @returns The topology of the online CPUs of the system.
+   *
+   * @details On Linux, the topology is read from `/sys/devices/system/cpu`
+   * and `/sys/devices/system/node`. If the latter is not available, all the
+   * CPUs belong to the node `0`. On other systems, each of
+   * `std::thread::hardware_concurrency()` CPUs is considered as a core of the
+   * single package of the single node.
+   *
+   * @throws `std::runtime_error` if the topology cannot be determined.
+   *
+   * @see `cpu_topology()`.
+   */
+  static Cpu_topology from_system()
+  {
+    std::vector<detail::Raw_cpu> raw;
+    std::vector<detail::Raw_node> raw_nodes;
+#ifdef __linux__
+    const std::string cpu_root{detail::sysfs_cpu_root};
+    const auto online = detail::read_sysfs(cpu_root + "online");
+    const auto ids = online ? detail::to_cpu_list(*online) : std::nullopt;
+    if (!ids || ids->empty())
+      throw std::runtime_error{"cannot get the online CPUs"};
+    for (const auto id : *ids) {
+      const auto topology = cpu_root + "cpu" + std::to_string(id) +
+        "/topology/";
+      // The package may be reported as -1 on some architectures.
+      const auto package = detail::read_sysfs_unsigned(topology +
+        "physical_package_id").value_or(0);
+      const auto core = detail::read_sysfs_unsigned(topology +
+        "core_id").value_or(id);
+      /*
+       * The core id is unique only within the die or cluster, so the cores
+       * are identified by their SMT siblings. (core_cpus_list is the newer
+       * name of thread_siblings_list.)
+       */
+      auto siblings = detail::read_sysfs(topology + "core_cpus_list");
+      if (!siblings)
+        siblings = detail::read_sysfs(topology + "thread_siblings_list");
+      const auto list = siblings ? detail::to_cpu_list(*siblings) :
+        std::nullopt;
+      const auto first_sibling = list && !list->empty() ?
+        *std::min_element(list->cbegin(), list->cend()) : id;
+      raw.push_back({id, package, core, first_sibling, 0});
+    }
+
+    const std::string node_root{"/sys/devices/system/node/"};
+    if (const auto nodes = detail::read_sysfs(node_root + "online")) {
+      for (const auto node : detail::to_cpu_list(*nodes).value_or(
+          std::vector<unsigned>{})) {
+        const auto root = node_root + "node" + std::to_string(node) + "/";
+        if (const auto list = detail::read_sysfs(root + "cpulist")) {
+          for (const auto cpu : detail::to_cpu_list(*list).value_or(
+              std::vector<unsigned>{})) {
+            for (auto& r : raw) {
+              if (r.id == cpu)
+                r.node = node;
+            }
+          }
+        }
+        auto& [id, distances] = raw_nodes.emplace_back();
+        id = node;
+        if (const auto list = detail::read_sysfs(root + "distance")) {
+          std::string_view str{*list};
+          while (!str.empty()) {
+            const auto space = str.find(' ');
+            distances.push_back(detail::to_unsigned(
+              str.substr(0, space)).value_or(0));
+            str.remove_prefix(space == std::string_view::npos ?
+              str.size() : space + 1);
+          }
+        }
+      }
+    }
+#else
+    const unsigned count{std::max(std::thread::hardware_concurrency(), 1u)};
+    for (unsigned id{}; id < count; ++id)
+      raw.push_back({id, 0, id, id, 0});
+#endif
+    return detail::make_cpu_topology(std::move(raw), raw_nodes);
+  }
+
+  /// @returns The logical CPUs ordered by their numbers.
+  const std::vector<Cpu>& cpus() const noexcept
+  {
+    return cpus_;
+  }
+
+  /// @returns The cores ordered by packages.
+  const std::vector<Core>& cores() const noexcept
+  {
+    return cores_;
+  }
+
+  /// @returns The packages.
+  const std::vector<Package>& packages() const noexcept
+  {
+    return packages_;
+  }
+
+  /// @returns The NUMA nodes.
+  const std::vector<Node>& nodes() const noexcept
+  {
+    return nodes_;
+  }
+
+  /// @returns The logical CPU of number `id`, or `nullptr` if no such a CPU.
+  const Cpu* cpu(const unsigned id) const noexcept
+  {
+    const auto i = std::lower_bound(cpus_.cbegin(), cpus_.cend(), id,
+      [](const Cpu& cpu, const unsigned value){return cpu.id < value;});
+    return i != cpus_.cend() && i->id == id ? &*i : nullptr;
+  }
+
+  /// @returns The numbers of the SMT siblings of the `core`.
+  Range<unsigned> cpus(const Core& core) const noexcept
+  {
+    return {core_cpus_.data() + core.cpus_offset, core.cpu_count};
+  }
+
+  /// @returns The numbers of the logical CPUs of the `node`.
+  Range<unsigned> cpus(const Node& node) const noexcept
+  {
+    return {node_cpus_.data() + node.cpus_offset, node.cpu_count};
+  }
+
+  /// @returns The cores of the `package`.
+  Range<Core> cores(const Package& package) const noexcept
+  {
+    return {cores_.data() + package.cores_offset, package.core_count};
+  }
+
+  /**
+   * @returns The distance between the nodes of indexes `from` and `to`, as
+   * reported by the system (`10` denotes the local access).
+   *
+   * @par Requires
+   * `(from < nodes().size() && to < nodes().size())`.
+   */
+  unsigned distance(const unsigned from, const unsigned to) const noexcept
+  {
+    DMITIGR_ASSERT(from < nodes_.size() && to < nodes_.size());
+    return distances_[from * nodes_.size() + to];
+  }
+
+#if defined(_WIN32) || defined(__linux__)
+  /**
+   * @returns The discrepancies between this topology and the processors
+   * information of the `smbios` table.
+   *
+   * @details Only the populated sockets are considered. The system may
+   * legitimately report less CPUs than the firmware (for example, if some
+   * of them are offline or disabled by the kernel command line), so the
+   * result is informational.
+   */
+  std::vector<Mismatch> mismatches(const firmware::Smbios_view& smbios) const
+  {
+    using Code = Mismatch::Code;
+    std::vector<Mismatch> result;
+    auto processors = smbios.processors_info<std::string_view>();
+    processors.erase(std::remove_if(processors.begin(), processors.end(),
+      [](const auto& p){return !(p.status & 0x40);}), processors.end());
+    if (processors.size() != packages_.size())
+      result.push_back(Mismatch{Code::package_count, 0,
+        static_cast<unsigned>(processors.size()),
+        static_cast<unsigned>(packages_.size())});
+
+    const auto count = [](const unsigned value, const unsigned value_2)
+    {
+      // The value 0xFF denotes that the value of the *_2 field must be used.
+      return value == 0xFF ? value_2 : value;
+    };
+    const auto size = std::min(processors.size(), packages_.size());
+    for (std::size_t i{}; i < size; ++i) {
+      const auto& p = processors[i];
+      const auto& package = packages_[i];
+      const auto index = static_cast<unsigned>(i);
+      auto cores = count(p.core_enabled, p.core_enabled_2);
+      if (!cores)
+        cores = count(p.core_count, p.core_count_2);
+      if (cores && cores != package.core_count)
+        result.push_back(Mismatch{Code::core_count, index, cores,
+          package.core_count});
+      auto threads = unsigned{p.thread_enabled};
+      if (!threads)
+        threads = count(p.thread_count, p.thread_count_2);
+      if (threads && threads != package.cpu_count)
+        result.push_back(Mismatch{Code::thread_count, index, threads,
+          package.cpu_count});
+    }
+    return result;
+  }
+#endif
+
+private:
+  friend Cpu_topology detail::make_cpu_topology(std::vector<detail::Raw_cpu>,
+    const std::vector<detail::Raw_node>&);
+
+  std::vector<Cpu> cpus_;
+  std::vector<Core> cores_;
+  std::vector<Package> packages_;
+  std::vector<Node> nodes_;
+  std::vector<unsigned> core_cpus_;
+  std::vector<unsigned> node_cpus_;
+  std::vector<unsigned> distances_;
+
+  Cpu_topology(std::vector<detail::Raw_cpu> raw,
+    const std::vector<detail::Raw_node>& raw_nodes)
+  {
+    // Group the CPUs by packages and cores (identified by the first sibling).
+    std::sort(raw.begin(), raw.end(), [](const auto& lhs, const auto& rhs)
+    {
+      return std::tie(lhs.package, lhs.first_sibling, lhs.id) <
+        std::tie(rhs.package, rhs.first_sibling, rhs.id);
+    });
+    cpus_.reserve(raw.size());
+    core_cpus_.reserve(raw.size());
+    unsigned core_sibling{};
+    for (const auto& [id, package_id, core_id, first_sibling, node_id] : raw) {
+      if (packages_.empty() || packages_.back().id != package_id) {
+        packages_.push_back(Package{package_id,
+          static_cast<unsigned>(cores_.size()), 0, 0});
+      }
+      auto& package = packages_.back();
+      if (!package.core_count || core_sibling != first_sibling) {
+        core_sibling = first_sibling;
+        cores_.push_back(Core{core_id,
+          static_cast<unsigned>(packages_.size() - 1),
+          static_cast<unsigned>(core_cpus_.size()), 0});
+        ++package.core_count;
+      }
+      ++cores_.back().cpu_count;
+      ++package.cpu_count;
+      core_cpus_.push_back(id);
+      cpus_.push_back(Cpu{id, static_cast<unsigned>(cores_.size() - 1),
+        static_cast<unsigned>(packages_.size() - 1), node_id});
+    }
+    std::sort(cpus_.begin(), cpus_.end(), [](const auto& lhs, const auto& rhs)
+    {
+      return lhs.id < rhs.id;
+    });
+
+    // Group the CPUs by nodes. (Cpu::node is the node id at this point.)
+    std::vector<unsigned> node_ids;
+    for (const auto& [id, distances] : raw_nodes)
+      node_ids.push_back(id);
+    for (const auto& cpu : cpus_)
+      node_ids.push_back(cpu.node);
+    std::sort(node_ids.begin(), node_ids.end());
+    node_ids.erase(std::unique(node_ids.begin(), node_ids.end()),
+      node_ids.end());
+    node_cpus_.reserve(cpus_.size());
+    for (const auto node_id : node_ids) {
+      const auto index = static_cast<unsigned>(nodes_.size());
+      auto& node = nodes_.emplace_back(Node{node_id,
+        static_cast<unsigned>(node_cpus_.size()), 0});
+      for (auto& cpu : cpus_) {
+        if (cpu.node == node_id) {
+          node_cpus_.push_back(cpu.id);
+          ++node.cpu_count;
+        }
+      }
+      for (auto& cpu : cpus_) {
+        if (cpu.node == node_id)
+          cpu.node = index;
+      }
+    }
+
+    // Fill the distance matrix. (The local distance is 10, the remote is 20
+    // if unknown.)
+    const auto node_count = nodes_.size();
+    distances_.resize(node_count * node_count);
+    for (std::size_t i{}; i < node_count; ++i) {
+      for (std::size_t j{}; j < node_count; ++j)
+        distances_[i * node_count + j] = i == j ? 10 : 20;
+    }
+    const auto index_of = [&node_ids](const unsigned id)
+    {
+      return static_cast<std::size_t>(std::lower_bound(node_ids.cbegin(),
+          node_ids.cend(), id) - node_ids.cbegin());
+    };
+    for (const auto& [id, distances] : raw_nodes) {
+      const auto i = index_of(id);
+      // The distances are reported for the online nodes (which are exactly
+      // the nodes of raw_nodes) in order, rather than by their ids, since
+      // the ids of the online nodes may be sparse.
+      const auto size = std::min(distances.size(), raw_nodes.size());
+      for (std::size_t k{}; k < size; ++k) {
+        if (distances[k])
+          distances_[i * node_count + index_of(raw_nodes[k].id)] =
+            distances[k];
+      }
+    }
+  }
+};
+
+namespace detail {
+
+inline Cpu_topology make_cpu_topology(std::vector<Raw_cpu> cpus,
+  const std::vector<Raw_node>& nodes)
+{
+  return Cpu_topology{std::move(cpus), nodes};
+}
+
+} // namespace detail
+
+/**
+ * @returns The process-wide snapshot of the topology of the system.
+ *
+ * @details The snapshot is created by `Cpu_topology::from_system()` on the
+ * first call (in a thread-safe manner) and is never changed after that. If
+ * the first call throws, the next one retries.
+ */
+inline const Cpu_topology& cpu_topology()
+{
+  static const Cpu_topology result{Cpu_topology::from_system()};
+  return result;
+}
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_CPU_HPP
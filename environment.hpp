@@ -19,11 +19,27 @@
 
 #include "exceptions.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <memory>
+#include <shared_mutex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 
@@ -42,15 +58,83 @@
 #include <unistd.h>
 #include <sys/types.h>
 
+extern char** environ;
+
 #endif
 
 namespace dmitigr::os {
 
+#ifndef _WIN32
+/**
+ * @returns The name of the user `uid`, or the textual representation of `uid`
+ * if there is no such a user.
+ *
+ * @param buf The buffer to use as the storage of the result.
+ * @param size The size of `buf`.
+ *
+ * @par Requires
+ * `buf && size`.
+ *
+ * @remarks The result is valid as long as `buf`.
+ * @remarks Never allocates unless throws.
+ *
+ * @throws `Sys_exception` with `ERANGE` if `size` is not enough.
+ */
+inline std::string_view username(const uid_t uid,
+  char* const buf, const std::size_t size)
+{
+  if (!buf || !size)
+    throw std::invalid_argument{"cannot get username: invalid buffer"};
+
+  struct passwd pwd;
+  struct passwd *pwd_ptr{};
+  if (const int s = getpwuid_r(uid, &pwd, buf, size, &pwd_ptr); !pwd_ptr) {
+    if (s)
+      throw Sys_exception{s, "cannot get username of user "
+        +std::to_string(uid)};
+    const auto [end, ec] = std::to_chars(buf, buf + size, uid);
+    if (ec != std::errc{})
+      throw Sys_exception{ERANGE, "cannot get username of user "
+        +std::to_string(uid)};
+    return {buf, static_cast<std::size_t>(end - buf)};
+  } else
+    return pwd.pw_name;
+}
+
+/// @returns The name of the user `uid`.
+inline std::string username(const uid_t uid)
+{
+  std::size_t bufsz{1024};
+  while (true) {
+    const std::unique_ptr<char[]> buf{new char[bufsz]};
+    try {
+      return std::string{username(uid, buf.get(), bufsz)};
+    } catch (const Sys_exception& e) {
+      if (e.condition() != std::errc::result_out_of_range || bufsz >= 1048576)
+        throw;
+    }
+    bufsz *= 2;
+  }
+}
+
+/**
+ * @returns The current username of the running process.
+ *
+ * @par Effects
+ * Same as for `username(geteuid(), buf, size)`.
+ */
+inline std::string_view current_username(char* const buf,
+  const std::size_t size)
+{
+  return username(geteuid(), buf, size);
+}
+#endif
+
 /// @returns The current username of the running process.
 inline std::string current_username()
 {
-  std::string result;
 #ifdef _WIN32
+  std::string result;
   constexpr DWORD max_size = UNLEN + 1;
   result.resize(max_size);
   DWORD sz{max_size};
@@ -58,27 +142,139 @@ inline std::string current_username()
     result.resize(sz - 1);
   else
     throw Sys_exception{"cannot get current username of the running process"};
+  return result;
 #else
-  struct passwd pwd;
-  struct passwd *pwd_ptr{};
-  const uid_t uid = geteuid();
-  const std::size_t bufsz = []()
+  return username(geteuid());
+#endif
+}
+
+/**
+ * @returns The current username of the running process.
+ *
+ * @details The result is memoized per thread and, on Unix, is keyed by the
+ * effective user ID, so changes made by `seteuid()` are detected whereas
+ * changes of the user database are not.
+ *
+ * @remarks The result is valid until the next call of this function by the
+ * same thread.
+ */
+inline const std::string& current_username_cached()
+{
+#ifdef _WIN32
+  thread_local const std::string result{current_username()};
+  return result;
+#else
+  thread_local std::optional<std::pair<uid_t, std::string>> result;
+  if (const uid_t uid = geteuid(); !result || result->first != uid)
+    result.emplace(uid, username(uid));
+  return result->second;
+#endif
+}
+
+#ifndef _WIN32
+/**
+ * @brief Resolver of user IDs to usernames with a bounded LRU cache.
+ *
+ * @remarks Not thread-safe.
+ */
+class Username_resolver final {
+public:
+  /// The constructor.
+  explicit Username_resolver(const std::size_t capacity = 1024)
+    : capacity_{capacity}
+  {
+    if (!capacity_)
+      throw std::invalid_argument{"cannot create username resolver:"
+        " zero capacity"};
+    buffer_.resize(1024);
+  }
+
+  /// @returns The maximum number of cached usernames.
+  std::size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  /// @returns The number of cached usernames.
+  std::size_t size() const noexcept
+  {
+    return entries_.size();
+  }
+
+  /// Removes all the cached usernames.
+  void clear() noexcept
   {
-    auto result = sysconf(_SC_GETPW_R_SIZE_MAX);
-    if (result == -1)
-      result = 16384;
+    index_.clear();
+    entries_.clear();
+  }
+
+  /**
+   * @returns The name of the user `uid`.
+   *
+   * @remarks The result is valid until the next call of a non-const method.
+   */
+  std::string_view name(const uid_t uid)
+  {
+    if (const auto i = index_.find(uid); i != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, i->second);
+      return i->second->second;
+    }
+
+    std::string name = resolve(uid);
+    if (entries_.size() == capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.splice(entries_.begin(), entries_, std::prev(entries_.end()));
+      entries_.front() = {uid, std::move(name)}; // reuse the evicted node
+    } else
+      entries_.emplace_front(uid, std::move(name));
+    index_.emplace(uid, entries_.begin());
+    return entries_.front().second;
+  }
+
+  /// @returns The names of the users `uids`.
+  std::vector<std::string> names(const std::vector<uid_t>& uids)
+  {
+    std::vector<std::string> result;
+    result.reserve(uids.size());
+    for (const auto uid : uids)
+      result.emplace_back(name(uid));
     return result;
-  }();
-  const std::unique_ptr<char[]> buf{new char[bufsz]};
-  const int s = getpwuid_r(uid, &pwd, buf.get(), bufsz, &pwd_ptr);
-  if (!pwd_ptr) {
-    if (s)
-      throw Sys_exception{s, "cannot get current username of the running process"};
-    else
-      result = std::to_string(uid);
-  } else
-    result = pwd.pw_name;
+  }
+
+private:
+  using Entry = std::pair<uid_t, std::string>;
+  std::size_t capacity_{};
+  std::list<Entry> entries_;
+  std::unordered_map<uid_t, std::list<Entry>::iterator> index_;
+  std::vector<char> buffer_;
+
+  std::string resolve(const uid_t uid)
+  {
+    while (true) {
+      try {
+        return std::string{username(uid, buffer_.data(), buffer_.size())};
+      } catch (const Sys_exception& e) {
+        if (e.condition() != std::errc::result_out_of_range ||
+          buffer_.size() >= 1048576)
+          throw;
+      }
+      buffer_.resize(buffer_.size() * 2);
+    }
+  }
+};
 #endif
+
+/**
+ * @returns The mutex which guards the environment of the running process.
+ *
+ * @details The functions of this library which read the environment acquire
+ * it in shared mode, and the functions which modify the environment acquire
+ * it in exclusive mode. Code which calls `setenv()`, `putenv()` etc directly
+ * should acquire it in exclusive mode too.
+ */
+inline std::shared_mutex& environment_mutex() noexcept
+{
+  static std::shared_mutex result;
   return result;
 }
 
@@ -91,6 +287,7 @@ inline std::string current_username()
  */
 inline std::optional<std::string> environment_variable(const std::string& name)
 {
+  const std::shared_lock lock{environment_mutex()};
 #if defined(_WIN32) && defined(_MSC_VER)
   const std::unique_ptr<char, void(*)(void*)> buffer{nullptr, &std::free};
   char* result = buffer.get();
@@ -102,6 +299,607 @@ inline std::optional<std::string> environment_variable(const std::string& name)
   return result ? std::make_optional(std::string{result}) : std::nullopt;
 }
 
+namespace detail {
+
+/// @throws `std::invalid_argument` if `name` is not a valid variable name.
+inline void check_environment_variable_name(const std::string_view name)
+{
+  if (name.empty() || name.find_first_of(std::string_view{"=\0", 2})
+    != std::string_view::npos)
+    throw std::invalid_argument{"invalid environment variable name"};
+}
+
+/// @throws `std::invalid_argument` if `value` is not a valid variable value.
+inline void check_environment_variable_value(const std::string_view value)
+{
+  if (value.find('\0') != std::string_view::npos)
+    throw std::invalid_argument{"invalid environment variable value"};
+}
+
+} // namespace detail
+
+/**
+ * @brief Sets the environment variable `name` to `value`.
+ *
+ * @par Thread safety
+ * Acquires `environment_mutex()` in exclusive mode.
+ */
+inline void set_environment_variable(const std::string& name,
+  const std::string& value)
+{
+  detail::check_environment_variable_name(name);
+  detail::check_environment_variable_value(value);
+  const std::unique_lock lock{environment_mutex()};
+#ifdef _WIN32
+  if (const auto err = ::_putenv_s(name.c_str(), value.c_str()))
+    throw Sys_exception{err, "cannot set the environment variable \""+name+"\""};
+#else
+  if (::setenv(name.c_str(), value.c_str(), 1))
+    throw Sys_exception{"cannot set the environment variable \""+name+"\""};
+#endif
+}
+
+/**
+ * @brief Removes the environment variable `name`.
+ *
+ * @par Thread safety
+ * Acquires `environment_mutex()` in exclusive mode.
+ */
+inline void unset_environment_variable(const std::string& name)
+{
+  detail::check_environment_variable_name(name);
+  const std::unique_lock lock{environment_mutex()};
+#ifdef _WIN32
+  if (const auto err = ::_putenv_s(name.c_str(), ""))
+    throw Sys_exception{err, "cannot unset the environment variable \""+name+"\""};
+#else
+  if (::unsetenv(name.c_str()))
+    throw Sys_exception{"cannot unset the environment variable \""+name+"\""};
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Environment_snapshot
+// -----------------------------------------------------------------------------
+
+namespace detail {
+
+/// @returns `true` if `a` and `b` are equal ignoring the case of ASCII letters.
+inline bool iequals(const std::string_view a, const std::string_view b) noexcept
+{
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+    [](const char c1, const char c2) noexcept
+    {
+      const auto lower = [](const char c) noexcept
+      {
+        return 'A' <= c && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+      };
+      return lower(c1) == lower(c2);
+    });
+}
+
+/// @returns The integer `str`, or `std::nullopt` on failure.
+template<typename T>
+std::optional<T> to_integer(std::string_view str) noexcept
+{
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  if (!str.empty() && str.front() == '+')
+    str.remove_prefix(1);
+  int base{10};
+  if (str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+    str.remove_prefix(2);
+    base = 16;
+  }
+  T result{};
+  const auto* const end = str.data() + str.size();
+  const auto [ptr, ec] = std::from_chars(str.data(), end, result, base);
+  return !str.empty() && ec == std::errc{} && ptr == end ?
+    std::make_optional(result) : std::nullopt;
+}
+
+/**
+ * @returns The boolean `str` (one of "1", "true", "yes", "on", "0", "false",
+ * "no", "off" in any case), or `std::nullopt` on failure.
+ */
+inline std::optional<bool> to_bool(const std::string_view str) noexcept
+{
+  for (const auto s : {"1", "true", "yes", "on"})
+    if (iequals(str, s))
+      return true;
+  for (const auto s : {"0", "false", "no", "off"})
+    if (iequals(str, s))
+      return false;
+  return std::nullopt;
+}
+
+/**
+ * @returns The number with an optional unit suffix multiplied by the
+ * multiplier of the suffix, or `std::nullopt` on failure.
+ */
+template<std::size_t N>
+std::optional<std::uint64_t> to_scaled(std::string_view str,
+  const std::pair<std::string_view, std::uint64_t> (&units)[N],
+  const std::uint64_t default_multiplier) noexcept
+{
+  while (!str.empty() && str.back() == ' ')
+    str.remove_suffix(1);
+  const auto pos = std::find_if(str.begin(), str.end(), [](const char c)
+  {
+    return !('0' <= c && c <= '9');
+  }) - str.begin();
+  const auto suffix = str.substr(pos);
+  std::uint64_t multiplier{suffix.empty() ? default_multiplier : 0};
+  for (const auto& [unit, value] : units) {
+    if (iequals(suffix, unit)) {
+      multiplier = value;
+      break;
+    }
+  }
+  const auto number = str.substr(0, pos);
+  std::uint64_t result{};
+  const auto* const end = number.data() + number.size();
+  if (const auto [ptr, ec] = std::from_chars(number.data(), end, result);
+    !multiplier || number.empty() || ec != std::errc{} || ptr != end ||
+    result > UINT64_MAX / multiplier)
+    return std::nullopt;
+  return result * multiplier;
+}
+
+/**
+ * @returns The duration like "250ms" or "30s", or `std::nullopt` on failure.
+ *
+ * @details The supported suffixes are "ns", "us", "ms", "s", "m", "min", "h"
+ * and "d". The number without a suffix denotes seconds.
+ */
+inline std::optional<std::chrono::nanoseconds>
+to_duration(const std::string_view str) noexcept
+{
+  static const std::pair<std::string_view, std::uint64_t> units[] = {
+    {"ns", 1}, {"us", 1'000}, {"ms", 1'000'000}, {"s", 1'000'000'000},
+    {"m", 60'000'000'000}, {"min", 60'000'000'000},
+    {"h", 3'600'000'000'000}, {"d", 86'400'000'000'000}};
+  const auto result = to_scaled(str, units, 1'000'000'000);
+  return result && *result <= static_cast<std::uint64_t>(
+    std::chrono::nanoseconds::max().count()) ?
+    std::make_optional(std::chrono::nanoseconds(*result)) : std::nullopt;
+}
+
+/**
+ * @returns The byte size like "64K" or "2GiB", or `std::nullopt` on failure.
+ *
+ * @details The supported suffixes are "B", "K", "KB", "KiB", "M", "MB",
+ * "MiB", "G", "GB", "GiB", "T", "TB" and "TiB" in any case. All of them
+ * are binary, like in `cpu_caches()`.
+ */
+inline std::optional<std::uint64_t> to_byte_size(const std::string_view str) noexcept
+{
+  static const std::pair<std::string_view, std::uint64_t> units[] = {
+    {"b", 1},
+    {"k", 1ULL << 10}, {"kb", 1ULL << 10}, {"kib", 1ULL << 10},
+    {"m", 1ULL << 20}, {"mb", 1ULL << 20}, {"mib", 1ULL << 20},
+    {"g", 1ULL << 30}, {"gb", 1ULL << 30}, {"gib", 1ULL << 30},
+    {"t", 1ULL << 40}, {"tb", 1ULL << 40}, {"tib", 1ULL << 40}};
+  return to_scaled(str, units, 1);
+}
+
+/// Calls `callback(entry)` for each "name=value" entry of the environment.
+template<typename F>
+void for_each_environment_entry(F&& callback)
+{
+#ifdef _WIN32
+  const auto block = ::GetEnvironmentStringsA();
+  if (!block)
+    throw Sys_exception{"cannot get environment strings"};
+  const std::unique_ptr<char, decltype(&::FreeEnvironmentStringsA)> guard{
+    block, &::FreeEnvironmentStringsA};
+  for (const char* e = block; *e; e += std::strlen(e) + 1) {
+    if (*e != '=') // skip hidden entries like "=C:=C:\"
+      callback(std::string_view{e});
+  }
+#else
+  if (environ) {
+    for (char** e = environ; *e; ++e)
+      callback(std::string_view{*e});
+  }
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief An immutable snapshot of the environment of the running process.
+ *
+ * @details The environment is copied into a single arena of "name=value"
+ * strings which are indexed in the order of names, so the lookups neither
+ * scan `environ` nor allocate.
+ *
+ * @remarks Names are compared case-sensitively on all platforms. If the
+ * environment contains several entries with the same name, the first one
+ * wins, like with `std::getenv()`.
+ *
+ * @remarks Const methods are thread-safe.
+ */
+class Environment_snapshot final {
+public:
+  /// Constructs the snapshot of the current environment.
+  Environment_snapshot()
+  {
+    refresh();
+  }
+
+  /**
+   * @brief Replaces the snapshot with the snapshot of the current environment.
+   *
+   * @par Thread safety
+   * Acquires `environment_mutex()` in shared mode while copying.
+   */
+  void refresh()
+  {
+    std::vector<char> arena;
+    std::vector<Entry> entries;
+    std::shared_lock lock{environment_mutex()};
+    detail::for_each_environment_entry([&arena, &entries](const auto entry)
+    {
+      const auto eq = entry.find('=');
+      if (!eq || eq == std::string_view::npos)
+        return;
+      entries.push_back({arena.size(), eq, entry.size() - eq - 1});
+      arena.insert(arena.end(), entry.begin(), entry.end());
+      arena.push_back('\0');
+    });
+    lock.unlock();
+    std::stable_sort(entries.begin(), entries.end(),
+      [&arena](const Entry& lhs, const Entry& rhs) noexcept
+      {
+        return lhs.name(arena.data()) < rhs.name(arena.data());
+      });
+    arena_.swap(arena);
+    entries_.swap(entries);
+  }
+
+  /// @returns The number of variables.
+  std::size_t size() const noexcept
+  {
+    return entries_.size();
+  }
+
+  /// @returns `true` if there are no variables.
+  bool is_empty() const noexcept
+  {
+    return entries_.empty();
+  }
+
+  /// @returns The name of the variable at `index` in the order of names.
+  std::string_view name(const std::size_t index) const
+  {
+    return entry_at(index).name(arena_.data());
+  }
+
+  /**
+   * @returns The value of the variable at `index` in the order of names.
+   *
+   * @remarks The result is null-terminated.
+   */
+  std::string_view value(const std::size_t index) const
+  {
+    return entry_at(index).value(arena_.data());
+  }
+
+  /**
+   * @returns The "name=value" entry of the variable at `index` in the order
+   * of names.
+   *
+   * @remarks The result is null-terminated.
+   */
+  std::string_view entry(const std::size_t index) const
+  {
+    return entry_at(index).entry(arena_.data());
+  }
+
+  /// @returns The index of the variable `name`, or `std::nullopt`.
+  std::optional<std::size_t> find(const std::string_view name) const noexcept
+  {
+    const auto* const data = arena_.data();
+    const auto i = std::lower_bound(entries_.begin(), entries_.end(), name,
+      [data](const Entry& e, const std::string_view n) noexcept
+      {
+        return e.name(data) < n;
+      });
+    return i != entries_.end() && i->name(data) == name ?
+      std::make_optional<std::size_t>(i - entries_.begin()) : std::nullopt;
+  }
+
+  /// @returns `true` if there is the variable `name`.
+  bool contains(const std::string_view name) const noexcept
+  {
+    return static_cast<bool>(find(name));
+  }
+
+  /**
+   * @returns The value of the variable `name`, or `std::nullopt` if there is
+   * no such a variable.
+   *
+   * @remarks The result is null-terminated.
+   */
+  std::optional<std::string_view> value(const std::string_view name) const noexcept
+  {
+    const auto index = find(name);
+    return index ? std::make_optional(value(*index)) : std::nullopt;
+  }
+
+  /**
+   * @returns The integer value of the variable `name`, or `std::nullopt` if
+   * there is no such a variable. Hexadecimal values must be prefixed by "0x".
+   *
+   * @throws `std::runtime_error` if the value is not an integer of type `T`.
+   */
+  template<typename T>
+  std::optional<T> integer(const std::string_view name) const
+  {
+    return parsed(name, &detail::to_integer<T>, "an integer");
+  }
+
+  /**
+   * @returns The boolean value of the variable `name`, or `std::nullopt` if
+   * there is no such a variable.
+   *
+   * @throws `std::runtime_error` if the value is not a boolean.
+   *
+   * @see `detail::to_bool()`.
+   */
+  std::optional<bool> boolean(const std::string_view name) const
+  {
+    return parsed(name, &detail::to_bool, "a boolean");
+  }
+
+  /**
+   * @returns The duration value of the variable `name`, or `std::nullopt` if
+   * there is no such a variable.
+   *
+   * @throws `std::runtime_error` if the value is not a duration.
+   *
+   * @see `detail::to_duration()`.
+   */
+  std::optional<std::chrono::nanoseconds>
+  duration(const std::string_view name) const
+  {
+    return parsed(name, &detail::to_duration, "a duration");
+  }
+
+  /**
+   * @returns The byte size value of the variable `name`, or `std::nullopt` if
+   * there is no such a variable.
+   *
+   * @throws `std::runtime_error` if the value is not a byte size.
+   *
+   * @see `detail::to_byte_size()`.
+   */
+  std::optional<std::uint64_t> byte_size(const std::string_view name) const
+  {
+    return parsed(name, &detail::to_byte_size, "a byte size");
+  }
+
+private:
+  struct Entry final {
+    std::size_t offset{};
+    std::size_t name_size{};
+    std::size_t value_size{};
+
+    std::string_view name(const char* const arena) const noexcept
+    {
+      return {arena + offset, name_size};
+    }
+
+    std::string_view value(const char* const arena) const noexcept
+    {
+      return {arena + offset + name_size + 1, value_size};
+    }
+
+    std::string_view entry(const char* const arena) const noexcept
+    {
+      return {arena + offset, name_size + 1 + value_size};
+    }
+  };
+  std::vector<char> arena_;
+  std::vector<Entry> entries_;
+
+  const Entry& entry_at(const std::size_t index) const
+  {
+    if (!(index < entries_.size()))
+      throw std::out_of_range{"environment variable index out of range"};
+    return entries_[index];
+  }
+
+  template<typename T>
+  std::optional<T> parsed(const std::string_view name,
+    std::optional<T>(*parse)(std::string_view) noexcept,
+    const char* const what) const
+  {
+    if (const auto val = value(name)) {
+      if (const auto result = parse(*val))
+        return result;
+      throw std::runtime_error{std::string{"environment variable "}
+        .append(name).append(" is not ").append(what)};
+    }
+    return std::nullopt;
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Environment_block
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A null-terminated array of "name=value" strings suitable for
+ * `execve()` and `posix_spawn()`.
+ *
+ * @details Both the array and the strings live in a single allocation.
+ */
+class Environment_block final {
+public:
+  /// Constructs the empty block.
+  Environment_block()
+    : storage_{new char*[1]{}}
+  {}
+
+  /// @returns The null-terminated array of "name=value" strings.
+  char* const* envp() const noexcept
+  {
+    return storage_.get();
+  }
+
+  /// @returns The number of variables.
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /// @returns The "name=value" entry at `index`.
+  std::string_view operator[](const std::size_t index) const
+  {
+    if (!(index < size_))
+      throw std::out_of_range{"environment block index out of range"};
+    return storage_[index];
+  }
+
+private:
+  friend class Environment_builder;
+
+  std::unique_ptr<char*[]> storage_;
+  std::size_t size_{};
+
+  Environment_block(std::unique_ptr<char*[]> storage,
+    const std::size_t size) noexcept
+    : storage_{std::move(storage)}
+    , size_{size}
+  {}
+};
+
+// -----------------------------------------------------------------------------
+// Environment_builder
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A builder of the environment of a child process from a base
+ * snapshot plus overrides and removals.
+ *
+ * @remarks The base snapshot must outlive the builder.
+ */
+class Environment_builder final {
+public:
+  /// Constructs the builder of the empty environment.
+  Environment_builder() = default;
+
+  /// Constructs the builder of the environment based on `base`.
+  explicit Environment_builder(const Environment_snapshot& base) noexcept
+    : base_{&base}
+  {}
+
+  /// @returns The base snapshot, or `nullptr`.
+  const Environment_snapshot* base() const noexcept
+  {
+    return base_;
+  }
+
+  /// Sets the base snapshot.
+  Environment_builder& set_base(const Environment_snapshot* const base) noexcept
+  {
+    base_ = base;
+    return *this;
+  }
+
+  /// Sets the variable `name` to `value`.
+  Environment_builder& set(const std::string_view name,
+    const std::string_view value)
+  {
+    detail::check_environment_variable_name(name);
+    detail::check_environment_variable_value(value);
+    overrides_.insert_or_assign(std::string{name}, std::string{value});
+    return *this;
+  }
+
+  /// Removes the variable `name`.
+  Environment_builder& unset(const std::string_view name)
+  {
+    detail::check_environment_variable_name(name);
+    overrides_.insert_or_assign(std::string{name}, std::nullopt);
+    return *this;
+  }
+
+  /// Removes all the overrides and removals.
+  Environment_builder& reset() noexcept
+  {
+    overrides_.clear();
+    return *this;
+  }
+
+  /// @returns The environment block.
+  Environment_block build() const
+  {
+    std::size_t count{};
+    std::size_t bytes{};
+    for_each([&count, &bytes](const auto name, const auto value) noexcept
+    {
+      ++count;
+      bytes += name.size() + 1 + value.size() + 1;
+    });
+
+    // Strings follow the array of pointers.
+    constexpr auto ptr_size = sizeof(char*);
+    std::unique_ptr<char*[]> storage{
+      new char*[count + 1 + (bytes + ptr_size - 1) / ptr_size]};
+    char** ptr = storage.get();
+    char* str = reinterpret_cast<char*>(ptr + count + 1);
+    for_each([&ptr, &str](const auto name, const auto value) noexcept
+    {
+      *ptr++ = str;
+      str = std::copy(name.begin(), name.end(), str);
+      *str++ = '=';
+      str = std::copy(value.begin(), value.end(), str);
+      *str++ = '\0';
+    });
+    *ptr = nullptr;
+    return Environment_block{std::move(storage), count};
+  }
+
+private:
+  const Environment_snapshot* base_{};
+  std::map<std::string, std::optional<std::string>, std::less<>> overrides_;
+
+  /**
+   * Calls `callback(name, value)` for each variable of the resulting
+   * environment in the order of names.
+   */
+  template<typename F>
+  void for_each(F&& callback) const
+  {
+    const std::size_t base_size = base_ ? base_->size() : 0;
+    std::size_t i{};
+    auto o = overrides_.cbegin();
+    std::optional<std::string_view> previous;
+    while (i < base_size || o != overrides_.cend()) {
+      if (i < base_size) {
+        const auto name = base_->name(i);
+        if (previous == name) {
+          ++i; // duplicate
+          continue;
+        } else if (o == overrides_.cend() || name < o->first) {
+          callback(name, base_->value(i));
+          previous = name;
+          ++i;
+          continue;
+        } else if (name == o->first) {
+          previous = name;
+          ++i;
+        }
+      }
+      if (o->second)
+        callback(std::string_view{o->first}, std::string_view{*o->second});
+      ++o;
+    }
+  }
+};
+
 } // namespace dmitigr::os
 
 #endif  // DMITIGR_OS_ENVIRONMENT_HPP
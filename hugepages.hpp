@@ -0,0 +1,363 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/hugepages.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_HUGEPAGES_HPP
+#define DMITIGR_OS_HUGEPAGES_HPP
+
+#include "cpu.hpp"
+#include "exceptions.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace dmitigr::os {
+
+/// A kind of the memory pages.
+enum class Page_kind {
+  /// The normal pages.
+  normal,
+  /// The normal pages advised to be transparently promoted to huge pages.
+  transparent_huge,
+  /// The explicit huge pages of 2 MiB.
+  huge_2m,
+  /// The explicit huge pages of 1 GiB.
+  huge_1g
+};
+
+/// @returns The size of the page of the given `kind`.
+inline std::size_t page_size(const Page_kind kind) noexcept
+{
+  switch (kind) {
+  case Page_kind::huge_1g: return std::size_t{1} << 30;
+  case Page_kind::huge_2m:
+  case Page_kind::transparent_huge: return std::size_t{1} << 21;
+  case Page_kind::normal: break;
+  }
+  return posix::page_size();
+}
+
+// -----------------------------------------------------------------------------
+// Large_buffer
+// -----------------------------------------------------------------------------
+
+/// A very thin wrapper around the memory mapped with the large pages.
+class Large_buffer final {
+public:
+  /// Constructs the empty buffer.
+  Large_buffer() noexcept = default;
+
+  /**
+   * @brief Maps at least `size` bytes with the largest pages available,
+   * starting from the `preferred` kind.
+   *
+   * @details The explicit huge pages of the kind are tried only if `size` is
+   * not less than their size. They are allocated from the pools which are
+   * reserved by the administrator (see `hugepage_pools()`). Then the region
+   * aligned to 2 MiB is advised by `madvise(MADV_HUGEPAGE)` unless the
+   * transparent huge pages are disabled. At last, the normal pages are used.
+   *
+   * @throws `Sys_exception` on failure.
+   *
+   * @see `kind()`.
+   */
+  explicit Large_buffer(const std::size_t size,
+    const Page_kind preferred = Page_kind::huge_1g)
+  {
+    const auto round_up = [size](const std::size_t page)
+    {
+      return (std::max(size, std::size_t{1}) + page - 1) / page * page;
+    };
+
+    // Explicit huge pages.
+    for (const auto& [kind, shift] : {std::pair{Page_kind::huge_1g, 30},
+        std::pair{Page_kind::huge_2m, 21}}) {
+      const auto page = page_size(kind);
+      if (preferred < kind || size < page)
+        continue;
+      const auto length = round_up(page);
+      void* const data = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT),
+        -1, 0);
+      if (data != MAP_FAILED) {
+        mapping_ = posix::Mmap_guard{data, length};
+        kind_ = kind;
+        return;
+      }
+    }
+
+    // Transparent huge pages.
+    if (preferred >= Page_kind::transparent_huge &&
+      transparent_hugepage_mode() != "never") {
+      const auto page = page_size(Page_kind::transparent_huge);
+      const auto length = round_up(page);
+      auto mapping = posix::mmap_anonymous(length + page);
+
+      // Trim the mapping to the huge page boundaries.
+      auto* const begin = static_cast<char*>(mapping.release());
+      auto* const data = begin +
+        (page - reinterpret_cast<std::uintptr_t>(begin) % page) % page;
+      if (data != begin)
+        ::munmap(begin, data - begin);
+      if (const auto tail = page - (data - begin))
+        ::munmap(data + length, tail);
+      mapping_ = posix::Mmap_guard{data, length};
+      if (!::madvise(data, length, MADV_HUGEPAGE)) {
+        kind_ = Page_kind::transparent_huge;
+        return;
+      }
+    } else
+      mapping_ = posix::mmap_anonymous(round_up(posix::page_size()));
+    kind_ = Page_kind::normal;
+  }
+
+  /// Non-copyable.
+  Large_buffer(const Large_buffer&) = delete;
+
+  /// Non-copyable.
+  Large_buffer& operator=(const Large_buffer&) = delete;
+
+  /// The move constructor.
+  Large_buffer(Large_buffer&& rhs) noexcept
+    : mapping_{std::move(rhs.mapping_)}
+    , kind_{std::exchange(rhs.kind_, Page_kind::normal)}
+  {}
+
+  /// The move assignment operator.
+  Large_buffer& operator=(Large_buffer&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Large_buffer tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Large_buffer& other) noexcept
+  {
+    mapping_.swap(other.mapping_);
+    std::swap(kind_, other.kind_);
+  }
+
+  /// @returns The address of the buffer.
+  void* data() const noexcept
+  {
+    return mapping_.data();
+  }
+
+  /// @returns The size of the buffer rounded up to the page size.
+  std::size_t size() const noexcept
+  {
+    return mapping_.size();
+  }
+
+  /// @returns `true` if the buffer owns the memory.
+  explicit operator bool() const noexcept
+  {
+    return static_cast<bool>(mapping_);
+  }
+
+  /**
+   * @returns The kind of the pages actually used.
+   *
+   * @remarks `Page_kind::transparent_huge` denotes that the region is
+   * eligible for huge pages, but the kernel may still back it (or some of
+   * its parts) by the normal pages.
+   */
+  Page_kind kind() const noexcept
+  {
+    return kind_;
+  }
+
+  /// @returns The address of the buffer and releases the ownership of it.
+  void* release() noexcept
+  {
+    kind_ = Page_kind::normal;
+    return mapping_.release();
+  }
+
+  /// @returns `true` on success, or `false` otherwise.
+  bool unmap() noexcept
+  {
+    kind_ = Page_kind::normal;
+    return mapping_.unmap();
+  }
+
+  /**
+   * @returns The mode of the transparent huge pages: either "always",
+   * "madvise" or "never", or the empty string if the mode is unknown.
+   */
+  static std::string transparent_hugepage_mode()
+  {
+    const auto modes = detail::read_sysfs(
+      "/sys/kernel/mm/transparent_hugepage/enabled");
+    if (modes) {
+      // The current mode is enclosed in brackets.
+      const auto b = modes->find('[');
+      const auto e = modes->find(']');
+      if (b != std::string::npos && e != std::string::npos && b < e)
+        return modes->substr(b + 1, e - b - 1);
+    }
+    return {};
+  }
+
+private:
+  posix::Mmap_guard mapping_;
+  Page_kind kind_{Page_kind::normal};
+};
+
+// -----------------------------------------------------------------------------
+// Huge page pools
+// -----------------------------------------------------------------------------
+
+/// The pool of the explicit huge pages of the same size.
+struct Hugepage_pool final {
+  /// The page size in bytes.
+  std::size_t page_size{};
+  /// The number of pages of the pool.
+  std::size_t total{};
+  /// The number of pages which are not allocated.
+  std::size_t free{};
+  /// The number of pages which are reserved but not allocated yet.
+  std::size_t reserved{};
+  /// The number of pages allocated above `total` (overcommitted).
+  std::size_t surplus{};
+};
+
+/**
+ * @returns The pools of the explicit huge pages from
+ * `/sys/kernel/mm/hugepages` ordered by page size.
+ */
+inline std::vector<Hugepage_pool> hugepage_pools()
+{
+  std::vector<Hugepage_pool> result;
+  const std::string root{"/sys/kernel/mm/hugepages/"};
+  const std::unique_ptr<DIR, int(*)(DIR*)> dir{::opendir(root.c_str()),
+    &::closedir};
+  if (!dir)
+    return result;
+
+  // The directories are named like "hugepages-2048kB".
+  constexpr std::string_view prefix{"hugepages-"};
+  constexpr std::string_view suffix{"kB"};
+  while (const auto* const entry = ::readdir(dir.get())) {
+    std::string_view name{entry->d_name};
+    if (name.size() <= prefix.size() + suffix.size() ||
+      name.substr(0, prefix.size()) != prefix ||
+      name.substr(name.size() - suffix.size()) != suffix)
+      continue;
+    name.remove_prefix(prefix.size());
+    name.remove_suffix(suffix.size());
+    const auto kb = detail::to_unsigned<std::size_t>(name);
+    if (!kb)
+      continue;
+    const auto path = root + entry->d_name + "/";
+    const auto read = [&path](const char* const attribute)
+    {
+      const auto value = detail::read_sysfs(path + attribute);
+      return value ? detail::to_unsigned<std::size_t>(*value).value_or(0) : 0;
+    };
+    result.push_back(Hugepage_pool{*kb * 1024, read("nr_hugepages"),
+      read("free_hugepages"), read("resv_hugepages"),
+      read("surplus_hugepages")});
+  }
+  std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs)
+  {
+    return lhs.page_size < rhs.page_size;
+  });
+  return result;
+}
+
+/// The huge pages summary of `/proc/meminfo`.
+struct Hugepage_meminfo final {
+  /// The pool of the default huge page size.
+  Hugepage_pool default_pool;
+  /// The memory consumed by the explicit huge pages of all sizes in bytes.
+  std::size_t hugetlb{};
+  /// The anonymous memory backed by the transparent huge pages in bytes.
+  std::size_t anon_huge{};
+};
+
+/**
+ * @returns The huge pages summary of `/proc/meminfo`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline Hugepage_meminfo hugepage_meminfo()
+{
+  std::string content;
+  posix::read_all(posix::open("/proc/meminfo"), content);
+
+  Hugepage_meminfo result;
+  std::string_view str{content};
+  while (!str.empty()) {
+    const auto eol = std::min(str.find('\n'), str.size());
+    const auto line = str.substr(0, eol);
+    str.remove_prefix(std::min(eol + 1, str.size()));
+
+    // The lines are like "Key:     value kB".
+    const auto colon = line.find(':');
+    if (colon == std::string_view::npos)
+      continue;
+    const auto key = line.substr(0, colon);
+    auto value = line.substr(colon + 1);
+    value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+    const bool is_kb{value.size() > 3 &&
+      value.substr(value.size() - 3) == " kB"};
+    if (is_kb)
+      value.remove_suffix(3);
+    const auto number = detail::to_unsigned<std::size_t>(value).value_or(0) *
+      (is_kb ? 1024 : 1);
+
+    if (key == "HugePages_Total")
+      result.default_pool.total = number;
+    else if (key == "HugePages_Free")
+      result.default_pool.free = number;
+    else if (key == "HugePages_Rsvd")
+      result.default_pool.reserved = number;
+    else if (key == "HugePages_Surp")
+      result.default_pool.surplus = number;
+    else if (key == "Hugepagesize")
+      result.default_pool.page_size = number;
+    else if (key == "Hugetlb")
+      result.hugetlb = number;
+    else if (key == "AnonHugePages")
+      result.anon_huge = number;
+  }
+  return result;
+}
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_HUGEPAGES_HPP
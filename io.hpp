@@ -0,0 +1,818 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/io.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_IO_HPP
+#define DMITIGR_OS_IO_HPP
+
+#include "../base/assert.hpp"
+#include "exceptions.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace dmitigr::os::io {
+
+/// A backend of the engine.
+enum class Backend {
+  /// The `io_uring` interface of Linux 5.6+.
+  io_uring,
+  /// The thread pool for files and `epoll` for pipes and sockets.
+  epoll
+};
+
+/// The request of I/O operation.
+struct Request final {
+  /// The descriptor, or the index of the registered file if `is_fixed_file`.
+  int file{-1};
+  /// Whether the `file` is the index of the registered file.
+  bool is_fixed_file{};
+  /// The buffer.
+  void* data{};
+  /// The size of the buffer.
+  std::size_t size{};
+  /// The index of the registered buffer which contains `data`, or `-1`.
+  int buffer_index{-1};
+  /// The offset in the file, or `-1` to use the current file position.
+  std::int64_t offset{-1};
+};
+
+/**
+ * @brief The completion callback.
+ *
+ * @details Called with either the error or the number of bytes transferred
+ * (`0` denotes the end of file on read).
+ */
+using Callback = std::function<void(std::error_code error, std::size_t size)>;
+
+namespace detail {
+
+/// The operation code.
+enum class Operation { read, write, poll };
+
+/// The completion of the operation.
+struct Completion final {
+  std::uint64_t user_data{};
+  std::int64_t result{};
+};
+
+/// The implementation of the backend.
+class Engine_impl {
+public:
+  virtual ~Engine_impl() = default;
+  virtual Backend backend() const noexcept = 0;
+  virtual int fd() const noexcept = 0;
+  virtual void register_files(const std::vector<int>& fds) = 0;
+  virtual void register_buffers(const std::vector<::iovec>& buffers) = 0;
+  virtual void prepare(Operation operation, const Request& request,
+    std::uint64_t user_data) = 0;
+  virtual std::size_t submit() = 0;
+  virtual void reap(std::vector<Completion>& completions,
+    std::chrono::milliseconds timeout) = 0;
+};
+
+/// @returns The timeout for `poll()` and `epoll_wait()`.
+inline int to_poll_timeout(const std::chrono::milliseconds timeout) noexcept
+{
+  return timeout == std::chrono::milliseconds::max() ? -1 :
+    static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(),
+        INT_MAX));
+}
+
+// -----------------------------------------------------------------------------
+// io_uring
+// -----------------------------------------------------------------------------
+
+/// The backend based on io_uring.
+class Uring_engine final : public Engine_impl {
+public:
+  explicit Uring_engine(const unsigned entries)
+  {
+    ::io_uring_params params{};
+    ring_ = posix::Fd_guard{static_cast<int>(
+        ::syscall(SYS_io_uring_setup, entries, &params))};
+    if (ring_.fd() == -1)
+      throw Sys_exception{"cannot setup io_uring"};
+    if (!(params.features & IORING_FEAT_RW_CUR_POS))
+      throw Sys_exception{ENOSYS, "io_uring is too old"};
+
+    // Map the rings.
+    auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    auto cq_size = params.cq_off.cqes +
+      params.cq_entries * sizeof(::io_uring_cqe);
+    const bool is_single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (is_single_mmap)
+      sq_size = cq_size = std::max(sq_size, cq_size);
+    sq_mapping_ = map(sq_size, IORING_OFF_SQ_RING);
+    if (!is_single_mmap)
+      cq_mapping_ = map(cq_size, IORING_OFF_CQ_RING);
+    sqes_mapping_ = map(params.sq_entries * sizeof(::io_uring_sqe),
+      IORING_OFF_SQES);
+
+    auto* const sq = static_cast<char*>(sq_mapping_.data());
+    auto* const cq = is_single_mmap ? sq : static_cast<char*>(cq_mapping_.data());
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqes_ = static_cast<::io_uring_sqe*>(sqes_mapping_.data());
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+    local_sq_tail_ = *sq_tail_;
+  }
+
+  Backend backend() const noexcept override
+  {
+    return Backend::io_uring;
+  }
+
+  int fd() const noexcept override
+  {
+    return ring_.fd();
+  }
+
+  void register_files(const std::vector<int>& fds) override
+  {
+    if (has_files_) {
+      register_ring(IORING_UNREGISTER_FILES, nullptr, 0);
+      has_files_ = false;
+    }
+    if (!fds.empty()) {
+      register_ring(IORING_REGISTER_FILES, fds.data(), fds.size());
+      has_files_ = true;
+    }
+  }
+
+  void register_buffers(const std::vector<::iovec>& buffers) override
+  {
+    if (has_buffers_) {
+      register_ring(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+      has_buffers_ = false;
+    }
+    if (!buffers.empty()) {
+      register_ring(IORING_REGISTER_BUFFERS, buffers.data(), buffers.size());
+      has_buffers_ = true;
+    }
+  }
+
+  void prepare(const Operation operation, const Request& request,
+    const std::uint64_t user_data) override
+  {
+    if (local_sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) ==
+      sq_entries_) {
+      submit();
+      if (local_sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) ==
+        sq_entries_)
+        throw Sys_exception{EBUSY, "io_uring submission queue is full"};
+    }
+
+    const auto index = local_sq_tail_ & sq_mask_;
+    auto& sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    if (operation == Operation::poll) {
+      sqe.opcode = IORING_OP_POLL_ADD;
+      sqe.poll_events = POLLIN;
+    } else {
+      const bool is_fixed_buffer{request.buffer_index >= 0};
+      if (operation == Operation::read)
+        sqe.opcode = is_fixed_buffer ? IORING_OP_READ_FIXED : IORING_OP_READ;
+      else
+        sqe.opcode = is_fixed_buffer ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+      sqe.off = static_cast<std::uint64_t>(request.offset);
+      sqe.addr = reinterpret_cast<std::uint64_t>(request.data);
+      sqe.len = static_cast<std::uint32_t>(request.size);
+      if (is_fixed_buffer)
+        sqe.buf_index = static_cast<std::uint16_t>(request.buffer_index);
+    }
+    if (request.is_fixed_file)
+      sqe.flags = IOSQE_FIXED_FILE;
+    sqe.fd = request.file;
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    ++local_sq_tail_;
+  }
+
+  std::size_t submit() override
+  {
+    __atomic_store_n(sq_tail_, local_sq_tail_, __ATOMIC_RELEASE);
+    std::size_t result{};
+    while (const auto count = local_sq_tail_ -
+      __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) {
+      const auto n = ::syscall(SYS_io_uring_enter, ring_.fd(), count, 0, 0,
+        nullptr, 0);
+      if (n > 0)
+        result += n;
+      else if (n < 0 && (errno == EAGAIN || errno == EBUSY))
+        break; // retry on the next submit
+      else if (n < 0 && errno != EINTR)
+        throw Sys_exception{"cannot submit to io_uring"};
+    }
+    return result;
+  }
+
+  void reap(std::vector<Completion>& completions,
+    const std::chrono::milliseconds timeout) override
+  {
+    if (!reap(completions) && timeout.count()) {
+      if (timeout == std::chrono::milliseconds::max()) {
+        if (::syscall(SYS_io_uring_enter, ring_.fd(), 0, 1,
+            IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+          throw Sys_exception{"cannot wait for io_uring completions"};
+      } else {
+        ::pollfd pfd{ring_.fd(), POLLIN, 0};
+        if (::poll(&pfd, 1, to_poll_timeout(timeout)) < 0 && errno != EINTR)
+          throw Sys_exception{"cannot wait for io_uring completions"};
+      }
+      reap(completions);
+    }
+  }
+
+private:
+  posix::Fd_guard ring_;
+  posix::Mmap_guard sq_mapping_;
+  posix::Mmap_guard cq_mapping_;
+  posix::Mmap_guard sqes_mapping_;
+  unsigned* sq_head_{};
+  unsigned* sq_tail_{};
+  unsigned sq_mask_{};
+  unsigned sq_entries_{};
+  unsigned* sq_array_{};
+  ::io_uring_sqe* sqes_{};
+  unsigned* cq_head_{};
+  unsigned* cq_tail_{};
+  unsigned cq_mask_{};
+  ::io_uring_cqe* cqes_{};
+  unsigned local_sq_tail_{};
+  bool has_files_{};
+  bool has_buffers_{};
+
+  posix::Mmap_guard map(const std::size_t size, const std::uint64_t offset)
+  {
+    void* const result = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ring_.fd(), static_cast<off_t>(offset));
+    if (result == MAP_FAILED)
+      throw Sys_exception{"cannot map io_uring"};
+    return posix::Mmap_guard{result, size};
+  }
+
+  void register_ring(const unsigned opcode, const void* const args,
+    const std::size_t count)
+  {
+    if (::syscall(SYS_io_uring_register, ring_.fd(), opcode, args, count) < 0)
+      throw Sys_exception{"cannot register resources in io_uring"};
+  }
+
+  std::size_t reap(std::vector<Completion>& completions)
+  {
+    auto head = *cq_head_;
+    const auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    const std::size_t result{tail - head};
+    for (; head != tail; ++head) {
+      const auto& cqe = cqes_[head & cq_mask_];
+      completions.push_back({cqe.user_data, cqe.res});
+    }
+    __atomic_store_n(cq_head_, tail, __ATOMIC_RELEASE);
+    return result;
+  }
+};
+
+// -----------------------------------------------------------------------------
+// epoll
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The backend based on the thread pool and epoll.
+ *
+ * @details Reads from pipes, sockets and other pollable descriptors are
+ * performed by the calling thread on readiness reported by epoll. The other
+ * operations are performed by the thread pool.
+ */
+class Epoll_engine final : public Engine_impl {
+public:
+  explicit Epoll_engine(const std::size_t thread_count)
+    : epoll_{::epoll_create1(EPOLL_CLOEXEC)}
+    , event_{::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)}
+  {
+    if (epoll_.fd() == -1)
+      throw Sys_exception{"cannot create epoll instance"};
+    else if (event_.fd() == -1)
+      throw Sys_exception{"cannot create eventfd"};
+    ::epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = event_.fd();
+    if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, event_, &event))
+      throw Sys_exception{"cannot add eventfd to epoll instance"};
+
+    threads_.reserve(std::max<std::size_t>(thread_count, 1));
+    try {
+      for (std::size_t i{}; i < threads_.capacity(); ++i)
+        threads_.emplace_back([this]{work();});
+    } catch (...) {
+      stop();
+      throw;
+    }
+  }
+
+  ~Epoll_engine() override
+  {
+    stop();
+  }
+
+  Backend backend() const noexcept override
+  {
+    return Backend::epoll;
+  }
+
+  int fd() const noexcept override
+  {
+    return epoll_.fd();
+  }
+
+  void register_files(const std::vector<int>& fds) override
+  {
+    files_ = fds;
+  }
+
+  void register_buffers(const std::vector<::iovec>&) override
+  {}
+
+  void prepare(const Operation operation, const Request& request,
+    const std::uint64_t user_data) override
+  {
+    Task task{operation, request, user_data};
+    if (request.is_fixed_file) {
+      DMITIGR_ASSERT(static_cast<std::size_t>(request.file) < files_.size());
+      task.request.file = files_[request.file];
+    }
+    prepared_.push_back(task);
+  }
+
+  std::size_t submit() override
+  {
+    const auto result = prepared_.size();
+    bool is_pooled{};
+    {
+      const std::lock_guard lock{mutex_};
+      for (const auto& task : prepared_) {
+        if (task.operation != Operation::write && watch(task))
+          continue;
+        tasks_.push_back(task);
+        is_pooled = true;
+      }
+    }
+    prepared_.clear();
+    if (is_pooled)
+      condition_.notify_all();
+    return result;
+  }
+
+  void reap(std::vector<Completion>& completions,
+    const std::chrono::milliseconds timeout) override
+  {
+    // The ready descriptors are checked even with zero timeout.
+    const bool is_done = reap_done(completions);
+    std::array<::epoll_event, 64> events;
+    const int n = ::epoll_wait(epoll_, events.data(),
+      static_cast<int>(events.size()),
+      is_done ? 0 : to_poll_timeout(timeout));
+    if (n < 0 && errno != EINTR)
+      throw Sys_exception{"cannot wait for epoll events"};
+    for (int i{}; i < n; ++i) {
+      const int fd = events[i].data.fd;
+      if (fd == event_.fd()) {
+        std::uint64_t value;
+        while (::read(event_, &value, sizeof(value)) == -1 && errno == EINTR);
+      } else
+        on_ready(fd, completions);
+    }
+    reap_done(completions);
+  }
+
+private:
+  struct Task final {
+    Operation operation{};
+    Request request;
+    std::uint64_t user_data{};
+  };
+
+  posix::Fd_guard epoll_;
+  posix::Fd_guard event_;
+  std::vector<int> files_;
+  std::vector<Task> prepared_;
+  std::unordered_map<int, std::deque<Task>> watched_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Task> tasks_;
+  std::vector<Completion> done_;
+  bool is_stopped_{};
+  std::vector<std::thread> threads_;
+
+  void stop() noexcept
+  {
+    {
+      const std::lock_guard lock{mutex_};
+      is_stopped_ = true;
+    }
+    condition_.notify_all();
+    for (auto& thread : threads_)
+      thread.join();
+    threads_.clear();
+  }
+
+  static std::int64_t perform(const Task& task) noexcept
+  {
+    const auto& r = task.request;
+    while (true) {
+      ssize_t result;
+      if (task.operation == Operation::poll) {
+        ::pollfd pfd{r.file, POLLIN, 0};
+        result = ::poll(&pfd, 1, 0);
+        if (result > 0)
+          return pfd.revents;
+        else if (!result)
+          return -EAGAIN;
+      } else if (task.operation == Operation::read)
+        result = r.offset < 0 ? ::read(r.file, r.data, r.size) :
+          ::pread(r.file, r.data, r.size, r.offset);
+      else
+        result = r.offset < 0 ? ::write(r.file, r.data, r.size) :
+          ::pwrite(r.file, r.data, r.size, r.offset);
+      if (result >= 0)
+        return result;
+      else if (errno != EINTR)
+        return -errno;
+    }
+  }
+
+  void work()
+  {
+    while (true) {
+      std::unique_lock lock{mutex_};
+      condition_.wait(lock, [this]{return is_stopped_ || !tasks_.empty();});
+      if (is_stopped_)
+        return;
+      const auto task = tasks_.front();
+      tasks_.pop_front();
+      lock.unlock();
+
+      const auto result = perform(task);
+      lock.lock();
+      done_.push_back({task.user_data, result});
+      lock.unlock();
+      const std::uint64_t one{1};
+      while (::write(event_, &one, sizeof(one)) == -1 && errno == EINTR);
+    }
+  }
+
+  /**
+   * @returns `true` if the read from (or the poll of) `task.request.file` is
+   * watched by epoll.
+   */
+  bool watch(const Task& task)
+  {
+    const int fd = task.request.file;
+    if (const auto i = watched_.find(fd); i != watched_.end()) {
+      i->second.push_back(task);
+      return true;
+    }
+
+    /*
+     * Descriptors of regular files and block devices are not pollable, and
+     * the errors (such as reading of the write-only descriptor) are reported
+     * by the thread pool.
+     */
+    struct stat st{};
+    const int flags = ::fcntl(fd, F_GETFL);
+    if (flags == -1 || (flags & O_ACCMODE) == O_WRONLY ||
+      ::fstat(fd, &st) || S_ISREG(st.st_mode) || S_ISBLK(st.st_mode))
+      return false;
+    ::epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event))
+      return false;
+    watched_[fd].push_back(task);
+    return true;
+  }
+
+  void on_ready(const int fd, std::vector<Completion>& completions)
+  {
+    const auto i = watched_.find(fd);
+    if (i == watched_.end())
+      return;
+    auto& queue = i->second;
+    const auto result = perform(queue.front());
+    // Spurious readiness of the nonblocking descriptor.
+    if (result != -EAGAIN) {
+      completions.push_back({queue.front().user_data, result});
+      queue.pop_front();
+    }
+    if (queue.empty()) {
+      ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+      watched_.erase(i);
+    } else {
+      ::epoll_event event{};
+      event.events = EPOLLIN | EPOLLONESHOT;
+      event.data.fd = fd;
+      ::epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &event);
+    }
+  }
+
+  std::size_t reap_done(std::vector<Completion>& completions)
+  {
+    const std::lock_guard lock{mutex_};
+    const auto result = done_.size();
+    completions.insert(completions.end(), done_.begin(), done_.end());
+    done_.clear();
+    return result;
+  }
+};
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Engine
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The asynchronous I/O engine.
+ *
+ * @details The operations are queued by `read()` and `write()`, submitted in
+ * batches by `submit()` (which is also called implicitly by `poll()`, `wait()`
+ * and `run()`), and the completion callbacks are called by `poll()`, `wait()`
+ * and `run()`. The callbacks may queue new operations and may call `poll()`
+ * or `wait()`. If a callback throws, the exception is propagated to the
+ * caller, and the callbacks of the rest of the reaped completions are called
+ * by the next call of `poll()`, `wait()` or `run()`.
+ *
+ * The engine is not thread-safe: it's intended to be used by one thread.
+ *
+ * @remarks The buffers must remain valid until the completion of the
+ * operations. The engine must not be destroyed while there are pending
+ * operations.
+ */
+class Engine final {
+public:
+  /**
+   * @brief The constructor.
+   *
+   * @param queue_depth The size of the submission queue of io_uring.
+   * @param backend The backend to use. By default, `Backend::io_uring` is
+   * used if available, and `Backend::epoll` otherwise.
+   * @param thread_count The number of threads of `Backend::epoll`.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  explicit Engine(const unsigned queue_depth = 256,
+    const std::optional<Backend> backend = std::nullopt,
+    const std::size_t thread_count = 4)
+  {
+    if (!backend || backend == Backend::io_uring) {
+      try {
+        impl_ = std::make_unique<detail::Uring_engine>(queue_depth);
+      } catch (const Sys_exception& e) {
+        const auto& c = e.condition();
+        /*
+         * io_uring is unsupported, disabled by sysctl, seccomp or LSM, or
+         * (before Linux 5.12) the ring exceeds RLIMIT_MEMLOCK.
+         */
+        if (backend || !(c == std::errc::function_not_supported ||
+            c == std::errc::operation_not_permitted ||
+            c == std::errc::permission_denied ||
+            c == std::errc::not_enough_memory))
+          throw;
+      }
+    }
+    if (!impl_)
+      impl_ = std::make_unique<detail::Epoll_engine>(thread_count);
+  }
+
+  /// @returns The backend used.
+  Backend backend() const noexcept
+  {
+    return impl_->backend();
+  }
+
+  /**
+   * @returns The descriptor which becomes readable when completions are
+   * available, to integrate the engine into the other event loop.
+   */
+  int fd() const noexcept
+  {
+    return impl_->fd();
+  }
+
+  /**
+   * @brief Registers the descriptors `fds` (replacing the registered ones)
+   * to refer them by indexes.
+   *
+   * @details This avoids the reference counting of the files by the kernel
+   * on each operation.
+   *
+   * @par Requires
+   * `!pending()`.
+   *
+   * @see `Request::is_fixed_file`.
+   */
+  void register_files(const std::vector<int>& fds)
+  {
+    DMITIGR_ASSERT(!pending_);
+    impl_->register_files(fds);
+  }
+
+  /**
+   * @brief Registers the `buffers` (replacing the registered ones) to refer
+   * them by indexes.
+   *
+   * @details This avoids the mapping of the pages by the kernel on each
+   * operation. The registered memory is locked and is limited by
+   * `RLIMIT_MEMLOCK`.
+   *
+   * @par Requires
+   * `!pending()`.
+   *
+   * @see `Request::buffer_index`.
+   */
+  void register_buffers(const std::vector<::iovec>& buffers)
+  {
+    DMITIGR_ASSERT(!pending_);
+    impl_->register_buffers(buffers);
+  }
+
+  /// Queues the read operation.
+  void read(const Request& request, Callback callback)
+  {
+    prepare(detail::Operation::read, request, std::move(callback));
+  }
+
+  /// Queues the write operation.
+  void write(const Request& request, Callback callback)
+  {
+    prepare(detail::Operation::write, request, std::move(callback));
+  }
+
+  /**
+   * @brief Queues the operation of waiting for readability of the descriptor.
+   *
+   * @details The callback is called with the mask of `poll()` events instead
+   * of the number of bytes. This is useful to watch descriptors like pidfd or
+   * eventfd along with the I/O operations.
+   *
+   * @par Requires
+   * Only `file` and `is_fixed_file` of the `request` are used.
+   */
+  void wait_readable(const Request& request, Callback callback)
+  {
+    prepare(detail::Operation::poll, request, std::move(callback));
+  }
+
+  /**
+   * @brief Submits the queued operations by (normally) one system call.
+   *
+   * @returns The number of operations submitted.
+   */
+  std::size_t submit()
+  {
+    return impl_->submit();
+  }
+
+  /**
+   * @brief Submits the queued operations and calls the callbacks of the
+   * completed operations without waiting.
+   *
+   * @returns The number of callbacks called.
+   */
+  std::size_t poll()
+  {
+    return wait(std::chrono::milliseconds::zero());
+  }
+
+  /**
+   * @brief Submits the queued operations and calls the callbacks of the
+   * completed operations waiting for at least one completion for up to
+   * `timeout` if necessary.
+   *
+   * @returns The number of callbacks called.
+   */
+  std::size_t wait(
+    const std::chrono::milliseconds timeout = std::chrono::milliseconds::max())
+  {
+    submit();
+    std::vector<detail::Completion> completions;
+    impl_->reap(completions, ready_.empty() && pending_ ? timeout :
+      std::chrono::milliseconds::zero());
+    ready_.insert(ready_.end(), completions.begin(), completions.end());
+    std::size_t result{};
+    while (!ready_.empty()) {
+      const auto completion = ready_.front();
+      ready_.pop_front();
+      const auto slot = static_cast<std::size_t>(completion.user_data);
+      auto callback = std::move(callbacks_[slot]);
+      callbacks_[slot] = nullptr;
+      free_slots_.push_back(slot);
+      --pending_;
+      ++result;
+      if (completion.result < 0)
+        callback(std::error_code{static_cast<int>(-completion.result),
+          std::system_category()}, 0);
+      else
+        callback({}, static_cast<std::size_t>(completion.result));
+    }
+    return result;
+  }
+
+  /// Calls `wait()` until there are no pending operations.
+  void run()
+  {
+    while (pending_)
+      wait();
+  }
+
+  /// @returns The number of operations which are not completed yet.
+  std::size_t pending() const noexcept
+  {
+    return pending_;
+  }
+
+private:
+  std::unique_ptr<detail::Engine_impl> impl_;
+  std::vector<Callback> callbacks_;
+  std::vector<std::size_t> free_slots_;
+  std::deque<detail::Completion> ready_;
+  std::size_t pending_{};
+
+  void prepare(const detail::Operation operation, const Request& request,
+    Callback callback)
+  {
+    std::size_t slot;
+    if (free_slots_.empty()) {
+      slot = callbacks_.size();
+      free_slots_.reserve(slot + 1); // to free the slot without throwing
+      callbacks_.emplace_back();
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    try {
+      impl_->prepare(operation, request, slot);
+    } catch (...) {
+      free_slots_.push_back(slot);
+      throw;
+    }
+    callbacks_[slot] = std::move(callback);
+    ++pending_;
+  }
+};
+
+} // namespace dmitigr::os::io
+
+#endif  // DMITIGR_OS_IO_HPP
@@ -0,0 +1,486 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/ipc_pipe.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_IPC_PIPE_HPP
+#define DMITIGR_OS_IPC_PIPE_HPP
+
+#include "exceptions.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace dmitigr::os::ipc {
+
+// -----------------------------------------------------------------------------
+// Descriptor options
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Sets or clears `O_NONBLOCK` of the descriptor `fd`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void set_nonblocking(const int fd, const bool value = true)
+{
+  const int flags = ::fcntl(fd, F_GETFL);
+  if (flags == -1)
+    throw Sys_exception{"cannot get file status flags"};
+  const int new_flags = value ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+  if (new_flags != flags && ::fcntl(fd, F_SETFL, new_flags) == -1)
+    throw Sys_exception{"cannot set file status flags"};
+}
+
+/**
+ * @returns `true` if `O_NONBLOCK` of the descriptor `fd` is set.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline bool is_nonblocking(const int fd)
+{
+  const int flags = ::fcntl(fd, F_GETFL);
+  if (flags == -1)
+    throw Sys_exception{"cannot get file status flags"};
+  return flags & O_NONBLOCK;
+}
+
+/**
+ * @returns The capacity of the pipe referred by the descriptor `fd`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::size_t pipe_capacity(const int fd)
+{
+  const int result = ::fcntl(fd, F_GETPIPE_SZ);
+  if (result == -1)
+    throw Sys_exception{"cannot get pipe capacity"};
+  return static_cast<std::size_t>(result);
+}
+
+/**
+ * @brief Sets the capacity of the pipe referred by the descriptor `fd`.
+ *
+ * @details The kernel rounds `size` up to the power of two number of pages.
+ * Unprivileged processes are limited by `/proc/sys/fs/pipe-max-size`.
+ *
+ * @returns The actual capacity.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::size_t set_pipe_capacity(const int fd, const std::size_t size)
+{
+  const int result = ::fcntl(fd, F_SETPIPE_SZ, static_cast<int>(
+      std::min<std::size_t>(size, std::numeric_limits<int>::max())));
+  if (result == -1)
+    throw Sys_exception{"cannot set pipe capacity"};
+  return static_cast<std::size_t>(result);
+}
+
+// -----------------------------------------------------------------------------
+// Pipe
+// -----------------------------------------------------------------------------
+
+/// An anonymous pipe.
+class Pipe final {
+public:
+  /// Constructs the invalid instance.
+  Pipe() noexcept = default;
+
+  /**
+   * @brief Creates the pipe with both ends closed on `exec()`.
+   *
+   * @param nonblocking Whether to set `O_NONBLOCK` to both ends.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Pipe make(const bool nonblocking = false)
+  {
+    int fds[2];
+    if (::pipe2(fds, O_CLOEXEC | (nonblocking ? O_NONBLOCK : 0)))
+      throw Sys_exception{"cannot create pipe"};
+    return Pipe{posix::Fd_guard{fds[0]}, posix::Fd_guard{fds[1]}};
+  }
+
+  /// The swap operation.
+  void swap(Pipe& other) noexcept
+  {
+    reader_.swap(other.reader_);
+    writer_.swap(other.writer_);
+  }
+
+  /// @returns The read end.
+  const posix::Fd_guard& reader() const noexcept
+  {
+    return reader_;
+  }
+
+  /// @returns The write end.
+  const posix::Fd_guard& writer() const noexcept
+  {
+    return writer_;
+  }
+
+  /**
+   * @returns The read end and releases the ownership of it.
+   *
+   * @remarks Useful to pass the end to the other process or thread.
+   */
+  posix::Fd_guard release_reader() noexcept
+  {
+    return std::move(reader_);
+  }
+
+  /// @returns The write end and releases the ownership of it.
+  posix::Fd_guard release_writer() noexcept
+  {
+    return std::move(writer_);
+  }
+
+  /**
+   * @brief Closes the write end.
+   *
+   * @details The reader gets the end of file as soon as all the data written
+   * is read.
+   *
+   * @returns `true` on success, or `false` otherwise.
+   */
+  bool close_writer() noexcept
+  {
+    return writer_.close();
+  }
+
+  /// @returns `true` on success, or `false` otherwise.
+  bool close_reader() noexcept
+  {
+    return reader_.close();
+  }
+
+  /**
+   * @brief Sets or clears `O_NONBLOCK` of the both (opened) ends.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  void set_nonblocking(const bool value = true)
+  {
+    for (const int fd : {reader_.fd(), writer_.fd()}) {
+      if (fd != -1)
+        ipc::set_nonblocking(fd, value);
+    }
+  }
+
+  /**
+   * @returns The capacity of the pipe.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::size_t capacity() const
+  {
+    return pipe_capacity(any_fd());
+  }
+
+  /**
+   * @brief Sets the capacity of the pipe.
+   *
+   * @returns The actual capacity.
+   *
+   * @throws `Sys_exception` on failure.
+   *
+   * @see `set_pipe_capacity()`.
+   */
+  std::size_t set_capacity(const std::size_t size)
+  {
+    return set_pipe_capacity(any_fd(), size);
+  }
+
+private:
+  posix::Fd_guard reader_;
+  posix::Fd_guard writer_;
+
+  Pipe(posix::Fd_guard reader, posix::Fd_guard writer) noexcept
+    : reader_{std::move(reader)}
+    , writer_{std::move(writer)}
+  {}
+
+  int any_fd() const noexcept
+  {
+    return reader_.fd() != -1 ? reader_.fd() : writer_.fd();
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Named pipe
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Creates the named pipe (FIFO) at `path`.
+ *
+ * @param mode The permissions which are modified by the umask.
+ *
+ * @returns `true` if the FIFO is created, or `false` if it already exists.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline bool make_fifo(const std::string& path, const ::mode_t mode = 0600)
+{
+  if (!::mkfifo(path.c_str(), mode))
+    return true;
+  else if (errno == EEXIST) {
+    struct stat st{};
+    if (!::stat(path.c_str(), &st) && S_ISFIFO(st.st_mode))
+      return false;
+    throw Sys_exception{EEXIST, "cannot create FIFO "+path};
+  }
+  throw Sys_exception{"cannot create FIFO "+path};
+}
+
+/**
+ * @returns The descriptor of the named pipe (FIFO) opened at `path`.
+ *
+ * @param flags Either `O_RDONLY` or `O_WRONLY` optionally combined with
+ * `O_NONBLOCK`. Note, that opening in the blocking mode waits for the peer,
+ * and opening for writing in the nonblocking mode fails with `ENXIO` if
+ * there is no reader.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline posix::Fd_guard open_fifo(const std::string& path, const int flags)
+{
+  posix::Fd_guard result{::open(path.c_str(), flags | O_CLOEXEC)};
+  if (result.fd() == -1)
+    throw Sys_exception{"cannot open FIFO "+path};
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// Zero-copy transfer
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Moves up to `size` bytes from `in` to `out` without copying them
+ * through the user space. At least one of the descriptors must be a pipe.
+ *
+ * @param in_offset The offset to read from, or `nullptr` to read from the
+ * current position. Must be `nullptr` if `in` is a pipe. Advanced by the
+ * number of bytes read.
+ * @param out_offset Similar to `in_offset` but for `out`.
+ * @param flags A combination of `SPLICE_F_MOVE`, `SPLICE_F_NONBLOCK` and
+ * `SPLICE_F_MORE`.
+ *
+ * @returns The number of bytes moved (`0` denotes the end of `in`), or
+ * `std::nullopt` if the operation would block.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::optional<std::size_t> splice(const int in, ::loff_t* const in_offset,
+  const int out, ::loff_t* const out_offset, const std::size_t size,
+  const unsigned flags = SPLICE_F_MOVE)
+{
+  while (true) {
+    const auto result = ::splice(in, in_offset, out, out_offset, size, flags);
+    if (result >= 0)
+      return static_cast<std::size_t>(result);
+    else if (errno == EAGAIN)
+      return std::nullopt;
+    else if (errno != EINTR)
+      throw Sys_exception{"cannot splice"};
+  }
+}
+
+/// @overload
+inline std::optional<std::size_t> splice(const int in, const int out,
+  const std::size_t size, const unsigned flags = SPLICE_F_MOVE)
+{
+  return splice(in, nullptr, out, nullptr, size, flags);
+}
+
+/**
+ * @brief Duplicates up to `size` bytes from the pipe `in` to the pipe `out`
+ * without consuming them from `in`.
+ *
+ * @returns The number of bytes duplicated (`0` denotes the empty `in` without
+ * writers), or `std::nullopt` if the operation would block.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::optional<std::size_t> tee(const int in, const int out,
+  const std::size_t size, const unsigned flags = 0)
+{
+  while (true) {
+    const auto result = ::tee(in, out, size, flags);
+    if (result >= 0)
+      return static_cast<std::size_t>(result);
+    else if (errno == EAGAIN)
+      return std::nullopt;
+    else if (errno != EINTR)
+      throw Sys_exception{"cannot tee"};
+  }
+}
+
+/**
+ * @brief Maps the user memory `iov` into the pipe `out`.
+ *
+ * @details With `SPLICE_F_GIFT` the pages of page aligned buffers may be
+ * moved to the pipe without copying. Anyway, the buffers must not be modified
+ * until the data is consumed from the pipe.
+ *
+ * @returns The number of bytes mapped, or `std::nullopt` if the operation
+ * would block.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::optional<std::size_t> vmsplice(const int out,
+  const ::iovec* const iov, const std::size_t count, const unsigned flags = 0)
+{
+  while (true) {
+    const auto result = ::vmsplice(out, iov, count, flags);
+    if (result >= 0)
+      return static_cast<std::size_t>(result);
+    else if (errno == EAGAIN)
+      return std::nullopt;
+    else if (errno != EINTR)
+      throw Sys_exception{"cannot vmsplice"};
+  }
+}
+
+/// @overload
+inline std::optional<std::size_t> vmsplice(const int out, const void* const data,
+  const std::size_t size, const unsigned flags = 0)
+{
+  const ::iovec iov{const_cast<void*>(data), size};
+  return ipc::vmsplice(out, &iov, 1, flags);
+}
+
+namespace detail {
+
+/// @returns `true` if `fd` refers to a pipe.
+inline bool is_pipe(const int fd)
+{
+  struct stat st{};
+  if (::fstat(fd, &st))
+    throw Sys_exception{"cannot get file status"};
+  return S_ISFIFO(st.st_mode);
+}
+
+/// Copies up to `size` bytes from `in` to `out` through the user space.
+inline std::size_t copy(const int in, const int out, const std::size_t size)
+{
+  std::vector<char> buf(std::min<std::size_t>(size, 1 << 16));
+  std::size_t result{};
+  while (result < size) {
+    const auto n = ::read(in, buf.data(), std::min(buf.size(), size - result));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw Sys_exception{"cannot read"};
+    } else if (!n)
+      break;
+    for (ssize_t written{}; written < n;) {
+      const auto m = ::write(out, buf.data() + written, n - written);
+      if (m < 0) {
+        if (errno == EINTR)
+          continue;
+        throw Sys_exception{"cannot write"};
+      }
+      written += m;
+    }
+    result += n;
+  }
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Transfers up to `size` bytes (or until the end of `in`) from `in` to
+ * `out`, which are blocking descriptors of pipes, files or sockets.
+ *
+ * @details If neither `in` nor `out` is a pipe, the data is spliced through
+ * the intermediate pipe, so it's never copied to the user space. If the kernel
+ * can't splice the descriptors, the data is copied via the buffer instead.
+ *
+ * @returns The number of bytes transferred.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::size_t transfer(const int in, const int out,
+  const std::size_t size = std::numeric_limits<std::size_t>::max())
+{
+  constexpr unsigned flags{SPLICE_F_MOVE | SPLICE_F_MORE};
+  constexpr std::size_t chunk_size{std::size_t{1} << 30};
+  std::size_t result{}; // the number of bytes written to `out`
+  Pipe pipe;
+  std::size_t pending{}; // the number of bytes in the intermediate `pipe`
+  try {
+    if (detail::is_pipe(in) || detail::is_pipe(out)) {
+      while (result < size) {
+        const auto n = splice(in, out, std::min(size - result, chunk_size),
+          flags).value_or(0);
+        if (!n)
+          break;
+        result += n;
+      }
+    } else {
+      pipe = Pipe::make();
+      const auto capacity = pipe.capacity();
+      while (result < size) {
+        pending = splice(in, pipe.writer(),
+          std::min(size - result, capacity), flags).value_or(0);
+        if (!pending)
+          break;
+        while (pending) {
+          const auto m = splice(pipe.reader(), out, pending, flags).value_or(0);
+          if (!m)
+            throw Sys_exception{EPIPE, "cannot splice"};
+          pending -= m;
+          result += m;
+        }
+      }
+    }
+  } catch (const Sys_exception& e) {
+    // Descriptors which don't support splice (or `out` opened with O_APPEND)
+    // are reported by EINVAL. The data already moved from `in` to the
+    // intermediate pipe is written to `out` before copying the rest.
+    if (e.condition() != std::errc::invalid_argument)
+      throw;
+    if (pending) {
+      if (detail::copy(pipe.reader(), out, pending) != pending)
+        throw Sys_exception{EPIPE, "cannot drain intermediate pipe"};
+      result += pending;
+    }
+    result += detail::copy(in, out, size - result);
+  }
+  return result;
+}
+
+} // namespace dmitigr::os::ipc
+
+#endif  // DMITIGR_OS_IPC_PIPE_HPP
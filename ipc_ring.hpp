@@ -0,0 +1,597 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/ipc_ring.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_IPC_RING_HPP
+#define DMITIGR_OS_IPC_RING_HPP
+
+#include "exceptions.hpp"
+#include "pid.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace dmitigr::os::ipc {
+
+/**
+ * @brief The data required to attach to the shared memory ring from the
+ * other process.
+ *
+ * @see `Basic_shm_ring::token()`, `Basic_shm_ring::attach()`.
+ */
+struct Shm_ring_token final {
+  /// The identifier of the process which owns the descriptor.
+  Pid pid{};
+  /// The descriptor of the shared memory in the process `pid`.
+  int fd{-1};
+};
+
+namespace detail {
+
+/// The size of the cache line assumed.
+constexpr std::size_t cache_line_size{64};
+
+/// The futex word.
+using Futex = std::atomic<std::uint32_t>;
+static_assert(sizeof(Futex) == sizeof(std::uint32_t) &&
+  Futex::is_always_lock_free);
+
+/**
+ * @brief Waits on the (process-shared) futex while it contains `expected`.
+ *
+ * @returns `false` on timeout.
+ */
+inline bool futex_wait(Futex& futex, const std::uint32_t expected,
+  const std::chrono::nanoseconds timeout) noexcept
+{
+  using std::chrono::seconds;
+  const bool is_infinite{timeout == std::chrono::nanoseconds::max()};
+  const auto secs = std::chrono::duration_cast<seconds>(timeout);
+  const ::timespec ts{static_cast<::time_t>(secs.count()),
+    static_cast<long>((timeout - secs).count())};
+  const auto result = ::syscall(SYS_futex, &futex, FUTEX_WAIT, expected,
+    is_infinite ? nullptr : &ts, nullptr, 0);
+  return !(result == -1 && errno == ETIMEDOUT);
+}
+
+/// Wakes up to `count` waiters of the (process-shared) futex.
+inline void futex_wake(Futex& futex, const int count) noexcept
+{
+  ::syscall(SYS_futex, &futex, FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+/**
+ * @returns The duplicate of the descriptor `fd` of the process `pid`.
+ *
+ * @details `pidfd_getfd()` is tried first. If it's unavailable or forbidden
+ * (for example, by Yama when the child process duplicates the descriptor of
+ * its parent), the descriptor is reopened via `/proc/<pid>/fd/<fd>`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline posix::Fd_guard duplicate_fd(const Pid pid, const int fd)
+{
+  if (pid == os::pid()) {
+    posix::Fd_guard result{::fcntl(fd, F_DUPFD_CLOEXEC, 0)};
+    if (result.fd() == -1)
+      throw Sys_exception{"cannot duplicate descriptor"};
+    return result;
+  }
+
+#if defined(SYS_pidfd_open) && defined(SYS_pidfd_getfd)
+  const posix::Fd_guard pidfd{static_cast<int>(
+      ::syscall(SYS_pidfd_open, pid, 0))};
+  if (pidfd.fd() != -1) {
+    posix::Fd_guard result{static_cast<int>(
+        ::syscall(SYS_pidfd_getfd, pidfd.fd(), fd, 0))};
+    if (result.fd() != -1)
+      return result;
+  }
+#endif
+
+  return posix::open("/proc/" + std::to_string(pid) + "/fd/" +
+    std::to_string(fd), O_RDWR);
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Basic_shm_ring
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The bounded queue of messages in the shared memory.
+ *
+ * @details The ring consists of the fixed number of slots of the fixed size.
+ * The head and tail counters are placed on the separate cache lines. Messages
+ * are published and consumed in batches, so the counters are updated (and
+ * the sleeping peer is woken via futex) once per batch. No system calls are
+ * made unless the peer sleeps.
+ *
+ * The memory is created by `memfd_create()` and sealed against resizing.
+ * The peer process attaches by using either `token()` or the descriptor
+ * passed in any other way (for example, inherited or sent over the socket).
+ *
+ * @tparam IsMultiProducer Whether the multiple producers (threads or
+ * processes) are allowed. In any case, there must be the only consumer.
+ */
+template<bool IsMultiProducer>
+class Basic_shm_ring final {
+public:
+  /// Constructs the invalid instance.
+  Basic_shm_ring() noexcept = default;
+
+  /// Non-copyable.
+  Basic_shm_ring(const Basic_shm_ring&) = delete;
+
+  /// Non-copyable.
+  Basic_shm_ring& operator=(const Basic_shm_ring&) = delete;
+
+  /// The move constructor.
+  Basic_shm_ring(Basic_shm_ring&& rhs) noexcept
+    : fd_{std::move(rhs.fd_)}
+    , mapping_{std::move(rhs.mapping_)}
+    , header_{std::exchange(rhs.header_, nullptr)}
+    , cached_tail_{rhs.cached_tail_}
+    , cached_head_{rhs.cached_head_}
+  {}
+
+  /// The move assignment operator.
+  Basic_shm_ring& operator=(Basic_shm_ring&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Basic_shm_ring tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Basic_shm_ring& other) noexcept
+  {
+    fd_.swap(other.fd_);
+    mapping_.swap(other.mapping_);
+    std::swap(header_, other.header_);
+    std::swap(cached_tail_, other.cached_tail_);
+    std::swap(cached_head_, other.cached_head_);
+  }
+
+  /**
+   * @returns The new ring of at least `slot_count` slots (rounded up to the
+   * power of two) for messages up to `message_size` bytes.
+   *
+   * @param name The name of the memory file (for debugging purposes).
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Basic_shm_ring make(std::size_t slot_count,
+    const std::size_t message_size, const char* const name = "dmitigr_shm_ring")
+  {
+    if (!slot_count || !message_size || message_size > UINT32_MAX)
+      throw std::invalid_argument{"invalid shared memory ring parameters"};
+    std::size_t power_of_two{1};
+    while (power_of_two < slot_count)
+      power_of_two <<= 1;
+    slot_count = power_of_two;
+
+    posix::Fd_guard fd{::memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING)};
+    if (fd.fd() == -1)
+      throw Sys_exception{"cannot create shared memory"};
+    const auto size = mapping_size(slot_count, message_size);
+    if (::ftruncate(fd, static_cast<off_t>(size)))
+      throw Sys_exception{"cannot resize shared memory"};
+    if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL))
+      throw Sys_exception{"cannot seal shared memory"};
+
+    Basic_shm_ring result{std::move(fd), size};
+    auto* const header = new(result.mapping_.data()) Header;
+    header->magic = magic;
+    header->is_multi_producer = IsMultiProducer;
+    header->slot_count = slot_count;
+    header->message_size = message_size;
+    result.header_ = header;
+    return result;
+  }
+
+  /**
+   * @returns The ring attached via the descriptor `fd`.
+   *
+   * @throws `Sys_exception` or `std::runtime_error` on failure.
+   */
+  static Basic_shm_ring attach(posix::Fd_guard fd)
+  {
+    struct stat st{};
+    if (::fstat(fd, &st))
+      throw Sys_exception{"cannot get shared memory status"};
+    if (st.st_size < static_cast<off_t>(sizeof(Header)))
+      throw std::runtime_error{"invalid shared memory ring"};
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    Basic_shm_ring result{std::move(fd), size};
+    const auto* const header = static_cast<const Header*>(result.mapping_.data());
+    const auto slot_count = header->slot_count;
+    if (header->magic != magic ||
+      header->is_multi_producer != IsMultiProducer ||
+      !slot_count || (slot_count & (slot_count - 1)) ||
+      !header->message_size || header->message_size > UINT32_MAX ||
+      mapping_size(slot_count, header->message_size) != size)
+      throw std::runtime_error{"invalid shared memory ring"};
+    result.header_ = const_cast<Header*>(header);
+    result.cached_tail_ = header->tail.load(std::memory_order_acquire);
+    result.cached_head_ = header->head.load(std::memory_order_acquire);
+    return result;
+  }
+
+  /**
+   * @returns The ring attached via the `token` of the other process.
+   *
+   * @throws `Sys_exception` or `std::runtime_error` on failure.
+   */
+  static Basic_shm_ring attach(const Shm_ring_token& token)
+  {
+    return attach(detail::duplicate_fd(token.pid, token.fd));
+  }
+
+  /// @returns The descriptor of the shared memory.
+  int fd() const noexcept
+  {
+    return fd_.fd();
+  }
+
+  /**
+   * @returns The token to attach to this ring from the other process.
+   *
+   * @see `attach()`.
+   */
+  Shm_ring_token token() const noexcept
+  {
+    return {pid(), fd()};
+  }
+
+  /// @returns `true` if the instance is valid.
+  explicit operator bool() const noexcept
+  {
+    return header_;
+  }
+
+  /// @returns The number of slots.
+  std::size_t capacity() const noexcept
+  {
+    return header_->slot_count;
+  }
+
+  /// @returns The maximum size of the message.
+  std::size_t message_size() const noexcept
+  {
+    return header_->message_size;
+  }
+
+  /// @returns The approximate number of messages in the ring.
+  std::size_t size() const noexcept
+  {
+    const auto tail = header_->tail.load(std::memory_order_acquire);
+    const auto head = header_->head.load(std::memory_order_acquire);
+    return head > tail ? head - tail : 0;
+  }
+
+  /// @name Producer operations
+  /// @{
+
+  /**
+   * @brief Publishes the longest prefix of `messages` which fits into the free
+   * slots.
+   *
+   * @returns The number of messages published.
+   *
+   * @par Requires
+   * The size of each message must not exceed `message_size()`.
+   */
+  std::size_t try_publish(const std::string_view* const messages,
+    const std::size_t count)
+  {
+    for (std::size_t i{}; i < count; ++i) {
+      if (messages[i].size() > message_size())
+        throw std::invalid_argument{"message is too long for shared memory ring"};
+    }
+
+    const std::uint64_t slot_count{header_->slot_count};
+    std::uint64_t position;
+    std::size_t n;
+    if constexpr (IsMultiProducer) {
+      // Reserve the slots.
+      position = header_->head.load(std::memory_order_relaxed);
+      while (true) {
+        const auto tail = header_->tail.load(std::memory_order_acquire);
+        if (position < tail) {
+          position = header_->head.load(std::memory_order_relaxed);
+          continue;
+        }
+        n = std::min<std::uint64_t>(count, slot_count - (position - tail));
+        if (!n)
+          return 0;
+        else if (header_->head.compare_exchange_weak(position, position + n,
+            std::memory_order_relaxed))
+          break;
+      }
+    } else {
+      position = header_->head.load(std::memory_order_relaxed);
+      if (slot_count - (position - cached_tail_) < count)
+        cached_tail_ = header_->tail.load(std::memory_order_acquire);
+      n = std::min<std::uint64_t>(count, slot_count - (position - cached_tail_));
+      if (!n)
+        return 0;
+    }
+
+    for (std::size_t i{}; i < n; ++i) {
+      auto& slot = slot_at(position + i);
+      slot.size = static_cast<std::uint32_t>(messages[i].size());
+      std::memcpy(slot.payload(), messages[i].data(), messages[i].size());
+      if constexpr (IsMultiProducer)
+        slot.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    if constexpr (!IsMultiProducer)
+      header_->head.store(position + n, std::memory_order_release);
+
+    notify(header_->consumer_waiting, header_->data_futex, 1);
+    return n;
+  }
+
+  /// @overload
+  bool try_publish(const std::string_view message)
+  {
+    return try_publish(&message, 1);
+  }
+
+  /**
+   * @brief Publishes `messages` waiting for the free slots if necessary.
+   *
+   * @returns The number of messages published, which is less than `count`
+   * only on timeout.
+   */
+  std::size_t publish(const std::string_view* const messages,
+    const std::size_t count,
+    const std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+  {
+    std::size_t result{};
+    wait(header_->producers_waiting, header_->space_futex, timeout, [&]
+    {
+      result += try_publish(messages + result, count - result);
+      return result == count;
+    });
+    return result;
+  }
+
+  /// @overload
+  bool publish(const std::string_view message,
+    const std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+  {
+    return publish(&message, 1, timeout);
+  }
+
+  /// @}
+
+  /// @name Consumer operations
+  /// @{
+
+  /**
+   * @brief Consumes up to `max_count` messages available by calling
+   * `callback(std::string_view)` for each of them.
+   *
+   * @details The messages are released once the batch is processed, so the
+   * views passed to the `callback` are valid until it returns.
+   *
+   * @returns The number of messages consumed.
+   *
+   * @par Requires
+   * The `callback` must not throw.
+   */
+  template<typename F>
+  std::size_t try_consume(F&& callback,
+    const std::size_t max_count = std::numeric_limits<std::size_t>::max())
+  {
+    const auto position = header_->tail.load(std::memory_order_relaxed);
+    std::size_t n{};
+    if constexpr (IsMultiProducer) {
+      for (; n < max_count; ++n) {
+        const auto& slot = slot_at(position + n);
+        if (slot.sequence.load(std::memory_order_acquire) != position + n + 1)
+          break;
+        callback(std::string_view{slot.payload(), slot.size});
+      }
+    } else {
+      if (cached_head_ - position < max_count)
+        cached_head_ = header_->head.load(std::memory_order_acquire);
+      n = std::min<std::uint64_t>(max_count, cached_head_ - position);
+      for (std::size_t i{}; i < n; ++i) {
+        const auto& slot = slot_at(position + i);
+        callback(std::string_view{slot.payload(), slot.size});
+      }
+    }
+    if (n) {
+      header_->tail.store(position + n, std::memory_order_release);
+      notify(header_->producers_waiting, header_->space_futex, INT_MAX);
+    }
+    return n;
+  }
+
+  /**
+   * @brief Consumes up to `max_count` messages waiting for at least one if
+   * necessary.
+   *
+   * @returns The number of messages consumed, which is zero only on timeout.
+   *
+   * @see `try_consume()`.
+   */
+  template<typename F>
+  std::size_t consume(F&& callback,
+    const std::size_t max_count = std::numeric_limits<std::size_t>::max(),
+    const std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+  {
+    std::size_t result{};
+    wait(header_->consumer_waiting, header_->data_futex, timeout, [&]
+    {
+      return result = try_consume(callback, max_count);
+    });
+    return result;
+  }
+
+  /// @}
+
+private:
+  static constexpr std::uint64_t magic{0x676e6972'6d687364}; // "dshmring"
+
+  /// The header of the shared memory.
+  struct Header final {
+    std::uint64_t magic{};
+    std::uint64_t is_multi_producer{};
+    std::uint64_t slot_count{};
+    std::uint64_t message_size{};
+
+    alignas(detail::cache_line_size) std::atomic<std::uint64_t> head{};
+    alignas(detail::cache_line_size) std::atomic<std::uint64_t> tail{};
+    alignas(detail::cache_line_size) detail::Futex data_futex{};
+    std::atomic<std::uint32_t> consumer_waiting{};
+    alignas(detail::cache_line_size) detail::Futex space_futex{};
+    std::atomic<std::uint32_t> producers_waiting{};
+  };
+  static_assert(sizeof(Header) % detail::cache_line_size == 0);
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+  /// The slot.
+  struct Slot final {
+    std::atomic<std::uint64_t> sequence{};
+    std::uint32_t size{};
+
+    char* payload() noexcept
+    {
+      return reinterpret_cast<char*>(this + 1);
+    }
+
+    const char* payload() const noexcept
+    {
+      return reinterpret_cast<const char*>(this + 1);
+    }
+  };
+
+  posix::Fd_guard fd_;
+  posix::Mmap_guard mapping_;
+  Header* header_{};
+  std::uint64_t cached_tail_{};
+  std::uint64_t cached_head_{};
+
+  Basic_shm_ring(posix::Fd_guard fd, const std::size_t size)
+    : fd_{std::move(fd)}
+  {
+    void* const data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (data == MAP_FAILED)
+      throw Sys_exception{"cannot map shared memory"};
+    mapping_ = posix::Mmap_guard{data, size};
+  }
+
+  static std::size_t slot_size(const std::size_t message_size) noexcept
+  {
+    const auto size = sizeof(Slot) + message_size;
+    return (size + detail::cache_line_size - 1) / detail::cache_line_size *
+      detail::cache_line_size;
+  }
+
+  static std::size_t mapping_size(const std::size_t slot_count,
+    const std::size_t message_size) noexcept
+  {
+    return sizeof(Header) + slot_count * slot_size(message_size);
+  }
+
+  Slot& slot_at(const std::uint64_t position) const noexcept
+  {
+    auto* const slots = reinterpret_cast<char*>(header_ + 1);
+    const auto index = position & (header_->slot_count - 1);
+    return *reinterpret_cast<Slot*>(slots +
+      index * slot_size(header_->message_size));
+  }
+
+  /// Wakes up to `count` waiters if there are any.
+  static void notify(std::atomic<std::uint32_t>& waiting, detail::Futex& futex,
+    const int count) noexcept
+  {
+    // Pairs with the fence in wait() to not miss the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed)) {
+      futex.fetch_add(1, std::memory_order_release);
+      detail::futex_wake(futex, count);
+    }
+  }
+
+  /// Calls `try_operation` until it returns `true` or the `timeout` expires.
+  template<typename F>
+  static void wait(std::atomic<std::uint32_t>& waiting, detail::Futex& futex,
+    const std::chrono::nanoseconds timeout, F&& try_operation)
+  {
+    using Clock = std::chrono::steady_clock;
+    const bool is_infinite{timeout == std::chrono::nanoseconds::max()};
+    const auto deadline = is_infinite ? Clock::time_point::max() :
+      Clock::now() + timeout;
+    while (!try_operation()) {
+      const auto value = futex.load(std::memory_order_acquire);
+      waiting.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const bool is_done = try_operation();
+      if (!is_done) {
+        const auto now = Clock::now();
+        if (now < deadline)
+          detail::futex_wait(futex, value, is_infinite ?
+            std::chrono::nanoseconds::max() : deadline - now);
+      }
+      waiting.fetch_sub(1, std::memory_order_relaxed);
+      if (is_done || Clock::now() >= deadline)
+        break;
+    }
+  }
+};
+
+/// The single-producer/single-consumer shared memory ring.
+using Spsc_shm_ring = Basic_shm_ring<false>;
+
+/// The multi-producer/single-consumer shared memory ring.
+using Mpsc_shm_ring = Basic_shm_ring<true>;
+
+} // namespace dmitigr::os::ipc
+
+#endif  // DMITIGR_OS_IPC_RING_HPP
@@ -0,0 +1,559 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/ipc_socket.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_IPC_SOCKET_HPP
+#define DMITIGR_OS_IPC_SOCKET_HPP
+
+#include "exceptions.hpp"
+#include "ipc_pipe.hpp"
+#include "pid.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace dmitigr::os::ipc {
+
+/// A type of the Unix domain socket.
+enum class Unix_socket_type {
+  /// The connection-based byte stream.
+  stream = SOCK_STREAM,
+  /// The connection-based stream of messages with preserved boundaries.
+  seqpacket = SOCK_SEQPACKET,
+  /// The connectionless messages with preserved boundaries.
+  datagram = SOCK_DGRAM
+};
+
+/// The credentials of the process.
+struct Unix_credentials final {
+  /// The process identifier.
+  Pid pid{};
+  /// The user identifier.
+  ::uid_t uid{};
+  /// The group identifier.
+  ::gid_t gid{};
+};
+
+/// The result of receiving the message.
+struct Unix_received final {
+  /// The number of bytes received. (Zero denotes the end of stream.)
+  std::size_t size{};
+  /// The descriptors received (closed on `exec()`).
+  std::vector<posix::Fd_guard> fds;
+  /// The credentials of the sender if passing of them is enabled.
+  std::optional<Unix_credentials> credentials;
+  /// `true` if the message or the descriptors didn't fit and were discarded.
+  bool is_truncated{};
+};
+
+// -----------------------------------------------------------------------------
+// Unix_message_batch
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The preallocated buffers to receive the batch of messages.
+ *
+ * @see `Unix_socket::receive_batch()`.
+ */
+class Unix_message_batch final {
+public:
+  /// Constructs the batch of up to `capacity` messages of `message_size`.
+  Unix_message_batch(const std::size_t capacity, const std::size_t message_size)
+    : message_size_{message_size}
+    , buffer_(capacity * message_size)
+    , iovecs_(capacity)
+    , headers_(capacity)
+  {
+    for (std::size_t i{}; i < capacity; ++i) {
+      iovecs_[i] = {buffer_.data() + i * message_size, message_size};
+      headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+      headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  /// Non-copyable.
+  Unix_message_batch(const Unix_message_batch&) = delete;
+
+  /// Non-copyable.
+  Unix_message_batch& operator=(const Unix_message_batch&) = delete;
+
+  /// The move constructor.
+  Unix_message_batch(Unix_message_batch&&) = default;
+
+  /// The move assignment operator.
+  Unix_message_batch& operator=(Unix_message_batch&&) = default;
+
+  /// @returns The maximum number of messages.
+  std::size_t capacity() const noexcept
+  {
+    return headers_.size();
+  }
+
+  /// @returns The maximum size of the message.
+  std::size_t message_size() const noexcept
+  {
+    return message_size_;
+  }
+
+  /// @returns The number of messages received.
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /// @returns The message at `index`.
+  std::string_view operator[](const std::size_t index) const noexcept
+  {
+    return {static_cast<const char*>(iovecs_[index].iov_base),
+      headers_[index].msg_len};
+  }
+
+  /// @returns `true` if the message at `index` was truncated.
+  bool is_truncated(const std::size_t index) const noexcept
+  {
+    return headers_[index].msg_hdr.msg_flags & MSG_TRUNC;
+  }
+
+private:
+  friend class Unix_socket;
+
+  std::size_t message_size_{};
+  std::size_t size_{};
+  std::vector<char> buffer_;
+  std::vector<::iovec> iovecs_;
+  std::vector<::mmsghdr> headers_;
+};
+
+// -----------------------------------------------------------------------------
+// Unix_socket
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The Unix domain socket.
+ *
+ * @details The socket is closed on `exec()`. The operations on the
+ * nonblocking socket which would block return `std::nullopt`.
+ *
+ * The paths which start with '@' denote the names in the abstract namespace.
+ */
+class Unix_socket final {
+public:
+  /// The maximum number of descriptors which can be received at once.
+  static constexpr std::size_t max_fd_count{64};
+
+  /// Constructs the invalid instance.
+  Unix_socket() noexcept = default;
+
+  /// Constructs the instance which owns `fd`.
+  explicit Unix_socket(posix::Fd_guard fd) noexcept
+    : fd_{std::move(fd)}
+  {}
+
+  /**
+   * @returns The pair of connected sockets.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static std::pair<Unix_socket, Unix_socket> pair(
+    const Unix_socket_type type = Unix_socket_type::seqpacket)
+  {
+    int fds[2];
+    if (::socketpair(AF_UNIX, static_cast<int>(type) | SOCK_CLOEXEC, 0, fds))
+      throw Sys_exception{"cannot create socket pair"};
+    return {Unix_socket{posix::Fd_guard{fds[0]}},
+      Unix_socket{posix::Fd_guard{fds[1]}}};
+  }
+
+  /**
+   * @returns The socket bound to `path`.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Unix_socket bind(const std::string& path,
+    const Unix_socket_type type = Unix_socket_type::datagram)
+  {
+    auto result = make(type);
+    const auto [address, size] = to_address(path);
+    if (::bind(result.fd(), reinterpret_cast<const ::sockaddr*>(&address), size))
+      throw Sys_exception{"cannot bind socket to "+path};
+    return result;
+  }
+
+  /**
+   * @returns The socket listening on `path`.
+   *
+   * @par Requires
+   * `type != Unix_socket_type::datagram`.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Unix_socket listen(const std::string& path,
+    const Unix_socket_type type = Unix_socket_type::seqpacket,
+    const int backlog = SOMAXCONN)
+  {
+    auto result = bind(path, type);
+    if (::listen(result.fd(), backlog))
+      throw Sys_exception{"cannot listen on "+path};
+    return result;
+  }
+
+  /**
+   * @returns The socket connected to `path`.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Unix_socket connect(const std::string& path,
+    const Unix_socket_type type = Unix_socket_type::seqpacket)
+  {
+    auto result = make(type);
+    const auto [address, size] = to_address(path);
+    int err;
+    do {
+      err = ::connect(result.fd(), reinterpret_cast<const ::sockaddr*>(&address),
+        size) ? errno : 0;
+    } while (err == EINTR);
+    if (err)
+      throw Sys_exception{err, "cannot connect to "+path};
+    return result;
+  }
+
+  /**
+   * @returns The accepted connection, or `std::nullopt` if the operation
+   * would block.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::optional<Unix_socket> accept() const
+  {
+    while (true) {
+      const int fd = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd != -1)
+        return Unix_socket{posix::Fd_guard{fd}};
+      else if (errno == EAGAIN)
+        return std::nullopt;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot accept connection"};
+    }
+  }
+
+  /// @returns The descriptor.
+  int fd() const noexcept
+  {
+    return fd_.fd();
+  }
+
+  /// @returns `true` if the instance is valid.
+  explicit operator bool() const noexcept
+  {
+    return fd_.fd() != -1;
+  }
+
+  /// @returns The descriptor and releases the ownership of it.
+  posix::Fd_guard release() noexcept
+  {
+    return std::move(fd_);
+  }
+
+  /**
+   * @brief Sets or clears `O_NONBLOCK` of the socket.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  void set_nonblocking(const bool value = true)
+  {
+    ipc::set_nonblocking(fd_, value);
+  }
+
+  /// @name Credentials
+  /// @{
+
+  /**
+   * @brief Enables or disables the receiving of the credentials of the sender
+   * with each message (`SCM_CREDENTIALS`). The credentials are checked by the
+   * kernel, so they can't be forged by the unprivileged sender.
+   *
+   * @throws `Sys_exception` on failure.
+   *
+   * @see `Unix_received::credentials`.
+   */
+  void set_pass_credentials(const bool value = true)
+  {
+    const int option{value};
+    if (::setsockopt(fd_, SOL_SOCKET, SO_PASSCRED, &option, sizeof(option)))
+      throw Sys_exception{"cannot set SO_PASSCRED socket option"};
+  }
+
+  /**
+   * @returns The credentials of the peer as of the time of connection.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  Unix_credentials peer_credentials() const
+  {
+    ::ucred cred{};
+    ::socklen_t size{sizeof(cred)};
+    if (::getsockopt(fd_, SOL_SOCKET, SO_PEERCRED, &cred, &size))
+      throw Sys_exception{"cannot get SO_PEERCRED socket option"};
+    return {cred.pid, cred.uid, cred.gid};
+  }
+
+  /**
+   * @brief Checks that the peer is the process `pid`.
+   *
+   * @throws `std::runtime_error` if the peer is the other process.
+   */
+  void check_peer(const Pid pid) const
+  {
+    if (peer_credentials().pid != pid)
+      throw std::runtime_error{"unexpected peer process of Unix socket"};
+  }
+
+  /// @}
+
+  /// @name Single message transfer
+  /// @{
+
+  /**
+   * @brief Sends `data` along with `fd_count` descriptors `fds`
+   * (`SCM_RIGHTS`).
+   *
+   * @returns The number of bytes sent, or `std::nullopt` if the operation
+   * would block.
+   *
+   * @par Requires
+   * If `fd_count > 0` then `!data.empty()`.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::optional<std::size_t> send(const std::string_view data,
+    const int* const fds, const std::size_t fd_count) const
+  {
+    if (fd_count > max_fd_count)
+      throw std::invalid_argument{"too many descriptors to send"};
+
+    ::iovec iov{const_cast<char*>(data.data()), data.size()};
+    ::msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    Control control{};
+    if (fd_count) {
+      msg.msg_control = control.data;
+      msg.msg_controllen = CMSG_SPACE(fd_count * sizeof(int));
+      auto* const cmsg = CMSG_FIRSTHDR(&msg);
+      cmsg->cmsg_level = SOL_SOCKET;
+      cmsg->cmsg_type = SCM_RIGHTS;
+      cmsg->cmsg_len = CMSG_LEN(fd_count * sizeof(int));
+      std::memcpy(CMSG_DATA(cmsg), fds, fd_count * sizeof(int));
+    }
+    while (true) {
+      const auto result = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+      if (result >= 0)
+        return static_cast<std::size_t>(result);
+      else if (errno == EAGAIN)
+        return std::nullopt;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot send message"};
+    }
+  }
+
+  /// @overload
+  std::optional<std::size_t> send(const std::string_view data,
+    const std::vector<int>& fds = {}) const
+  {
+    return send(data, fds.data(), fds.size());
+  }
+
+  /**
+   * @brief Receives up to `size` bytes into `buf` along with the descriptors
+   * and the credentials of the sender if any.
+   *
+   * @returns The result, or `std::nullopt` if the operation would block.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::optional<Unix_received> receive(void* const buf,
+    const std::size_t size) const
+  {
+    ::iovec iov{buf, size};
+    ::msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    Control control{};
+    msg.msg_control = control.data;
+    msg.msg_controllen = sizeof(control.data);
+    ssize_t n;
+    while (true) {
+      n = ::recvmsg(fd_, &msg, MSG_CMSG_CLOEXEC);
+      if (n >= 0)
+        break;
+      else if (errno == EAGAIN)
+        return std::nullopt;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot receive message"};
+    }
+
+    Unix_received result;
+    result.size = static_cast<std::size_t>(n);
+    result.is_truncated = msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC);
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level != SOL_SOCKET)
+        continue;
+      else if (cmsg->cmsg_type == SCM_RIGHTS) {
+        const auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t i{}; i < count; ++i) {
+          int fd;
+          std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+          result.fds.emplace_back(fd);
+        }
+      } else if (cmsg->cmsg_type == SCM_CREDENTIALS) {
+        ::ucred cred;
+        std::memcpy(&cred, CMSG_DATA(cmsg), sizeof(cred));
+        result.credentials = Unix_credentials{cred.pid, cred.uid, cred.gid};
+      }
+    }
+    return result;
+  }
+
+  /// @}
+
+  /// @name Batched transfer
+  /// @{
+
+  /**
+   * @brief Sends up to `count` `messages` by as few `sendmmsg()` calls as
+   * possible.
+   *
+   * @details The message boundaries are preserved only by the sockets of type
+   * `Unix_socket_type::seqpacket` and `Unix_socket_type::datagram`.
+   *
+   * @returns The number of messages sent, which may be less than `count` only
+   * if the socket is nonblocking.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::size_t send_batch(const std::string_view* const messages,
+    const std::size_t count) const
+  {
+    constexpr std::size_t chunk_size{64};
+    std::array<::iovec, chunk_size> iovecs;
+    std::array<::mmsghdr, chunk_size> headers;
+    std::size_t result{};
+    while (result < count) {
+      const auto n = std::min(count - result, chunk_size);
+      for (std::size_t i{}; i < n; ++i) {
+        const auto& message = messages[result + i];
+        iovecs[i] = {const_cast<char*>(message.data()), message.size()};
+        headers[i] = {};
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+      }
+      const int sent = ::sendmmsg(fd_, headers.data(), static_cast<unsigned>(n),
+        MSG_NOSIGNAL);
+      if (sent > 0)
+        result += sent;
+      else if (!sent || errno == EAGAIN)
+        break;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot send messages"};
+    }
+    return result;
+  }
+
+  /**
+   * @brief Receives up to `batch.capacity()` messages into `batch` by the one
+   * `recvmmsg()` call, waiting for the first message only.
+   *
+   * @returns The number of messages received (also available as
+   * `batch.size()`), or `std::nullopt` if the operation would block.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::optional<std::size_t> receive_batch(Unix_message_batch& batch) const
+  {
+    batch.size_ = 0;
+    for (auto& header : batch.headers_)
+      header.msg_len = 0;
+    while (true) {
+      const int n = ::recvmmsg(fd_, batch.headers_.data(),
+        static_cast<unsigned>(batch.headers_.size()), MSG_WAITFORONE, nullptr);
+      if (n >= 0)
+        return batch.size_ = static_cast<std::size_t>(n);
+      else if (errno == EAGAIN)
+        return std::nullopt;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot receive messages"};
+    }
+  }
+
+  /// @}
+
+private:
+  /// The buffer of the ancillary data.
+  union Control {
+    char data[CMSG_SPACE(max_fd_count * sizeof(int)) +
+      CMSG_SPACE(sizeof(::ucred))];
+    ::cmsghdr alignment;
+  };
+
+  posix::Fd_guard fd_;
+
+  static Unix_socket make(const Unix_socket_type type)
+  {
+    posix::Fd_guard result{::socket(AF_UNIX,
+        static_cast<int>(type) | SOCK_CLOEXEC, 0)};
+    if (result.fd() == -1)
+      throw Sys_exception{"cannot create socket"};
+    return Unix_socket{std::move(result)};
+  }
+
+  static std::pair<::sockaddr_un, ::socklen_t> to_address(
+    const std::string& path)
+  {
+    ::sockaddr_un result{};
+    result.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(result.sun_path))
+      throw std::invalid_argument{"invalid Unix socket path "+path};
+    std::memcpy(result.sun_path, path.data(), path.size());
+    const bool is_abstract{path.front() == '@'};
+    if (is_abstract)
+      result.sun_path[0] = '\0';
+    return {result, static_cast<::socklen_t>(offsetof(::sockaddr_un, sun_path) +
+        path.size() + !is_abstract)};
+  }
+};
+
+} // namespace dmitigr::os::ipc
+
+#endif  // DMITIGR_OS_IPC_SOCKET_HPP
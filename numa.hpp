@@ -0,0 +1,369 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/numa.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_NUMA_HPP
+#define DMITIGR_OS_NUMA_HPP
+
+#include "../base/assert.hpp"
+#include "cpu.hpp"
+#include "exceptions.hpp"
+#include "posix.hpp"
+
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace dmitigr::os {
+
+/// A NUMA memory policy.
+enum class Numa_policy {
+  /// Allocate on the given nodes, or on the other ones if they are exhausted.
+  preferred = MPOL_PREFERRED,
+  /// Allocate only on the given nodes.
+  bind = MPOL_BIND,
+  /// Allocate page by page round-robin across the given nodes.
+  interleave = MPOL_INTERLEAVE
+};
+
+namespace detail {
+
+/// The maximum number of NUMA nodes supported.
+constexpr std::size_t max_numa_node_count{1024};
+
+/// The mask of NUMA nodes in the format of the kernel.
+using Numa_node_mask = std::array<unsigned long,
+  max_numa_node_count / (sizeof(unsigned long) * CHAR_BIT)>;
+
+/// @returns The mask of `nodes`.
+inline Numa_node_mask to_numa_node_mask(const std::vector<unsigned>& nodes)
+  noexcept
+{
+  constexpr std::size_t bits{sizeof(unsigned long) * CHAR_BIT};
+  Numa_node_mask result{};
+  for (const auto node : nodes) {
+    DMITIGR_ASSERT(node < max_numa_node_count);
+    result[node / bits] |= 1ul << (node % bits);
+  }
+  return result;
+}
+
+/// @returns The result of mbind(2) for the page-aligned range.
+inline long mbind(void* const addr, const std::size_t size,
+  const Numa_policy policy, const std::vector<unsigned>& nodes,
+  const unsigned flags) noexcept
+{
+  // Extend the range to the page boundaries.
+  const auto page = posix::page_size();
+  const auto begin = reinterpret_cast<std::uintptr_t>(addr) / page * page;
+  const auto end = reinterpret_cast<std::uintptr_t>(addr) + size;
+  const auto mask = to_numa_node_mask(nodes);
+  // Note: the kernel ignores the last bit of the mask.
+  return ::syscall(SYS_mbind, begin, end - begin, static_cast<int>(policy),
+    mask.data(), max_numa_node_count + 1, flags);
+}
+
+/**
+ * @returns The nodes to which the policy is applied, or the empty vector if
+ * NUMA policies are unsupported (`ENOSYS`) or forbidden (`EPERM`, as in the
+ * containers without `CAP_SYS_NICE`). If the `nodes` are invalid (as on the
+ * single node system), the policy is applied to the node `0` instead.
+ *
+ * @throws `Sys_exception` on other failure.
+ */
+inline std::vector<unsigned> mbind_or_fallback(void* const addr,
+  const std::size_t size, const Numa_policy policy,
+  const std::vector<unsigned>& nodes)
+{
+  if (!mbind(addr, size, policy, nodes, 0))
+    return nodes;
+  else if (errno == ENOSYS || errno == EPERM)
+    return {};
+  else if (errno == EINVAL && nodes != std::vector<unsigned>{0} &&
+    !mbind(addr, size, policy, {0}, 0))
+    return {0};
+  throw Sys_exception{"cannot set NUMA memory policy"};
+}
+
+} // namespace detail
+
+/**
+ * @returns The NUMA nodes which have memory, or `{0}` if the system doesn't
+ * report them.
+ */
+inline std::vector<unsigned> numa_memory_nodes()
+{
+  const auto list = detail::read_sysfs("/sys/devices/system/node/has_memory");
+  auto result = list ? detail::to_cpu_list(*list) : std::nullopt;
+  return result && !result->empty() ? std::move(*result) :
+    std::vector<unsigned>{0};
+}
+
+/**
+ * @brief Sets the memory `policy` for the `nodes` to the range of `size`
+ * bytes at `addr`, which is extended to the page boundaries.
+ *
+ * @param move Whether to migrate the already allocated pages of the range.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline void numa_bind(void* const addr, const std::size_t size,
+  const Numa_policy policy, const std::vector<unsigned>& nodes,
+  const bool move = false)
+{
+  if (detail::mbind(addr, size, policy, nodes, move ? MPOL_MF_MOVE : 0))
+    throw Sys_exception{"cannot set NUMA memory policy"};
+}
+
+/**
+ * @returns The NUMA nodes of the `pages`: non-negative values denote the
+ * nodes, negative values denote the errors (for example, `-ENOENT` if the
+ * page is not allocated yet).
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::vector<int> numa_nodes_of(const std::vector<const void*>& pages)
+{
+  std::vector<int> result(pages.size());
+  if (::syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr,
+      result.data(), 0))
+    throw Sys_exception{"cannot get NUMA nodes of pages"};
+  return result;
+}
+
+/**
+ * @returns The NUMA node of the page which contains `addr`, or
+ * `std::nullopt` if the page is not allocated yet.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline std::optional<unsigned> numa_node_of(const void* const addr)
+{
+  const auto result = numa_nodes_of({addr})[0];
+  return result >= 0 ? std::make_optional(static_cast<unsigned>(result)) :
+    std::nullopt;
+}
+
+// -----------------------------------------------------------------------------
+// Numa_memory
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A memory mapping with NUMA policy.
+ *
+ * @details The pages are allocated according to the policy on the first
+ * access.
+ */
+class Numa_memory final {
+public:
+  /// Constructs an empty instance.
+  Numa_memory() = default;
+
+  /**
+   * @brief Maps `size` bytes with the `policy` for the `nodes`.
+   *
+   * @details The NUMA policy is applied as much as the system allows: if
+   * the `nodes` are invalid, the node `0` is used instead, and if NUMA
+   * policies are unsupported, the memory is left unbound.
+   *
+   * @throws `Sys_exception` on failure.
+   *
+   * @see `nodes()`.
+   */
+  Numa_memory(const std::size_t size, const Numa_policy policy,
+    const std::vector<unsigned>& nodes)
+    : mapping_{posix::mmap_anonymous(size)}
+    , policy_{policy}
+    , nodes_{detail::mbind_or_fallback(mapping_.data(), size, policy, nodes)}
+  {}
+
+  /// @returns The address of the memory.
+  void* data() const noexcept
+  {
+    return mapping_.data();
+  }
+
+  /// @returns The size of the memory.
+  std::size_t size() const noexcept
+  {
+    return mapping_.size();
+  }
+
+  /// @returns `true` if the instance owns the memory.
+  explicit operator bool() const noexcept
+  {
+    return static_cast<bool>(mapping_);
+  }
+
+  /// @returns The policy.
+  Numa_policy policy() const noexcept
+  {
+    return policy_;
+  }
+
+  /**
+   * @returns The nodes to which the policy is actually applied, or the empty
+   * vector if the memory is not bound.
+   */
+  const std::vector<unsigned>& nodes() const noexcept
+  {
+    return nodes_;
+  }
+
+  /// @returns `true` if the policy is applied.
+  bool is_bound() const noexcept
+  {
+    return !nodes_.empty();
+  }
+
+private:
+  posix::Mmap_guard mapping_;
+  Numa_policy policy_{Numa_policy::bind};
+  std::vector<unsigned> nodes_;
+};
+
+/**
+ * @returns The memory of `size` bytes allocated on the NUMA `node`.
+ *
+ * @param policy Either `Numa_policy::bind` or `Numa_policy::preferred`.
+ *
+ * @see `Numa_memory`.
+ */
+inline Numa_memory numa_allocate_on_node(const std::size_t size,
+  const unsigned node, const Numa_policy policy = Numa_policy::bind)
+{
+  DMITIGR_ASSERT(policy != Numa_policy::interleave);
+  return Numa_memory{size, policy, {node}};
+}
+
+/**
+ * @returns The memory of `size` bytes interleaved across the NUMA `nodes`.
+ *
+ * @see `Numa_memory`.
+ */
+inline Numa_memory numa_allocate_interleaved(const std::size_t size,
+  const std::vector<unsigned>& nodes = numa_memory_nodes())
+{
+  return Numa_memory{size, Numa_policy::interleave, nodes};
+}
+
+// -----------------------------------------------------------------------------
+// Numa_memory_resource
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The memory resource which allocates with NUMA policy.
+ *
+ * @details Each allocation is a separate mapping of the whole number of
+ * pages, so this resource is intended to be the upstream of either
+ * `std::pmr::monotonic_buffer_resource` or the pool resources for the
+ * containers of small objects.
+ */
+class Numa_memory_resource final : public std::pmr::memory_resource {
+public:
+  /// Constructs the resource which allocates on the NUMA `node`.
+  explicit Numa_memory_resource(const unsigned node,
+    const Numa_policy policy = Numa_policy::bind)
+    : Numa_memory_resource{policy, {node}}
+  {}
+
+  /// Constructs the resource which allocates with `policy` for the `nodes`.
+  Numa_memory_resource(const Numa_policy policy, std::vector<unsigned> nodes)
+    : policy_{policy}
+    , nodes_{std::move(nodes)}
+  {}
+
+  /// @returns The policy.
+  Numa_policy policy() const noexcept
+  {
+    return policy_;
+  }
+
+  /// @returns The nodes.
+  const std::vector<unsigned>& nodes() const noexcept
+  {
+    return nodes_;
+  }
+
+private:
+  Numa_policy policy_{Numa_policy::bind};
+  std::vector<unsigned> nodes_;
+
+  static std::size_t round_up(const std::size_t size) noexcept
+  {
+    const auto page = posix::page_size();
+    return (std::max(size, std::size_t{1}) + page - 1) / page * page;
+  }
+
+  void* do_allocate(const std::size_t bytes, const std::size_t alignment) override
+  {
+    const auto size = round_up(bytes);
+    const auto page = posix::page_size();
+    const auto extra = alignment > page ? alignment : 0;
+    posix::Mmap_guard mapping;
+    try {
+      mapping = posix::mmap_anonymous(size + extra);
+    } catch (const Sys_exception&) {
+      throw std::bad_alloc{};
+    }
+
+    // Trim the mapping to the alignment.
+    auto* const begin = static_cast<char*>(mapping.data());
+    auto* const result = begin + (extra ?
+      (alignment - reinterpret_cast<std::uintptr_t>(begin) % alignment) %
+      alignment : 0);
+    mapping.release();
+    if (result != begin)
+      ::munmap(begin, result - begin);
+    if (const auto tail = extra - (result - begin))
+      ::munmap(result + size, tail);
+    mapping = posix::Mmap_guard{result, size};
+
+    detail::mbind_or_fallback(result, size, policy_, nodes_);
+    return mapping.release();
+  }
+
+  void do_deallocate(void* const p, const std::size_t bytes,
+    const std::size_t) override
+  {
+    ::munmap(p, round_up(bytes));
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    const auto* const rhs = dynamic_cast<const Numa_memory_resource*>(&other);
+    return rhs && rhs->policy_ == policy_ && rhs->nodes_ == nodes_;
+  }
+};
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_NUMA_HPP
@@ -18,15 +18,26 @@
 #define DMITIGR_OS_OS_HPP
 
 #include "types_fwd.hpp"
+#include "cpu.hpp"
 #include "environment.hpp"
 #include "error.hpp"
 #include "exceptions.hpp"
-#include "ipc_pipe.hpp"
 #include "last_error.hpp"
 #include "pid.hpp"
 #include "version.hpp"
 #ifdef _WIN32
 #include "windows.hpp"
 #endif
+#ifdef __linux__
+#include "affinity.hpp"
+#include "hugepages.hpp"
+#include "io.hpp"
+#include "ipc_pipe.hpp"
+#include "ipc_ring.hpp"
+#include "ipc_socket.hpp"
+#include "numa.hpp"
+#include "process.hpp"
+#include "process_sampler.hpp"
+#endif
 
 #endif  // DMITIGR_OS_OS_HPP
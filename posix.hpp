@@ -0,0 +1,310 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef _WIN32
+#error dmitigr/os/posix.hpp is not usable on Microsoft Windows!
+#endif
+
+#ifndef DMITIGR_OS_POSIX_HPP
+#define DMITIGR_OS_POSIX_HPP
+
+#include "exceptions.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace dmitigr::os::posix {
+
+/// A very thin wrapper around the file descriptor.
+struct Fd_guard final {
+  /// The destructor.
+  ~Fd_guard()
+  {
+    if (!close())
+      std::fprintf(stderr, "%s: error %d\n", "close", errno);
+  }
+
+  /// The constructor.
+  explicit Fd_guard(const int fd = -1) noexcept
+    : fd_{fd}
+  {}
+
+  /// Non-copyable.
+  Fd_guard(const Fd_guard&) = delete;
+
+  /// Non-copyable.
+  Fd_guard& operator=(const Fd_guard&) = delete;
+
+  /// The move constructor.
+  Fd_guard(Fd_guard&& rhs) noexcept
+    : fd_{rhs.fd_}
+  {
+    rhs.fd_ = -1;
+  }
+
+  /// The move assignment operator.
+  Fd_guard& operator=(Fd_guard&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Fd_guard tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Fd_guard& other) noexcept
+  {
+    std::swap(fd_, other.fd_);
+  }
+
+  /// @returns The guarded descriptor.
+  int fd() const noexcept
+  {
+    return fd_;
+  }
+
+  /// @returns The guarded descriptor.
+  operator int() const noexcept
+  {
+    return fd();
+  }
+
+  /// @returns The guarded descriptor and releases the ownership of it.
+  int release() noexcept
+  {
+    return std::exchange(fd_, -1);
+  }
+
+  /// @returns `true` on success, or `false` otherwise.
+  bool close() noexcept
+  {
+    bool result{true};
+    if (fd_ != -1) {
+      result = !::close(fd_);
+      // The descriptor is released even on failure, since retrying is unsafe.
+      fd_ = -1;
+    }
+    return result;
+  }
+
+private:
+  int fd_{-1};
+};
+
+/// A very thin wrapper around the memory mapping.
+struct Mmap_guard final {
+  /// The destructor.
+  ~Mmap_guard()
+  {
+    if (!unmap())
+      std::fprintf(stderr, "%s: error %d\n", "munmap", errno);
+  }
+
+  /// Constructs the empty guard.
+  Mmap_guard() noexcept = default;
+
+  /// The constructor.
+  Mmap_guard(void* const data, const std::size_t size) noexcept
+    : data_{data}
+    , size_{size}
+  {}
+
+  /// Non-copyable.
+  Mmap_guard(const Mmap_guard&) = delete;
+
+  /// Non-copyable.
+  Mmap_guard& operator=(const Mmap_guard&) = delete;
+
+  /// The move constructor.
+  Mmap_guard(Mmap_guard&& rhs) noexcept
+    : data_{std::exchange(rhs.data_, nullptr)}
+    , size_{std::exchange(rhs.size_, 0)}
+  {}
+
+  /// The move assignment operator.
+  Mmap_guard& operator=(Mmap_guard&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Mmap_guard tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Mmap_guard& other) noexcept
+  {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+  }
+
+  /// @returns The address of the mapping.
+  void* data() const noexcept
+  {
+    return data_;
+  }
+
+  /// @returns The size of the mapping.
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /// @returns `true` if the guard owns the mapping.
+  explicit operator bool() const noexcept
+  {
+    return data_;
+  }
+
+  /// @returns The address of the mapping and releases the ownership of it.
+  void* release() noexcept
+  {
+    size_ = 0;
+    return std::exchange(data_, nullptr);
+  }
+
+  /// @returns `true` on success, or `false` otherwise.
+  bool unmap() noexcept
+  {
+    bool result{true};
+    if (data_) {
+      result = !::munmap(data_, size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+    return result;
+  }
+
+private:
+  void* data_{};
+  std::size_t size_{};
+};
+
+/**
+ * @returns The anonymous private mapping of `size` bytes.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline Mmap_guard mmap_anonymous(const std::size_t size, const int flags = 0,
+  const int prot = PROT_READ | PROT_WRITE)
+{
+  void* const result = ::mmap(nullptr, size, prot,
+    MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  if (result == MAP_FAILED)
+    throw Sys_exception{"cannot map memory"};
+  return Mmap_guard{result, size};
+}
+
+/// @returns The size of the memory page.
+inline std::size_t page_size() noexcept
+{
+  static const auto result = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return result;
+}
+
+/**
+ * @returns The descriptor of the file opened at `path`.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+inline Fd_guard open(const std::string& path, const int flags = O_RDONLY)
+{
+  Fd_guard result{::open(path.c_str(), flags | O_CLOEXEC)};
+  if (result.fd() == -1)
+    throw Sys_exception{"cannot open "+path};
+  return result;
+}
+
+/**
+ * @brief Reads up to `size` bytes of `fd` at `offset` into `buf`.
+ *
+ * @details Unlike `pread()` this function retries on interrupts and short
+ * reads until either `size` bytes are read or the end of file is reached.
+ *
+ * @returns The number of bytes read, or `-1` on error.
+ */
+inline ssize_t pread_full(const int fd, void* const buf, const std::size_t size,
+  const off_t offset = 0) noexcept
+{
+  std::size_t result{};
+  while (result < size) {
+    const auto n = ::pread(fd, static_cast<char*>(buf) + result, size - result,
+      offset + static_cast<off_t>(result));
+    if (n > 0)
+      result += n;
+    else if (!n)
+      break;
+    else if (errno != EINTR)
+      return -1;
+  }
+  return static_cast<ssize_t>(result);
+}
+
+/**
+ * @brief Appends the content of the file `fd` to `buf`.
+ *
+ * @details If `fstat()` reports the size of the file (as for regular files and
+ * binary files of sysfs), the buffer is resized once and exactly that many
+ * bytes are read. Otherwise (as for files of procfs), the file is read until
+ * the end with the growing buffer.
+ *
+ * @returns The number of bytes appended.
+ *
+ * @throws `Sys_exception` on failure.
+ */
+template<class Container>
+std::size_t read_all(const int fd, Container& buf)
+{
+  struct stat st{};
+  if (::fstat(fd, &st))
+    throw Sys_exception{"cannot get file status"};
+
+  const std::size_t offset{buf.size()};
+  std::size_t size{};
+  std::size_t capacity = st.st_size > 0 ?
+    static_cast<std::size_t>(st.st_size) : 4096;
+  while (true) {
+    buf.resize(offset + capacity);
+    const auto n = pread_full(fd, buf.data() + offset + size, capacity - size,
+      static_cast<off_t>(size));
+    if (n < 0) {
+      const int err = errno;
+      buf.resize(offset);
+      throw Sys_exception{err, "cannot read file"};
+    }
+    size += n;
+    if (size < capacity || st.st_size > 0)
+      break;
+    capacity *= 2;
+  }
+  buf.resize(offset + size);
+  return size;
+}
+
+} // namespace dmitigr::os::posix
+
+#endif  // DMITIGR_OS_POSIX_HPP
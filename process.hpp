@@ -0,0 +1,792 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/process.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_PROCESS_HPP
+#define DMITIGR_OS_PROCESS_HPP
+
+#include "environment.hpp"
+#include "exceptions.hpp"
+#include "ipc_pipe.hpp"
+#include "pid.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace dmitigr::os {
+
+/// A disposition of the standard stream of the child process.
+enum class Stdio {
+  /// The stream is inherited from the parent.
+  inherit,
+  /// The stream is connected to the pipe.
+  pipe,
+  /// The stream is connected to `/dev/null`.
+  null
+};
+
+/// Options of the process spawning.
+struct Process_options final {
+  /// The path to the executable.
+  std::string path;
+
+  /// The arguments including `argv[0]`. If empty, `path` is used as `argv[0]`.
+  std::vector<std::string> arguments;
+
+  /**
+   * The environment. If `nullptr`, the environment of the running process
+   * is inherited.
+   *
+   * @see `Environment_builder`.
+   */
+  const Environment_block* environment{};
+
+  /**
+   * The working directory. If empty, the working directory of the running
+   * process is inherited.
+   */
+  std::string working_directory;
+
+  /// Whether to search `path` in `PATH` if it doesn't contain a slash.
+  bool is_path_searched{true};
+
+  /// Whether to place the child process into the new process group.
+  bool is_new_process_group{};
+
+  /// The disposition of the standard input.
+  Stdio input{Stdio::inherit};
+
+  /// The disposition of the standard output.
+  Stdio output{Stdio::inherit};
+
+  /// The disposition of the standard error.
+  Stdio error{Stdio::inherit};
+};
+
+/// A termination status of the process.
+struct Process_exit final {
+  /// The exit code, or `-1` if the process is terminated by the signal.
+  int code{-1};
+
+  /// The terminating signal, or `0` if the process exited normally.
+  int signal{};
+
+  /// @returns `true` if the process exited with code `0`.
+  bool is_success() const noexcept
+  {
+    return !signal && !code;
+  }
+};
+
+namespace detail {
+
+#ifdef P_PIDFD
+constexpr ::idtype_t p_pidfd{P_PIDFD};
+#else
+constexpr ::idtype_t p_pidfd{static_cast<::idtype_t>(3)};
+#endif
+
+/// @returns The pidfd of the process `pid`, or invalid guard if not supported.
+inline posix::Fd_guard pidfd_open(const Pid pid)
+{
+#ifdef SYS_pidfd_open
+  posix::Fd_guard result{static_cast<int>(::syscall(SYS_pidfd_open, pid, 0))};
+  if (result.fd() == -1 && errno != ENOSYS)
+    throw Sys_exception{"cannot open pidfd of process "+std::to_string(pid)};
+  return result;
+#else
+  (void)pid;
+  return posix::Fd_guard{};
+#endif
+}
+
+/// @returns The termination status from the `info` filled by `waitid()`.
+inline Process_exit to_process_exit(const ::siginfo_t& info) noexcept
+{
+  Process_exit result;
+  if (info.si_code == CLD_EXITED)
+    result.code = info.si_status;
+  else
+    result.signal = info.si_status;
+  return result;
+}
+
+/// The spawner of the processes with the same options.
+class Spawner final {
+public:
+  ~Spawner()
+  {
+    ::posix_spawnattr_destroy(&attr_);
+  }
+
+  Spawner(const Spawner&) = delete;
+  Spawner& operator=(const Spawner&) = delete;
+  Spawner(Spawner&&) = delete;
+  Spawner& operator=(Spawner&&) = delete;
+
+  explicit Spawner(const Process_options& options)
+    : options_{options}
+  {
+    if (options_.path.empty())
+      throw std::invalid_argument{"cannot spawn process: empty path"};
+
+    argv_.reserve(std::max<std::size_t>(options_.arguments.size(), 1) + 1);
+    if (options_.arguments.empty())
+      argv_.push_back(const_cast<char*>(options_.path.c_str()));
+    else {
+      for (const auto& arg : options_.arguments)
+        argv_.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv_.push_back(nullptr);
+
+    if (const int err = ::posix_spawnattr_init(&attr_))
+      throw Sys_exception{err, "cannot initialize process spawn attributes"};
+    try {
+      // Since glibc 2.24 posix_spawn() is implemented via clone(CLONE_VM |
+      // CLONE_VFORK), so page tables of the parent are never copied. The
+      // child starts with the empty signal mask and default dispositions.
+      short flags{POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF};
+      if (options_.is_new_process_group)
+        flags |= POSIX_SPAWN_SETPGROUP;
+      check(::posix_spawnattr_setflags(&attr_, flags));
+      ::sigset_t signals;
+      ::sigemptyset(&signals);
+      check(::posix_spawnattr_setsigmask(&attr_, &signals));
+      ::sigfillset(&signals);
+      check(::posix_spawnattr_setsigdefault(&attr_, &signals));
+      check(::posix_spawnattr_setpgroup(&attr_, 0));
+    } catch (...) {
+      ::posix_spawnattr_destroy(&attr_);
+      throw;
+    }
+  }
+
+  /**
+   * @returns The PID of the spawned process.
+   *
+   * @param pipes The pipes to connect to the standard streams of the child.
+   * The caller must close the child ends after spawning.
+   */
+  Pid spawn(ipc::Pipe (&pipes)[3]) const
+  {
+    const Stdio dispositions[] = {options_.input, options_.output,
+      options_.error};
+    File_actions actions;
+    for (int fd{}; fd < 3; ++fd) {
+      const bool is_input = !fd;
+      switch (dispositions[fd]) {
+      case Stdio::inherit:
+        break;
+      case Stdio::pipe:
+        pipes[fd] = ipc::Pipe::make();
+        check(::posix_spawn_file_actions_adddup2(&actions.value,
+            is_input ? pipes[fd].reader() : pipes[fd].writer(), fd));
+        break;
+      case Stdio::null:
+        check(::posix_spawn_file_actions_addopen(&actions.value, fd,
+            "/dev/null", is_input ? O_RDONLY : O_WRONLY, 0));
+        break;
+      }
+    }
+    if (!options_.working_directory.empty()) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 29)
+      check(::posix_spawn_file_actions_addchdir_np(&actions.value,
+          options_.working_directory.c_str()));
+#else
+      throw std::runtime_error{"cannot spawn process: changing the working"
+        " directory is not supported"};
+#endif
+    }
+
+    Pid result{-1};
+    const auto spawn = options_.is_path_searched ? &::posix_spawnp :
+      &::posix_spawn;
+    int err{};
+    if (options_.environment) {
+      err = spawn(&result, options_.path.c_str(), &actions.value, &attr_,
+        argv_.data(), options_.environment->envp());
+    } else {
+      const std::shared_lock lock{environment_mutex()};
+      err = spawn(&result, options_.path.c_str(), &actions.value, &attr_,
+        argv_.data(), environ);
+    }
+    if (err)
+      throw Sys_exception{err, "cannot spawn process "+options_.path};
+    return result;
+  }
+
+private:
+  struct File_actions final {
+    ::posix_spawn_file_actions_t value;
+
+    ~File_actions()
+    {
+      ::posix_spawn_file_actions_destroy(&value);
+    }
+
+    File_actions()
+    {
+      if (const int err = ::posix_spawn_file_actions_init(&value))
+        throw Sys_exception{err, "cannot initialize process file actions"};
+    }
+
+    File_actions(const File_actions&) = delete;
+    File_actions& operator=(const File_actions&) = delete;
+    File_actions(File_actions&&) = delete;
+    File_actions& operator=(File_actions&&) = delete;
+  };
+
+  const Process_options& options_;
+  std::vector<char*> argv_;
+  ::posix_spawnattr_t attr_;
+
+  static void check(const int err)
+  {
+    if (err)
+      throw Sys_exception{err, "cannot prepare process spawning"};
+  }
+};
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Process_handle
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A very thin wrapper around the pidfd (Linux 5.3+).
+ *
+ * @details Unlike the PID, the pidfd always refers to the same process, so
+ * the signals cannot be delivered to the wrong process after PID reuse. The
+ * pidfd becomes readable when the process terminates, so the termination of
+ * any number of processes (not only children) can be watched by `epoll` or
+ * `io::Engine::wait_readable()` without `SIGCHLD` handling.
+ */
+struct Process_handle final {
+  /// The destructor.
+  ~Process_handle()
+  {
+    if (!close())
+      std::fprintf(stderr, "%s: error %d\n", "close", errno);
+  }
+
+  /// The constructor.
+  explicit Process_handle(const int fd = -1) noexcept
+    : fd_{fd}
+  {}
+
+  /**
+   * @returns The handle of the process `pid`.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Process_handle open(const Pid pid)
+  {
+    auto result = detail::pidfd_open(pid);
+    if (result.fd() == -1)
+      throw Sys_exception{ENOSYS, "cannot open pidfd of process "
+        +std::to_string(pid)};
+    return Process_handle{result.release()};
+  }
+
+  /// Non-copyable.
+  Process_handle(const Process_handle&) = delete;
+
+  /// Non-copyable.
+  Process_handle& operator=(const Process_handle&) = delete;
+
+  /// The move constructor.
+  Process_handle(Process_handle&& rhs) noexcept
+    : fd_{rhs.fd_}
+  {
+    rhs.fd_ = -1;
+  }
+
+  /// The move assignment operator.
+  Process_handle& operator=(Process_handle&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Process_handle tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Process_handle& other) noexcept
+  {
+    std::swap(fd_, other.fd_);
+  }
+
+  /// @returns The guarded pidfd.
+  int fd() const noexcept
+  {
+    return fd_;
+  }
+
+  /// @returns The guarded pidfd.
+  operator int() const noexcept
+  {
+    return fd();
+  }
+
+  /// @returns `true` if the handle is valid.
+  explicit operator bool() const noexcept
+  {
+    return fd_ != -1;
+  }
+
+  /// @returns The guarded pidfd and releases the ownership of it.
+  int release() noexcept
+  {
+    return std::exchange(fd_, -1);
+  }
+
+  /// @returns `true` on success, or `false` otherwise.
+  bool close() noexcept
+  {
+    bool result{true};
+    if (fd_ != -1) {
+      result = !::close(fd_);
+      // The descriptor is released even on failure, since retrying is unsafe.
+      fd_ = -1;
+    }
+    return result;
+  }
+
+  /**
+   * @returns The PID of the process in the PID namespace of the running
+   * process, `0` if the process is in the other namespace, or `-1` if the
+   * process is reaped.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  Pid pid() const
+  {
+    const auto path = "/proc/self/fdinfo/" + std::to_string(fd_);
+    std::string info;
+    posix::read_all(posix::open(path), info);
+    if (const auto pos = info.find("\nPid:"); pos != std::string::npos)
+      return static_cast<Pid>(std::strtol(info.c_str() + pos + 5, nullptr, 10));
+    throw Sys_exception{EINVAL, "cannot get PID from "+path};
+  }
+
+  /**
+   * @brief Sends the `signal` to the process.
+   *
+   * @returns `false` if the process is already terminated.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  bool send_signal(const int signal) const
+  {
+#ifdef SYS_pidfd_send_signal
+    if (!::syscall(SYS_pidfd_send_signal, fd_, signal, nullptr, 0))
+      return true;
+    else if (errno == ESRCH)
+      return false;
+#else
+    errno = ENOSYS;
+#endif
+    throw Sys_exception{"cannot send signal via pidfd"};
+  }
+
+  /**
+   * @returns The duplicate of the descriptor `fd` of the process (Linux 5.6+).
+   *
+   * @remarks Requires the permission to `ptrace()` the process.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  posix::Fd_guard getfd(const int fd) const
+  {
+#ifdef SYS_pidfd_getfd
+    posix::Fd_guard result{static_cast<int>(
+        ::syscall(SYS_pidfd_getfd, fd_, fd, 0))};
+    if (result.fd() != -1)
+      return result;
+#else
+    (void)fd;
+    errno = ENOSYS;
+#endif
+    throw Sys_exception{"cannot get descriptor via pidfd"};
+  }
+
+  /// @returns `true` if the process is terminated.
+  bool is_terminated() const
+  {
+    return wait_termination(std::chrono::milliseconds::zero());
+  }
+
+  /**
+   * @returns `true` if the process is terminated within `timeout`.
+   *
+   * @remarks Doesn't reap the process.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  bool wait_termination(const std::chrono::milliseconds timeout =
+    std::chrono::milliseconds::max()) const
+  {
+    namespace chrono = std::chrono;
+    const bool is_infinite = timeout == chrono::milliseconds::max();
+    const auto deadline = is_infinite ? chrono::steady_clock::time_point::max() :
+      chrono::steady_clock::now() + timeout;
+    while (true) {
+      const auto remaining = is_infinite ? -1 :
+        std::clamp<chrono::milliseconds::rep>(
+          chrono::ceil<chrono::milliseconds>(deadline -
+            chrono::steady_clock::now()).count(),
+          0, std::numeric_limits<int>::max());
+      ::pollfd pfd{fd_, POLLIN, 0};
+      const int n = ::poll(&pfd, 1, static_cast<int>(remaining));
+      if (n >= 0)
+        return n > 0;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot poll pidfd"};
+    }
+  }
+
+private:
+  int fd_{-1};
+};
+
+/**
+ * @brief A child process.
+ *
+ * @details Processes are spawned by `posix_spawn()`, which never copies the
+ * page tables of the parent (glibc uses `clone(CLONE_VM | CLONE_VFORK)`), so
+ * spawning cost doesn't depend on the size of the parent. The child is waited
+ * via pidfd when supported by the kernel (Linux 5.4+), so there is no race
+ * with PID reuse.
+ *
+ * @remarks The destructor neither kills nor reaps the child process.
+ *
+ * @remarks The child must not be reaped by someone else (for example, by
+ * setting `SIGCHLD` to `SIG_IGN`).
+ */
+class Process final {
+public:
+  /// Constructs the invalid instance.
+  Process() noexcept = default;
+
+  /// Non-copyable.
+  Process(const Process&) = delete;
+
+  /// Non-copyable.
+  Process& operator=(const Process&) = delete;
+
+  /// The move constructor.
+  Process(Process&& rhs) noexcept
+    : pid_{std::exchange(rhs.pid_, -1)}
+    , handle_{std::move(rhs.handle_)}
+    , input_{std::move(rhs.input_)}
+    , output_{std::move(rhs.output_)}
+    , error_{std::move(rhs.error_)}
+    , exit_{std::exchange(rhs.exit_, std::nullopt)}
+  {}
+
+  /// The move assignment operator.
+  Process& operator=(Process&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Process tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Process& other) noexcept
+  {
+    using std::swap;
+    swap(pid_, other.pid_);
+    handle_.swap(other.handle_);
+    input_.swap(other.input_);
+    output_.swap(other.output_);
+    error_.swap(other.error_);
+    swap(exit_, other.exit_);
+  }
+
+  /**
+   * @returns The spawned process.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static Process spawn(const Process_options& options)
+  {
+    const detail::Spawner spawner{options};
+    return spawn(spawner);
+  }
+
+  /**
+   * @returns The `count` processes spawned with the same `options`.
+   *
+   * @details The options are prepared once for all the processes. If any
+   * process cannot be spawned, the processes spawned so far are killed and
+   * reaped.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  static std::vector<Process> spawn(const Process_options& options,
+    const std::size_t count)
+  {
+    const detail::Spawner spawner{options};
+    std::vector<Process> result;
+    result.reserve(count);
+    try {
+      for (std::size_t i{}; i < count; ++i)
+        result.push_back(spawn(spawner));
+    } catch (...) {
+      for (auto& process : result)
+        process.kill_and_reap();
+      throw;
+    }
+    return result;
+  }
+
+  /// @returns `true` if the instance is valid.
+  explicit operator bool() const noexcept
+  {
+    return pid_ != -1;
+  }
+
+  /// @returns The PID of the process.
+  Pid pid() const noexcept
+  {
+    return pid_;
+  }
+
+  /**
+   * @returns The handle of the process, which is invalid if pidfd is not
+   * supported by the kernel.
+   */
+  const Process_handle& handle() const noexcept
+  {
+    return handle_;
+  }
+
+  /// @returns The write end of the pipe connected to the standard input.
+  posix::Fd_guard& input() noexcept
+  {
+    return input_;
+  }
+
+  /// @returns The read end of the pipe connected to the standard output.
+  posix::Fd_guard& output() noexcept
+  {
+    return output_;
+  }
+
+  /// @returns The read end of the pipe connected to the standard error.
+  posix::Fd_guard& error() noexcept
+  {
+    return error_;
+  }
+
+  /**
+   * @brief Sends the `signal` to the process.
+   *
+   * @returns `false` if the process is already reaped.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  bool send_signal(const int signal)
+  {
+    check_valid();
+    if (exit_)
+      return false;
+    if (handle_)
+      return handle_.send_signal(signal);
+    else if (::kill(pid_, signal))
+      throw Sys_exception{"cannot send signal to process "+std::to_string(pid_)};
+    return true;
+  }
+
+  /**
+   * @returns The termination status if the process is terminated, or
+   * `std::nullopt` otherwise.
+   *
+   * @par Effects
+   * Reaps the terminated process.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::optional<Process_exit> try_wait()
+  {
+    return wait_status(WNOHANG);
+  }
+
+  /**
+   * @returns The termination status.
+   *
+   * @par Effects
+   * Waits for termination of the process and reaps it.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  Process_exit wait()
+  {
+    return *wait_status(0);
+  }
+
+  /**
+   * @returns The termination status, or `std::nullopt` if the process is not
+   * terminated within `timeout`.
+   *
+   * @par Effects
+   * Reaps the terminated process.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  std::optional<Process_exit> wait(const std::chrono::milliseconds timeout)
+  {
+    namespace chrono = std::chrono;
+    check_valid();
+    if (exit_ || timeout == chrono::milliseconds::max())
+      return wait();
+    else if (handle_)
+      return handle_.wait_termination(timeout) ? try_wait() : std::nullopt;
+
+    // Fallback for kernels without pidfd.
+    const auto deadline = chrono::steady_clock::now() + timeout;
+    auto delay = chrono::microseconds{50};
+    while (true) {
+      if (const auto result = try_wait())
+        return result;
+      const auto now = chrono::steady_clock::now();
+      if (now >= deadline)
+        return std::nullopt;
+      std::this_thread::sleep_for(std::min<chrono::steady_clock::duration>(
+          delay, deadline - now));
+      delay = std::min(delay * 2, chrono::microseconds{10'000});
+    }
+  }
+
+  /**
+   * @returns The termination status if the process is reaped, or
+   * `std::nullopt` otherwise.
+   */
+  const std::optional<Process_exit>& exit() const noexcept
+  {
+    return exit_;
+  }
+
+private:
+  Pid pid_{-1};
+  Process_handle handle_;
+  posix::Fd_guard input_;
+  posix::Fd_guard output_;
+  posix::Fd_guard error_;
+  std::optional<Process_exit> exit_;
+
+  static Process spawn(const detail::Spawner& spawner)
+  {
+    ipc::Pipe pipes[3];
+    Process result;
+    result.pid_ = spawner.spawn(pipes);
+    result.input_ = pipes[0].release_writer();
+    result.output_ = pipes[1].release_reader();
+    result.error_ = pipes[2].release_reader();
+    for (auto& pipe : pipes) // close the child ends
+      pipe = ipc::Pipe{};
+    try {
+      result.handle_ = Process_handle{detail::pidfd_open(result.pid_).release()};
+    } catch (...) {
+      result.kill_and_reap();
+      throw;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Kills and reaps the process ignoring errors.
+   *
+   * @details Used for cleanup on spawn failure, so that the original
+   * exception is never replaced.
+   */
+  void kill_and_reap() noexcept
+  {
+    if (pid_ == -1 || exit_)
+      return;
+    ::kill(pid_, SIGKILL);
+    while (::waitpid(pid_, nullptr, 0) == -1 && errno == EINTR);
+  }
+
+  void check_valid() const
+  {
+    if (pid_ == -1)
+      throw std::logic_error{"invalid process instance"};
+  }
+
+  std::optional<Process_exit> wait_status(const int options)
+  {
+    check_valid();
+    if (exit_)
+      return exit_;
+
+    ::siginfo_t info{};
+    while (true) {
+      int r{-1};
+      if (handle_) {
+        r = ::waitid(detail::p_pidfd, static_cast<::id_t>(handle_.fd()), &info,
+          WEXITED | options);
+        if (r && errno == EINVAL)
+          r = ::waitid(P_PID, static_cast<::id_t>(pid_), &info, WEXITED | options);
+      } else
+        r = ::waitid(P_PID, static_cast<::id_t>(pid_), &info, WEXITED | options);
+      if (!r)
+        break;
+      else if (errno != EINTR)
+        throw Sys_exception{"cannot wait for process "+std::to_string(pid_)};
+    }
+    if (!info.si_pid)
+      return std::nullopt; // WNOHANG and still running
+
+    exit_ = detail::to_process_exit(info);
+    return exit_;
+  }
+};
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_PROCESS_HPP
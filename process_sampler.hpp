@@ -0,0 +1,459 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __linux__
+#error dmitigr/os/process_sampler.hpp is usable only on Linux!
+#endif
+
+#ifndef DMITIGR_OS_PROCESS_SAMPLER_HPP
+#define DMITIGR_OS_PROCESS_SAMPLER_HPP
+
+#include "exceptions.hpp"
+#include "pid.hpp"
+#include "posix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dmitigr::os {
+
+/// The sample of the resource usage of the process.
+struct Process_sample final {
+  /// The time of sampling.
+  std::chrono::steady_clock::time_point time;
+
+  /// @name CPU (`/proc/<pid>/stat`, `/proc/<pid>/schedstat`)
+  /// @{
+
+  /// The time spent in the user mode.
+  std::chrono::nanoseconds user_time{};
+  /// The time spent in the kernel mode.
+  std::chrono::nanoseconds system_time{};
+  /// The time spent on the CPU (more precise than the above ones).
+  std::chrono::nanoseconds run_time{};
+  /// The time spent waiting on the run queue.
+  std::chrono::nanoseconds wait_time{};
+  /// The number of voluntary context switches.
+  std::uint64_t voluntary_switches{};
+  /// The number of involuntary context switches.
+  std::uint64_t involuntary_switches{};
+  /// The number of threads.
+  std::uint64_t thread_count{};
+
+  /// @}
+
+  /// @name Memory (`/proc/<pid>/stat`, `/proc/<pid>/statm`)
+  /// @{
+
+  /// The number of minor page faults.
+  std::uint64_t minor_faults{};
+  /// The number of major page faults.
+  std::uint64_t major_faults{};
+  /// The size of the virtual memory in bytes.
+  std::uint64_t virtual_size{};
+  /// The resident set size (RSS) in bytes.
+  std::uint64_t resident_size{};
+  /// The size of the resident shared (file-backed and shmem) pages in bytes.
+  std::uint64_t shared_size{};
+  /// The proportional set size (PSS) in bytes if requested.
+  std::optional<std::uint64_t> proportional_size;
+
+  /// @}
+
+  /// @name I/O (`/proc/<pid>/io`)
+  /// @{
+
+  /// `true` if the I/O statistics are accessible.
+  bool has_io{};
+  /// The number of bytes passed to `read()` and similar calls.
+  std::uint64_t read_chars{};
+  /// The number of bytes passed to `write()` and similar calls.
+  std::uint64_t write_chars{};
+  /// The number of read system calls.
+  std::uint64_t read_syscalls{};
+  /// The number of write system calls.
+  std::uint64_t write_syscalls{};
+  /// The number of bytes fetched from the storage.
+  std::uint64_t read_bytes{};
+  /// The number of bytes sent to the storage.
+  std::uint64_t write_bytes{};
+  /// The number of bytes which were not written due to truncation.
+  std::uint64_t cancelled_write_bytes{};
+
+  /// @}
+};
+
+namespace detail {
+
+/// The non-allocating parser of the files of procfs.
+class Proc_parser final {
+public:
+  explicit Proc_parser(const std::string_view text) noexcept
+    : text_{text}
+  {}
+
+  /// @returns The next space-separated unsigned number, or `0` on error.
+  std::uint64_t next() noexcept
+  {
+    skip_spaces();
+    std::uint64_t result{};
+    for (; pos_ < text_.size() && is_digit(text_[pos_]); ++pos_)
+      result = result * 10 + (text_[pos_] - '0');
+    skip_field();
+    return result;
+  }
+
+  /// Skips `count` space-separated fields.
+  void skip(std::size_t count) noexcept
+  {
+    while (count--) {
+      skip_spaces();
+      skip_field();
+    }
+  }
+
+  /// Moves after the last occurrence of `c` (or to the end).
+  void seek_after_last(const char c) noexcept
+  {
+    const auto p = text_.rfind(c);
+    pos_ = p != std::string_view::npos ? p + 1 : text_.size();
+  }
+
+  /**
+   * @returns The number which follows `key` followed by ':' at the beginning
+   * of the line, or `std::nullopt` if there is no such key.
+   */
+  std::optional<std::uint64_t> value(const std::string_view key) noexcept
+  {
+    for (std::size_t p{}; p < text_.size();) {
+      const auto eol = std::min(text_.find('\n', p), text_.size());
+      if (eol - p > key.size() && text_.compare(p, key.size(), key) == 0 &&
+        text_[p + key.size()] == ':') {
+        pos_ = p + key.size() + 1;
+        return next();
+      }
+      p = eol + 1;
+    }
+    return std::nullopt;
+  }
+
+private:
+  std::string_view text_;
+  std::size_t pos_{};
+
+  static bool is_digit(const char c) noexcept
+  {
+    return '0' <= c && c <= '9';
+  }
+
+  static bool is_space(const char c) noexcept
+  {
+    return c == ' ' || c == '\t' || c == '\n';
+  }
+
+  void skip_spaces() noexcept
+  {
+    for (; pos_ < text_.size() && is_space(text_[pos_]); ++pos_);
+  }
+
+  void skip_field() noexcept
+  {
+    for (; pos_ < text_.size() && !is_space(text_[pos_]); ++pos_);
+  }
+};
+
+/// Parses the content of `/proc/<pid>/stat` into `sample`.
+inline void parse_proc_stat(const std::string_view text,
+  Process_sample& sample) noexcept
+{
+  static const auto tick = std::chrono::nanoseconds{std::chrono::seconds{1}} /
+    ::sysconf(_SC_CLK_TCK);
+  Proc_parser parser{text};
+  // The command name (2) may contain spaces and parentheses.
+  parser.seek_after_last(')');
+  parser.skip(7); // 3-9
+  sample.minor_faults = parser.next(); // 10
+  parser.skip(1);
+  sample.major_faults = parser.next(); // 12
+  parser.skip(1);
+  sample.user_time = tick * parser.next(); // 14
+  sample.system_time = tick * parser.next(); // 15
+  parser.skip(4); // 16-19
+  sample.thread_count = parser.next(); // 20
+}
+
+/// Parses the content of `/proc/<pid>/statm` into `sample`.
+inline void parse_proc_statm(const std::string_view text,
+  Process_sample& sample) noexcept
+{
+  const auto page = posix::page_size();
+  Proc_parser parser{text};
+  sample.virtual_size = parser.next() * page;
+  sample.resident_size = parser.next() * page;
+  sample.shared_size = parser.next() * page;
+}
+
+/// Parses the content of `/proc/<pid>/schedstat` into `sample`.
+inline void parse_proc_schedstat(const std::string_view text,
+  Process_sample& sample) noexcept
+{
+  Proc_parser parser{text};
+  sample.run_time = std::chrono::nanoseconds(parser.next());
+  sample.wait_time = std::chrono::nanoseconds(parser.next());
+}
+
+/// Parses the content of `/proc/<pid>/io` into `sample`.
+inline void parse_proc_io(const std::string_view text,
+  Process_sample& sample) noexcept
+{
+  Proc_parser parser{text};
+  sample.read_chars = parser.value("rchar").value_or(0);
+  sample.write_chars = parser.value("wchar").value_or(0);
+  sample.read_syscalls = parser.value("syscr").value_or(0);
+  sample.write_syscalls = parser.value("syscw").value_or(0);
+  sample.read_bytes = parser.value("read_bytes").value_or(0);
+  sample.write_bytes = parser.value("write_bytes").value_or(0);
+  sample.cancelled_write_bytes =
+    parser.value("cancelled_write_bytes").value_or(0);
+}
+
+/// Parses the content of `/proc/<pid>/status` into `sample`.
+inline void parse_proc_status(const std::string_view text,
+  Process_sample& sample) noexcept
+{
+  Proc_parser parser{text};
+  sample.voluntary_switches =
+    parser.value("voluntary_ctxt_switches").value_or(0);
+  sample.involuntary_switches =
+    parser.value("nonvoluntary_ctxt_switches").value_or(0);
+}
+
+/// Parses the content of `/proc/<pid>/smaps_rollup` into `sample`.
+inline void parse_proc_smaps_rollup(const std::string_view text,
+  Process_sample& sample) noexcept
+{
+  Proc_parser parser{text};
+  if (const auto kb = parser.value("Pss"))
+    sample.proportional_size = *kb * 1024;
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Process_sampler
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The sampler of the resource usage of the process.
+ *
+ * @details The files of procfs are opened once and reread by `pread()` into
+ * the buffer of the sampler, which are parsed without memory allocations.
+ * The descriptors of procfs are bound to the process rather than to the
+ * identifier, so the sampler never reports the data of the other process
+ * which reused the identifier.
+ *
+ * @remarks Each sampler holds up to six descriptors.
+ */
+class Process_sampler final {
+public:
+  /// The options.
+  struct Options final {
+    /// Whether to sample the context switches (`/proc/<pid>/status`).
+    bool context_switches{true};
+    /**
+     * Whether to sample the PSS (`/proc/<pid>/smaps_rollup`), which is
+     * costly for the kernel for the processes with large address space.
+     */
+    bool proportional_size{false};
+  };
+
+  /**
+   * @brief Opens the files of procfs of the process `pid` and takes the first
+   * sample.
+   *
+   * @details The inaccessible optional files (for example, `io` of the process
+   * of the other user) are not sampled.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  explicit Process_sampler(const Pid pid, const Options options)
+    : pid_{pid}
+  {
+    const auto dir = "/proc/" + std::to_string(pid) + "/";
+    stat_ = posix::open(dir + "stat");
+    statm_ = posix::open(dir + "statm");
+    schedstat_ = open_optional(dir + "schedstat");
+    io_ = open_optional(dir + "io");
+    if (options.context_switches)
+      status_ = open_optional(dir + "status");
+    if (options.proportional_size)
+      smaps_rollup_ = open_optional(dir + "smaps_rollup");
+    if (!update())
+      throw Sys_exception{ESRCH, "cannot sample process "+std::to_string(pid)};
+    previous_ = current_;
+  }
+
+  /// @overload
+  explicit Process_sampler(const Pid pid)
+    : Process_sampler{pid, Options{}}
+  {}
+
+  /// @returns The process identifier.
+  Pid pid() const noexcept
+  {
+    return pid_;
+  }
+
+  /**
+   * @brief Takes the next sample.
+   *
+   * @returns `false` if the process no longer exists, or `true` otherwise.
+   *
+   * @throws `Sys_exception` on failure.
+   */
+  bool update()
+  {
+    Process_sample sample;
+    sample.time = std::chrono::steady_clock::now();
+    if (!read(stat_, sample, detail::parse_proc_stat) ||
+      !read(statm_, sample, detail::parse_proc_statm) ||
+      !read(schedstat_, sample, detail::parse_proc_schedstat) ||
+      !read(status_, sample, detail::parse_proc_status) ||
+      !read(smaps_rollup_, sample, detail::parse_proc_smaps_rollup))
+      return false;
+    if (io_.fd() != -1) {
+      // The access to the I/O statistics is checked on each read.
+      const auto n = posix::pread_full(io_, buffer_.data(), buffer_.size());
+      if (n >= 0) {
+        detail::parse_proc_io({buffer_.data(), static_cast<std::size_t>(n)},
+          sample);
+        sample.has_io = true;
+      } else if (errno == ESRCH)
+        return false;
+      else if (errno != EACCES && errno != EPERM)
+        throw Sys_exception{"cannot read I/O statistics of process "+
+          std::to_string(pid_)};
+    }
+    previous_ = current_;
+    current_ = sample;
+    return true;
+  }
+
+  /// @returns The last sample.
+  const Process_sample& current() const noexcept
+  {
+    return current_;
+  }
+
+  /// @returns The sample preceding the last one.
+  const Process_sample& previous() const noexcept
+  {
+    return previous_;
+  }
+
+  /**
+   * @returns The difference between the last two samples: the cumulative
+   * counters (times, faults, switches and I/O) are subtracted, and the gauges
+   * (sizes and thread count) are of the last sample.
+   */
+  Process_sample delta() const noexcept
+  {
+    const auto& c = current_;
+    const auto& p = previous_;
+    const auto sub = [](const auto a, const auto b)
+    {
+      return a > b ? a - b : decltype(a){};
+    };
+    Process_sample result{c};
+    result.user_time = sub(c.user_time, p.user_time);
+    result.system_time = sub(c.system_time, p.system_time);
+    result.run_time = sub(c.run_time, p.run_time);
+    result.wait_time = sub(c.wait_time, p.wait_time);
+    result.voluntary_switches = sub(c.voluntary_switches, p.voluntary_switches);
+    result.involuntary_switches = sub(c.involuntary_switches,
+      p.involuntary_switches);
+    result.minor_faults = sub(c.minor_faults, p.minor_faults);
+    result.major_faults = sub(c.major_faults, p.major_faults);
+    result.read_chars = sub(c.read_chars, p.read_chars);
+    result.write_chars = sub(c.write_chars, p.write_chars);
+    result.read_syscalls = sub(c.read_syscalls, p.read_syscalls);
+    result.write_syscalls = sub(c.write_syscalls, p.write_syscalls);
+    result.read_bytes = sub(c.read_bytes, p.read_bytes);
+    result.write_bytes = sub(c.write_bytes, p.write_bytes);
+    result.cancelled_write_bytes = sub(c.cancelled_write_bytes,
+      p.cancelled_write_bytes);
+    return result;
+  }
+
+  /// @returns The interval between the last two samples.
+  std::chrono::steady_clock::duration interval() const noexcept
+  {
+    return current_.time - previous_.time;
+  }
+
+private:
+  Pid pid_{};
+  posix::Fd_guard stat_;
+  posix::Fd_guard statm_;
+  posix::Fd_guard schedstat_;
+  posix::Fd_guard io_;
+  posix::Fd_guard status_;
+  posix::Fd_guard smaps_rollup_;
+  std::array<char, 4096> buffer_;
+  Process_sample current_;
+  Process_sample previous_;
+
+  static posix::Fd_guard open_optional(const std::string& path)
+  {
+    posix::Fd_guard result{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (result.fd() == -1 && errno != ENOENT && errno != EACCES &&
+      errno != EPERM)
+      throw Sys_exception{"cannot open "+path};
+    return result;
+  }
+
+  /// @returns `false` if the process no longer exists.
+  template<typename F>
+  bool read(const posix::Fd_guard& fd, Process_sample& sample, F&& parse)
+  {
+    if (fd.fd() == -1)
+      return true;
+    const auto n = posix::pread_full(fd, buffer_.data(), buffer_.size());
+    if (n < 0) {
+      if (errno == ESRCH)
+        return false;
+      throw Sys_exception{"cannot read procfs file of process "+
+        std::to_string(pid_)};
+    }
+    parse(std::string_view{buffer_.data(), static_cast<std::size_t>(n)},
+      sample);
+    return true;
+  }
+};
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_PROCESS_SAMPLER_HPP
@@ -19,11 +19,12 @@
 
 #include "../base/assert.hpp"
 #include "../base/rnd.hpp"
-#include "../base/stream.hpp"
 #include "../base/traits.hpp"
 #include "error.hpp"
 #ifdef _WIN32
 #include "../winbase/exceptions.hpp"
+#else
+#include "posix.hpp"
 #endif
 
 #include <algorithm>
@@ -31,20 +32,24 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <filesystem>
+#include <iterator>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
-#ifdef __linux__
-#include <fstream>
-#endif
 
 namespace dmitigr::os::firmware {
 
-class Smbios_table final {
+// -----------------------------------------------------------------------------
+// Smbios_view
+// -----------------------------------------------------------------------------
+
+/// A non-owning view of SMBIOS table.
+class Smbios_view final {
 public:
   using Byte = std::uint8_t;
   using Word = std::uint16_t;
@@ -73,365 +78,435 @@ public:
   };
   static_assert(std::is_standard_layout_v<Structure>);
 
-  struct Bios_info final : Structure {
-    std::optional<std::string> vendor;
-    std::optional<std::string> version;
-    std::optional<std::string> release_date;
-    Byte rom_size{};
+  /// Structure type.
+  enum class Structure_type : Byte {
+    bios_information = 0,
+    system_information = 1,
+    baseboard_information = 2,
+    system_enclosure = 3,
+    processor_information = 4,
+    memory_controller_information = 5,
+    memory_module_information = 6,
+    cache_information = 7,
+    port_connector_information = 8,
+    system_slots = 9,
+    on_board_devices_information = 10,
+    oem_strings = 11,
+    system_configuration_options = 12,
+    bios_language_information = 13,
+    group_associations = 14,
+    system_event_log = 15,
+    physical_memory_array = 16,
+    memory_device = 17,
+    memory_error_information_32 = 18,
+    memory_array_mapped_address = 19,
+    memory_device_mapped_address = 20,
+    built_in_pointing_device = 21,
+    portable_battery = 22,
+    system_reset = 23,
+    hardware_security = 24,
+    system_power_controls = 25,
+    voltage_probe = 26,
+    cooling_device = 27,
+    temperature_probe = 28,
+    electrical_current_probe = 29,
+    out_of_band_remote_access = 30,
+    boot_integrity_services_entry_point = 31,
+    system_boot_information = 32,
+    memory_error_information_64 = 33,
+    management_device = 34,
+    management_device_component = 35,
+    management_device_threshold_data = 36,
+    memory_channel = 37,
+    ipmi_device_information = 38,
+    system_power_supply = 39,
+    additional_information = 40,
+    onboard_devices_extended_information = 41,
+    management_controller_host_interface = 42,
+    tpm_device = 43,
+    processor_additional_information = 44,
+    firmware_inventory_information = 45,
+    string_property = 46,
+    inactive = 126,
+    end_of_table = 127
   };
 
-  struct Sys_info final : Structure {
-    std::optional<std::string> manufacturer;
-    std::optional<std::string> product;
-    std::optional<std::string> version;
-    std::optional<std::string> serial_number;
-    rnd::Uuid uuid{};
+  /// Processor type.
+  enum class Processor_type : Byte {
+    Unspecified = 0x00,
+    Other [[maybe_unused]] = 0x01,
+    Unknown [[maybe_unused]] = 0x02,
+    CentralProcessor [[maybe_unused]] = 0x03,
+    MathProcessor [[maybe_unused]] = 0x04,
+    DspProcessor [[maybe_unused]] = 0x05,
+    VideoProcessor [[maybe_unused]] = 0x06
   };
 
-  struct Baseboard_info final : Structure {
-    std::optional<std::string> manufacturer;
-    std::optional<std::string> product;
-    std::optional<std::string> version;
-    std::optional<std::string> serial_number;
+  /// Processor upgrade.
+  enum class Processor_upgrade : Byte {
+    Unspecified = 0x00,
+    Other [[maybe_unused]] = 0x01,
+    Unknown [[maybe_unused]] = 0x02,
+    DaughterBoard [[maybe_unused]] = 0x03,
+    ZIFSocket [[maybe_unused]] = 0x04,
+    ReplaceablePiggyBack [[maybe_unused]] = 0x05,
+    None [[maybe_unused]] = 0x06,
+    LIFSocket [[maybe_unused]] = 0x07,
+    Slot1 [[maybe_unused]] = 0x08,
+    Slot2 [[maybe_unused]] = 0x09,
+    Pin370Socket [[maybe_unused]] = 0x0A,
+    SlotA [[maybe_unused]] = 0x0B,
+    SlotM [[maybe_unused]] = 0x0C,
+    Socket423 [[maybe_unused]] = 0x0D,
+    SocketA [[maybe_unused]] = 0x0E,
+    Socket478 [[maybe_unused]] = 0x0F,
+    Socket754 [[maybe_unused]] = 0x10,
+    Socket940 [[maybe_unused]] = 0x11,
+    Socket939 [[maybe_unused]] = 0x12,
+    SocketmPGA604 [[maybe_unused]] = 0x13,
+    SocketLGA771 [[maybe_unused]] = 0x14,
+    SocketLGA775 [[maybe_unused]] = 0x15,
+    SocketS1 [[maybe_unused]] = 0x16,
+    SocketAM2 [[maybe_unused]] = 0x17,
+    SocketF [[maybe_unused]] = 0x18,
+    SocketLGA1366 [[maybe_unused]] = 0x19,
+    SocketG34 [[maybe_unused]] = 0x1A,
+    SocketAM3 [[maybe_unused]] = 0x1B,
+    SocketC32 [[maybe_unused]] = 0x1C,
+    SocketLGA1156 [[maybe_unused]] = 0x1D,
+    SocketLGA1567 [[maybe_unused]] = 0x1E,
+    SocketPGA988A [[maybe_unused]] = 0x1F,
+    SocketBGA1288 [[maybe_unused]] = 0x20,
+    SocketrPGA988B [[maybe_unused]] = 0x21,
+    SocketBGA1023 [[maybe_unused]] = 0x22,
+    SocketBGA1224 [[maybe_unused]] = 0x23,
+    SocketLGA1155 [[maybe_unused]] = 0x24,
+    SocketLGA1356 [[maybe_unused]] = 0x25,
+    SocketLGA2011 [[maybe_unused]] = 0x26,
+    SocketFS1 [[maybe_unused]] = 0x27,
+    SocketFS2 [[maybe_unused]] = 0x28,
+    SocketFM1 [[maybe_unused]] = 0x29,
+    SocketFM2 [[maybe_unused]] = 0x2A,
+    SocketLGA2011_3 [[maybe_unused]] = 0x2B,
+    SocketLGA1356_3 [[maybe_unused]] = 0x2C,
+    SocketLGA1150 [[maybe_unused]] = 0x2D,
+    SocketBGA1168 [[maybe_unused]] = 0x2E,
+    SocketBGA1234 [[maybe_unused]] = 0x2F,
+    SocketBGA1364 [[maybe_unused]] = 0x30,
+    SocketAM4 [[maybe_unused]] = 0x31,
+    SocketLGA1151 [[maybe_unused]] = 0x32,
+    SocketBGA1356 [[maybe_unused]] = 0x33,
+    SocketBGA1440 [[maybe_unused]] = 0x34,
+    SocketBGA1515 [[maybe_unused]] = 0x35,
+    SocketLGA3647_1 [[maybe_unused]] = 0x36,
+    SocketSP3 [[maybe_unused]] = 0x37,
+    SocketSP3r2 [[maybe_unused]] = 0x38,
+    SocketLGA2066 [[maybe_unused]] = 0x39,
+    SocketBGA1392 [[maybe_unused]] = 0x3A,
+    SocketBGA1510 [[maybe_unused]] = 0x3B,
+    SocketBGA1528 [[maybe_unused]] = 0x3C,
+    SocketLGA4189 [[maybe_unused]] = 0x3D,
+    SocketLGA1200 [[maybe_unused]] = 0x3E,
+    SocketLGA4677 [[maybe_unused]] = 0x3F,
+    SocketLGA1700 [[maybe_unused]] = 0x40,
+    SocketBGA1744 [[maybe_unused]] = 0x41,
+    SocketBGA1781 [[maybe_unused]] = 0x42,
+    SocketBGA1211 [[maybe_unused]] = 0x43,
+    SocketBGA2422 [[maybe_unused]] = 0x44,
+    SocketLGA1211 [[maybe_unused]] = 0x45,
+    SocketLGA2422 [[maybe_unused]] = 0x46,
+    SocketLGA5773 [[maybe_unused]] = 0x47,
+    SocketBGA5773 [[maybe_unused]] = 0x48
   };
 
-  struct Processor_info final : Structure {
-    enum class Type : Byte {
-      Unspecified = 0x00,
-      Other [[maybe_unused]] = 0x01,
-      Unknown [[maybe_unused]] = 0x02,
-      CentralProcessor [[maybe_unused]] = 0x03,
-      MathProcessor [[maybe_unused]] = 0x04,
-      DspProcessor [[maybe_unused]] = 0x05,
-      VideoProcessor [[maybe_unused]] = 0x06
-    };
+  /// Processor family.
+  enum class Processor_family : Word {
+    Unspecified = 0x00,
+    // indicator for Processor_info::processor_family
+    // just use Processor_info::processor_family_2 field
+    // for SMBIOS 2.6+
+    UseNewFiled [[maybe_unused]] = 0xFE,
 
-    enum class Upgrade : Byte {
-      Unspecified = 0x00,
-      Other [[maybe_unused]] = 0x01,
-      Unknown [[maybe_unused]] = 0x02,
-      DaughterBoard [[maybe_unused]] = 0x03,
-      ZIFSocket [[maybe_unused]] = 0x04,
-      ReplaceablePiggyBack [[maybe_unused]] = 0x05,
-      None [[maybe_unused]] = 0x06,
-      LIFSocket [[maybe_unused]] = 0x07,
-      Slot1 [[maybe_unused]] = 0x08,
-      Slot2 [[maybe_unused]] = 0x09,
-      Pin370Socket [[maybe_unused]] = 0x0A,
-      SlotA [[maybe_unused]] = 0x0B,
-      SlotM [[maybe_unused]] = 0x0C,
-      Socket423 [[maybe_unused]] = 0x0D,
-      SocketA [[maybe_unused]] = 0x0E,
-      Socket478 [[maybe_unused]] = 0x0F,
-      Socket754 [[maybe_unused]] = 0x10,
-      Socket940 [[maybe_unused]] = 0x11,
-      Socket939 [[maybe_unused]] = 0x12,
-      SocketmPGA604 [[maybe_unused]] = 0x13,
-      SocketLGA771 [[maybe_unused]] = 0x14,
-      SocketLGA775 [[maybe_unused]] = 0x15,
-      SocketS1 [[maybe_unused]] = 0x16,
-      SocketAM2 [[maybe_unused]] = 0x17,
-      SocketF [[maybe_unused]] = 0x18,
-      SocketLGA1366 [[maybe_unused]] = 0x19,
-      SocketG34 [[maybe_unused]] = 0x1A,
-      SocketAM3 [[maybe_unused]] = 0x1B,
-      SocketC32 [[maybe_unused]] = 0x1C,
-      SocketLGA1156 [[maybe_unused]] = 0x1D,
-      SocketLGA1567 [[maybe_unused]] = 0x1E,
-      SocketPGA988A [[maybe_unused]] = 0x1F,
-      SocketBGA1288 [[maybe_unused]] = 0x20,
-      SocketrPGA988B [[maybe_unused]] = 0x21,
-      SocketBGA1023 [[maybe_unused]] = 0x22,
-      SocketBGA1224 [[maybe_unused]] = 0x23,
-      SocketLGA1155 [[maybe_unused]] = 0x24,
-      SocketLGA1356 [[maybe_unused]] = 0x25,
-      SocketLGA2011 [[maybe_unused]] = 0x26,
-      SocketFS1 [[maybe_unused]] = 0x27,
-      SocketFS2 [[maybe_unused]] = 0x28,
-      SocketFM1 [[maybe_unused]] = 0x29,
-      SocketFM2 [[maybe_unused]] = 0x2A,
-      SocketLGA2011_3 [[maybe_unused]] = 0x2B,
-      SocketLGA1356_3 [[maybe_unused]] = 0x2C,
-      SocketLGA1150 [[maybe_unused]] = 0x2D,
-      SocketBGA1168 [[maybe_unused]] = 0x2E,
-      SocketBGA1234 [[maybe_unused]] = 0x2F,
-      SocketBGA1364 [[maybe_unused]] = 0x30,
-      SocketAM4 [[maybe_unused]] = 0x31,
-      SocketLGA1151 [[maybe_unused]] = 0x32,
-      SocketBGA1356 [[maybe_unused]] = 0x33,
-      SocketBGA1440 [[maybe_unused]] = 0x34,
-      SocketBGA1515 [[maybe_unused]] = 0x35,
-      SocketLGA3647_1 [[maybe_unused]] = 0x36,
-      SocketSP3 [[maybe_unused]] = 0x37,
-      SocketSP3r2 [[maybe_unused]] = 0x38,
-      SocketLGA2066 [[maybe_unused]] = 0x39,
-      SocketBGA1392 [[maybe_unused]] = 0x3A,
-      SocketBGA1510 [[maybe_unused]] = 0x3B,
-      SocketBGA1528 [[maybe_unused]] = 0x3C,
-      SocketLGA4189 [[maybe_unused]] = 0x3D,
-      SocketLGA1200 [[maybe_unused]] = 0x3E,
-      SocketLGA4677 [[maybe_unused]] = 0x3F,
-      SocketLGA1700 [[maybe_unused]] = 0x40,
-      SocketBGA1744 [[maybe_unused]] = 0x41,
-      SocketBGA1781 [[maybe_unused]] = 0x42,
-      SocketBGA1211 [[maybe_unused]] = 0x43,
-      SocketBGA2422 [[maybe_unused]] = 0x44,
-      SocketLGA1211 [[maybe_unused]] = 0x45,
-      SocketLGA2422 [[maybe_unused]] = 0x46,
-      SocketLGA5773 [[maybe_unused]] = 0x47,
-      SocketBGA5773 [[maybe_unused]] = 0x48
-    };
+    Other [[maybe_unused]] = 0x01,
+    Unknown [[maybe_unused]] = 0x02,
+    _8086 [[maybe_unused]] = 0x03,
+    _80286 [[maybe_unused]] = 0x04,
+    Intel386processor [[maybe_unused]] = 0x05,
+    Intel486processor [[maybe_unused]] = 0x06,
+    _8087 [[maybe_unused]] = 0x07,
+    _80287 [[maybe_unused]] = 0x08,
+    _80387 [[maybe_unused]] = 0x09,
+    _80487 [[maybe_unused]] = 0x0A,
+    IntelPentiumprocessor [[maybe_unused]] = 0x0B,
+    PentiumProprocessor [[maybe_unused]] = 0x0C,
+    PentiumIIprocessor [[maybe_unused]] = 0x0D,
+    PentiumprocessorwithMMXtechnology [[maybe_unused]] = 0x0E,
+    IntelCeleronprocessor [[maybe_unused]] = 0x0F,
+    PentiumIIXeonprocessor [[maybe_unused]] = 0x10,
+    PentiumIIIprocessor [[maybe_unused]] = 0x11,
+    M1Family [[maybe_unused]] = 0x12,
+    M2Family [[maybe_unused]] = 0x13,
+    IntelCeleronMprocessor [[maybe_unused]] = 0x14,
+    IntelPentium4HTprocessor [[maybe_unused]] = 0x15,
+    AMDDuronProcessorFamily [[maybe_unused]] = 0x18,
+    K5Family [[maybe_unused]] = 0x19,
+    K6Family [[maybe_unused]] = 0x1A,
+    K6_2 [[maybe_unused]] = 0x1B,
+    K6_3 [[maybe_unused]] = 0x1C,
+    AMDAthlonProcessorFamily [[maybe_unused]] = 0x1D,
+    AMD29000Family [[maybe_unused]] = 0x1E,
+    K6_2plus [[maybe_unused]] = 0x1F,
+    PowerPCFamily [[maybe_unused]] = 0x20,
+    PowerPC601 [[maybe_unused]] = 0x21,
+    PowerPC603 [[maybe_unused]] = 0x22,
+    PowerPC603plus [[maybe_unused]] = 0x23,
+    PowerPC604 [[maybe_unused]] = 0x24,
+    PowerPC620 [[maybe_unused]] = 0x25,
+    PowerPCx704 [[maybe_unused]] = 0x26,
+    PowerPC750 [[maybe_unused]] = 0x27,
+    IntelCoreDuoprocessor [[maybe_unused]] = 0x28,
+    IntelCoreDuomobileprocessor [[maybe_unused]] = 0x29,
+    IntelCoreSolomobileprocessor [[maybe_unused]] = 0x2A,
+    IntelAtomprocessor [[maybe_unused]] = 0x2B,
+    IntelCoreMprocessor [[maybe_unused]] = 0x2C,
+    Intel_Corem3processor [[maybe_unused]] = 0x2D,
+    Intel_Corem5processor [[maybe_unused]] = 0x2E,
+    Intel_Corem7processor [[maybe_unused]] = 0x2F,
+    AlphaFamily [[maybe_unused]] = 0x30,
+    Alpha21064 [[maybe_unused]] = 0x31,
+    Alpha21066 [[maybe_unused]] = 0x32,
+    Alpha21164 [[maybe_unused]] = 0x33,
+    Alpha21164PC [[maybe_unused]] = 0x34,
+    Alpha21164a [[maybe_unused]] = 0x35,
+    Alpha21264 [[maybe_unused]] = 0x36,
+    Alpha21364 [[maybe_unused]] = 0x37,
+    AMDTurionIIUltraDual_CoreMobileMProcessorFamily [[maybe_unused]] = 0x38,
+    AMDTurionIIDual_CoreMobileMProcessorFamily [[maybe_unused]] = 0x39,
+    AMDAthlonIIDual_CoreMProcessorFamily [[maybe_unused]] = 0x3A,
+    AMDOpteron6100SeriesProcessor [[maybe_unused]] = 0x3B,
+    AMDOpteron4100SeriesProcessor [[maybe_unused]] = 0x3C,
+    AMDOpteron6200SeriesProcessor [[maybe_unused]] = 0x3D,
+    AMDOpteron4200SeriesProcessor [[maybe_unused]] = 0x3E,
+    AMDFXSeriesProcessor [[maybe_unused]] = 0x3F,
+    MIPSFamily [[maybe_unused]] = 0x40,
+    MIPSR4000 [[maybe_unused]] = 0x41,
+    MIPSR4200 [[maybe_unused]] = 0x42,
+    MIPSR4400 [[maybe_unused]] = 0x43,
+    MIPSR4600 [[maybe_unused]] = 0x44,
+    MIPSR10000 [[maybe_unused]] = 0x45,
+    AMDC_SeriesProcessor [[maybe_unused]] = 0x46,
+    AMDE_SeriesProcessor [[maybe_unused]] = 0x47,
+    AMDA_SeriesProcessor [[maybe_unused]] = 0x48,
+    AMDG_SeriesProcessor [[maybe_unused]] = 0x49,
+    AMDZ_SeriesProcessor [[maybe_unused]] = 0x4A,
+    AMDR_SeriesProcessor [[maybe_unused]] = 0x4B,
+    AMDOpteron4300SeriesProcessor [[maybe_unused]] = 0x4C,
+    AMDOpteron6300SeriesProcessor [[maybe_unused]] = 0x4D,
+    AMDOpteron3300SeriesProcessor [[maybe_unused]] = 0x4E,
+    AMDFireProSeriesProcessor [[maybe_unused]] = 0x4F,
+    SPARCFamily [[maybe_unused]] = 0x50,
+    SuperSPARC [[maybe_unused]] = 0x51,
+    microSPARCII [[maybe_unused]] = 0x52,
+    microSPARCIIep [[maybe_unused]] = 0x53,
+    UltraSPARC [[maybe_unused]] = 0x54,
+    UltraSPARCII [[maybe_unused]] = 0x55,
+    UltraSPARCIii [[maybe_unused]] = 0x56,
+    UltraSPARCIII [[maybe_unused]] = 0x57,
+    UltraSPARCIIIi [[maybe_unused]] = 0x58,
+    _68040Family [[maybe_unused]] = 0x60,
+    _68xxx [[maybe_unused]] = 0x61,
+    _68000 [[maybe_unused]] = 0x62,
+    _68010 [[maybe_unused]] = 0x63,
+    _68020 [[maybe_unused]] = 0x64,
+    _68030 [[maybe_unused]] = 0x65,
+    AMDAthlonX4Quad_CoreProcessorFamily [[maybe_unused]] = 0x66,
+    AMDOpteronX1000SeriesProcessor [[maybe_unused]] = 0x67,
+    AMDOpteronX2000SeriesAPU [[maybe_unused]] = 0x68,
+    AMDOpteronA_SeriesProcessor [[maybe_unused]] = 0x69,
+    AMDOpteronX3000SeriesAPU [[maybe_unused]] = 0x6A,
+    AMDZenProcessorFamily [[maybe_unused]] = 0x6B,
+    HobbitFamily [[maybe_unused]] = 0x70,
+    CrusoeTM5000Family [[maybe_unused]] = 0x78,
+    CrusoeTM3000Family [[maybe_unused]] = 0x79,
+    EfficeonTM8000Family [[maybe_unused]] = 0x7A,
+    Weitek [[maybe_unused]] = 0x80,
+    Itaniumprocessor [[maybe_unused]] = 0x82,
+    AMDAthlon64ProcessorFamily [[maybe_unused]] = 0x83,
+    AMDOpteronProcessorFamily [[maybe_unused]] = 0x84,
+    AMDSempronProcessorFamily [[maybe_unused]] = 0x85,
+    AMDTurion64MobileTechnology [[maybe_unused]] = 0x86,
+    Dual_CoreAMDOpteronProcessorFamily [[maybe_unused]] = 0x87,
+    AMDAthlon64X2Dual_CoreProcessorFamily [[maybe_unused]] = 0x88,
+    AMDTurion64X2MobileTechnology [[maybe_unused]] = 0x89,
+    Quad_CoreAMDOpteronProcessorFamily [[maybe_unused]] = 0x8A,
+    Third_GenerationAMDOpteronProcessorFamily [[maybe_unused]] = 0x8B,
+    AMDPhenomFXQuad_CoreProcessorFamily [[maybe_unused]] = 0x8C,
+    AMDPhenomX4Quad_CoreProcessorFamily [[maybe_unused]] = 0x8D,
+    AMDPhenomX2Dual_CoreProcessorFamily [[maybe_unused]] = 0x8E,
+    AMDAthlonX2Dual_CoreProcessorFamily [[maybe_unused]] = 0x8F,
+    PA_RISCFamily [[maybe_unused]] = 0x90,
+    PA_RISC8500 [[maybe_unused]] = 0x91,
+    PA_RISC8000 [[maybe_unused]] = 0x92,
+    PA_RISC7300LC [[maybe_unused]] = 0x93,
+    PA_RISC7200 [[maybe_unused]] = 0x94,
+    PA_RISC7100LC [[maybe_unused]] = 0x95,
+    PA_RISC7100 [[maybe_unused]] = 0x96,
+    V30Family [[maybe_unused]] = 0xA0,
+    Quad_CoreIntelXeonprocessor3200Series [[maybe_unused]] = 0xA1,
+    Dual_CoreIntelXeonprocessor3000Series [[maybe_unused]] = 0xA2,
+    Quad_CoreIntelXeonprocessor5300Series [[maybe_unused]] = 0xA3,
+    Dual_CoreIntelXeonprocessor5100Series [[maybe_unused]] = 0xA4,
+    Dual_CoreIntelXeonprocessor5000Series [[maybe_unused]] = 0xA5,
+    Dual_CoreIntelXeonprocessorLV [[maybe_unused]] = 0xA6,
+    Dual_CoreIntelXeonprocessorULV [[maybe_unused]] = 0xA7,
+    Dual_CoreIntelXeonprocessor7100Series [[maybe_unused]] = 0xA8,
+    Quad_CoreIntelXeonprocessor5400Series [[maybe_unused]] = 0xA9,
+    Quad_CoreIntelXeonprocessor [[maybe_unused]] = 0xAA,
+    Dual_CoreIntelXeonprocessor5200Series [[maybe_unused]] = 0xAB,
+    Dual_CoreIntelXeonprocessor7200Series [[maybe_unused]] = 0xAC,
+    Quad_CoreIntelXeonprocessor7300Series [[maybe_unused]] = 0xAD,
+    Quad_CoreIntelXeonprocessor7400Series [[maybe_unused]] = 0xAE,
+    Multi_CoreIntelXeonprocessor7400Series [[maybe_unused]] = 0xAF,
+    PentiumIIIXeonprocessor [[maybe_unused]] = 0xB0,
+    PentiumIIIProcessorwithIntelSpeedStepTechnology [[maybe_unused]] = 0xB1,
+    Pentium4Processor [[maybe_unused]] = 0xB2,
+    IntelXeonprocessor [[maybe_unused]] = 0xB3,
+    AS400Family [[maybe_unused]] = 0xB4,
+    IntelXeonprocessorMP [[maybe_unused]] = 0xB5,
+    AMDAthlonXPProcessorFamily [[maybe_unused]] = 0xB6,
+    AMDAthlonMPProcessorFamily [[maybe_unused]] = 0xB7,
+    IntelItanium2processor [[maybe_unused]] = 0xB8,
+    IntelPentiumMprocessor [[maybe_unused]] = 0xB9,
+    IntelCeleronDprocessor [[maybe_unused]] = 0xBA,
+    IntelPentiumDprocessor [[maybe_unused]] = 0xBB,
+    IntelPentiumProcessorExtremeEdition [[maybe_unused]] = 0xBC,
+    IntelCoreSoloProcessor [[maybe_unused]] = 0xBD,
+    Reserved [[maybe_unused]] = 0xBE,
+    IntelCore2DuoProcessor [[maybe_unused]] = 0xBF,
+    IntelCore2Soloprocessor [[maybe_unused]] = 0xC0,
+    IntelCore2Extremeprocessor [[maybe_unused]] = 0xC1,
+    IntelCore2Quadprocessor [[maybe_unused]] = 0xC2,
+    IntelCore2Extrememobileprocessor [[maybe_unused]] = 0xC3,
+    IntelCore2Duomobileprocessor [[maybe_unused]] = 0xC4,
+    IntelCore2Solomobileprocessor [[maybe_unused]] = 0xC5,
+    IntelCorei7processor [[maybe_unused]] = 0xC6,
+    Dual_CoreIntelCeleronprocessor [[maybe_unused]] = 0xC7,
+    IBM390Family [[maybe_unused]] = 0xC8,
+    G4 [[maybe_unused]] = 0xC9,
+    G5 [[maybe_unused]] = 0xCA,
+    ESA_390G6 [[maybe_unused]] = 0xCB,
+    z_Architecturebase [[maybe_unused]] = 0xCC,
+    IntelCorei5processor [[maybe_unused]] = 0xCD,
+    IntelCorei3processor [[maybe_unused]] = 0xCE,
+    IntelCorei9processor [[maybe_unused]] = 0xCF,
+    VIAC7_MProcessorFamily [[maybe_unused]] = 0xD2,
+    VIAC7_DProcessorFamily [[maybe_unused]] = 0xD3,
+    VIAC7ProcessorFamily [[maybe_unused]] = 0xD4,
+    VIAEdenProcessorFamily [[maybe_unused]] = 0xD5,
+    Multi_CoreIntelXeonprocessor [[maybe_unused]] = 0xD6,
+    Dual_CoreIntelXeonprocessor3xxxSeries [[maybe_unused]] = 0xD7,
+    Quad_CoreIntelXeonprocessor3xxxSeries [[maybe_unused]] = 0xD8,
+    VIANanoProcessorFamily [[maybe_unused]] = 0xD9,
+    Dual_CoreIntelXeonprocessor5xxxSeries [[maybe_unused]] = 0xDA,
+    Quad_CoreIntelXeonprocessor5xxxSeries [[maybe_unused]] = 0xDB,
+    Dual_CoreIntelXeonprocessor7xxxSeries [[maybe_unused]] = 0xDD,
+    Quad_CoreIntelXeonprocessor7xxxSeries [[maybe_unused]] = 0xDE,
+    Multi_CoreIntelXeonprocessor7xxxSeries [[maybe_unused]] = 0xDF,
+    Multi_CoreIntelXeonprocessor3400Series [[maybe_unused]] = 0xE0,
+    AMDOpteron3000SeriesProcessor [[maybe_unused]] = 0xE4,
+    AMDSempronIIProcessor [[maybe_unused]] = 0xE5,
+    EmbeddedAMDOpteronQuad_CoreProcessorFamily [[maybe_unused]] = 0xE6,
+    AMDPhenomTriple_CoreProcessorFamily [[maybe_unused]] = 0xE7,
+    AMDTurionUltraDual_CoreMobileProcessorFamily [[maybe_unused]] = 0xE8,
+    AMDTurionDual_CoreMobileProcessorFamily [[maybe_unused]] = 0xE9,
+    AMDAthlonDual_CoreProcessorFamily [[maybe_unused]] = 0xEA,
+    AMDSempronSIProcessorFamily [[maybe_unused]] = 0xEB,
+    AMDPhenomIIProcessorFamily [[maybe_unused]] = 0xEC,
+    AMDAthlonIIProcessorFamily [[maybe_unused]] = 0xED,
+    Six_CoreAMDOpteronProcessorFamily [[maybe_unused]] = 0xEE,
+    AMDSempronMProcessorFamily [[maybe_unused]] = 0xEF,
+    i860 [[maybe_unused]] = 0xFA,
+    i960 [[maybe_unused]] = 0xFB,
+    ARMv7 [[maybe_unused]] = 0x100,
+    ARMv8 [[maybe_unused]] = 0x101,
+    ARMv9 [[maybe_unused]] = 0x102,
+    ReservedforfutureusebyARM [[maybe_unused]] = 0x103,
+    SH_3 [[maybe_unused]] = 0x104,
+    SH_4 [[maybe_unused]] = 0x105,
+    ARM [[maybe_unused]] = 0x118,
+    StrongARM [[maybe_unused]] = 0x119,
+    _6x86 [[maybe_unused]] = 0x12C,
+    MediaGX [[maybe_unused]] = 0x12D,
+    MII [[maybe_unused]] = 0x12E,
+    WinChip [[maybe_unused]] = 0x140,
+    DSP [[maybe_unused]] = 0x15E,
+    VideoProcessor [[maybe_unused]] = 0x1F4,
+    RISC_VRV32 [[maybe_unused]] = 0x200,
+    RISC_VRV64 [[maybe_unused]] = 0x201,
+    RISC_VRV128 [[maybe_unused]] = 0x202,
+    LoongArch [[maybe_unused]] = 0x258,
+    Loongson1ProcessorFamily [[maybe_unused]] = 0x259,
+    Loongson2ProcessorFamily [[maybe_unused]] = 0x25A,
+    Loongson3ProcessorFamily [[maybe_unused]] = 0x25B,
+    Loongson2KProcessorFamily [[maybe_unused]] = 0x25C,
+    Loongson3AProcessorFamily [[maybe_unused]] = 0x25D,
+    Loongson3BProcessorFamily [[maybe_unused]] = 0x25E,
+    Loongson3CProcessorFamily [[maybe_unused]] = 0x25F,
+    Loongson3DProcessorFamily [[maybe_unused]] = 0x260,
+    Loongson3EProcessorFamily [[maybe_unused]] = 0x261,
+    Dual_CoreLoongson2KProcessor2xxxSeries [[maybe_unused]] = 0x262,
+    Quad_CoreLoongson3AProcessor5xxxSeries [[maybe_unused]] = 0x26C,
+    Multi_CoreLoongson3AProcessor5xxxSeries [[maybe_unused]] = 0x26D,
+    Quad_CoreLoongson3BProcessor5xxxSeries [[maybe_unused]] = 0x26E,
+    Multi_CoreLoongson3BProcessor5xxxSeries [[maybe_unused]] = 0x26F,
+    Multi_CoreLoongson3CProcessor5xxxSeries [[maybe_unused]] = 0x270,
+    Multi_CoreLoongson3DProcessor5xxxSeries [[maybe_unused]] = 0x271,
+  };
 
-    enum class Family : Word {
-      Unspecified = 0x00,
-      // indicator for Processor_info::processor_family
-      // just use Processor_info::processor_family_2 field
-      // for SMBIOS 2.6+
-      UseNewFiled [[maybe_unused]] = 0xFE,
-
-      Other [[maybe_unused]] = 0x01,
-      Unknown [[maybe_unused]] = 0x02,
-      _8086 [[maybe_unused]] = 0x03,
-      _80286 [[maybe_unused]] = 0x04,
-      Intel386processor [[maybe_unused]] = 0x05,
-      Intel486processor [[maybe_unused]] = 0x06,
-      _8087 [[maybe_unused]] = 0x07,
-      _80287 [[maybe_unused]] = 0x08,
-      _80387 [[maybe_unused]] = 0x09,
-      _80487 [[maybe_unused]] = 0x0A,
-      IntelPentiumprocessor [[maybe_unused]] = 0x0B,
-      PentiumProprocessor [[maybe_unused]] = 0x0C,
-      PentiumIIprocessor [[maybe_unused]] = 0x0D,
-      PentiumprocessorwithMMXtechnology [[maybe_unused]] = 0x0E,
-      IntelCeleronprocessor [[maybe_unused]] = 0x0F,
-      PentiumIIXeonprocessor [[maybe_unused]] = 0x10,
-      PentiumIIIprocessor [[maybe_unused]] = 0x11,
-      M1Family [[maybe_unused]] = 0x12,
-      M2Family [[maybe_unused]] = 0x13,
-      IntelCeleronMprocessor [[maybe_unused]] = 0x14,
-      IntelPentium4HTprocessor [[maybe_unused]] = 0x15,
-      AMDDuronProcessorFamily [[maybe_unused]] = 0x18,
-      K5Family [[maybe_unused]] = 0x19,
-      K6Family [[maybe_unused]] = 0x1A,
-      K6_2 [[maybe_unused]] = 0x1B,
-      K6_3 [[maybe_unused]] = 0x1C,
-      AMDAthlonProcessorFamily [[maybe_unused]] = 0x1D,
-      AMD29000Family [[maybe_unused]] = 0x1E,
-      K6_2plus [[maybe_unused]] = 0x1F,
-      PowerPCFamily [[maybe_unused]] = 0x20,
-      PowerPC601 [[maybe_unused]] = 0x21,
-      PowerPC603 [[maybe_unused]] = 0x22,
-      PowerPC603plus [[maybe_unused]] = 0x23,
-      PowerPC604 [[maybe_unused]] = 0x24,
-      PowerPC620 [[maybe_unused]] = 0x25,
-      PowerPCx704 [[maybe_unused]] = 0x26,
-      PowerPC750 [[maybe_unused]] = 0x27,
-      IntelCoreDuoprocessor [[maybe_unused]] = 0x28,
-      IntelCoreDuomobileprocessor [[maybe_unused]] = 0x29,
-      IntelCoreSolomobileprocessor [[maybe_unused]] = 0x2A,
-      IntelAtomprocessor [[maybe_unused]] = 0x2B,
-      IntelCoreMprocessor [[maybe_unused]] = 0x2C,
-      Intel_Corem3processor [[maybe_unused]] = 0x2D,
-      Intel_Corem5processor [[maybe_unused]] = 0x2E,
-      Intel_Corem7processor [[maybe_unused]] = 0x2F,
-      AlphaFamily [[maybe_unused]] = 0x30,
-      Alpha21064 [[maybe_unused]] = 0x31,
-      Alpha21066 [[maybe_unused]] = 0x32,
-      Alpha21164 [[maybe_unused]] = 0x33,
-      Alpha21164PC [[maybe_unused]] = 0x34,
-      Alpha21164a [[maybe_unused]] = 0x35,
-      Alpha21264 [[maybe_unused]] = 0x36,
-      Alpha21364 [[maybe_unused]] = 0x37,
-      AMDTurionIIUltraDual_CoreMobileMProcessorFamily [[maybe_unused]] = 0x38,
-      AMDTurionIIDual_CoreMobileMProcessorFamily [[maybe_unused]] = 0x39,
-      AMDAthlonIIDual_CoreMProcessorFamily [[maybe_unused]] = 0x3A,
-      AMDOpteron6100SeriesProcessor [[maybe_unused]] = 0x3B,
-      AMDOpteron4100SeriesProcessor [[maybe_unused]] = 0x3C,
-      AMDOpteron6200SeriesProcessor [[maybe_unused]] = 0x3D,
-      AMDOpteron4200SeriesProcessor [[maybe_unused]] = 0x3E,
-      AMDFXSeriesProcessor [[maybe_unused]] = 0x3F,
-      MIPSFamily [[maybe_unused]] = 0x40,
-      MIPSR4000 [[maybe_unused]] = 0x41,
-      MIPSR4200 [[maybe_unused]] = 0x42,
-      MIPSR4400 [[maybe_unused]] = 0x43,
-      MIPSR4600 [[maybe_unused]] = 0x44,
-      MIPSR10000 [[maybe_unused]] = 0x45,
-      AMDC_SeriesProcessor [[maybe_unused]] = 0x46,
-      AMDE_SeriesProcessor [[maybe_unused]] = 0x47,
-      AMDA_SeriesProcessor [[maybe_unused]] = 0x48,
-      AMDG_SeriesProcessor [[maybe_unused]] = 0x49,
-      AMDZ_SeriesProcessor [[maybe_unused]] = 0x4A,
-      AMDR_SeriesProcessor [[maybe_unused]] = 0x4B,
-      AMDOpteron4300SeriesProcessor [[maybe_unused]] = 0x4C,
-      AMDOpteron6300SeriesProcessor [[maybe_unused]] = 0x4D,
-      AMDOpteron3300SeriesProcessor [[maybe_unused]] = 0x4E,
-      AMDFireProSeriesProcessor [[maybe_unused]] = 0x4F,
-      SPARCFamily [[maybe_unused]] = 0x50,
-      SuperSPARC [[maybe_unused]] = 0x51,
-      microSPARCII [[maybe_unused]] = 0x52,
-      microSPARCIIep [[maybe_unused]] = 0x53,
-      UltraSPARC [[maybe_unused]] = 0x54,
-      UltraSPARCII [[maybe_unused]] = 0x55,
-      UltraSPARCIii [[maybe_unused]] = 0x56,
-      UltraSPARCIII [[maybe_unused]] = 0x57,
-      UltraSPARCIIIi [[maybe_unused]] = 0x58,
-      _68040Family [[maybe_unused]] = 0x60,
-      _68xxx [[maybe_unused]] = 0x61,
-      _68000 [[maybe_unused]] = 0x62,
-      _68010 [[maybe_unused]] = 0x63,
-      _68020 [[maybe_unused]] = 0x64,
-      _68030 [[maybe_unused]] = 0x65,
-      AMDAthlonX4Quad_CoreProcessorFamily [[maybe_unused]] = 0x66,
-      AMDOpteronX1000SeriesProcessor [[maybe_unused]] = 0x67,
-      AMDOpteronX2000SeriesAPU [[maybe_unused]] = 0x68,
-      AMDOpteronA_SeriesProcessor [[maybe_unused]] = 0x69,
-      AMDOpteronX3000SeriesAPU [[maybe_unused]] = 0x6A,
-      AMDZenProcessorFamily [[maybe_unused]] = 0x6B,
-      HobbitFamily [[maybe_unused]] = 0x70,
-      CrusoeTM5000Family [[maybe_unused]] = 0x78,
-      CrusoeTM3000Family [[maybe_unused]] = 0x79,
-      EfficeonTM8000Family [[maybe_unused]] = 0x7A,
-      Weitek [[maybe_unused]] = 0x80,
-      Itaniumprocessor [[maybe_unused]] = 0x82,
-      AMDAthlon64ProcessorFamily [[maybe_unused]] = 0x83,
-      AMDOpteronProcessorFamily [[maybe_unused]] = 0x84,
-      AMDSempronProcessorFamily [[maybe_unused]] = 0x85,
-      AMDTurion64MobileTechnology [[maybe_unused]] = 0x86,
-      Dual_CoreAMDOpteronProcessorFamily [[maybe_unused]] = 0x87,
-      AMDAthlon64X2Dual_CoreProcessorFamily [[maybe_unused]] = 0x88,
-      AMDTurion64X2MobileTechnology [[maybe_unused]] = 0x89,
-      Quad_CoreAMDOpteronProcessorFamily [[maybe_unused]] = 0x8A,
-      Third_GenerationAMDOpteronProcessorFamily [[maybe_unused]] = 0x8B,
-      AMDPhenomFXQuad_CoreProcessorFamily [[maybe_unused]] = 0x8C,
-      AMDPhenomX4Quad_CoreProcessorFamily [[maybe_unused]] = 0x8D,
-      AMDPhenomX2Dual_CoreProcessorFamily [[maybe_unused]] = 0x8E,
-      AMDAthlonX2Dual_CoreProcessorFamily [[maybe_unused]] = 0x8F,
-      PA_RISCFamily [[maybe_unused]] = 0x90,
-      PA_RISC8500 [[maybe_unused]] = 0x91,
-      PA_RISC8000 [[maybe_unused]] = 0x92,
-      PA_RISC7300LC [[maybe_unused]] = 0x93,
-      PA_RISC7200 [[maybe_unused]] = 0x94,
-      PA_RISC7100LC [[maybe_unused]] = 0x95,
-      PA_RISC7100 [[maybe_unused]] = 0x96,
-      V30Family [[maybe_unused]] = 0xA0,
-      Quad_CoreIntelXeonprocessor3200Series [[maybe_unused]] = 0xA1,
-      Dual_CoreIntelXeonprocessor3000Series [[maybe_unused]] = 0xA2,
-      Quad_CoreIntelXeonprocessor5300Series [[maybe_unused]] = 0xA3,
-      Dual_CoreIntelXeonprocessor5100Series [[maybe_unused]] = 0xA4,
-      Dual_CoreIntelXeonprocessor5000Series [[maybe_unused]] = 0xA5,
-      Dual_CoreIntelXeonprocessorLV [[maybe_unused]] = 0xA6,
-      Dual_CoreIntelXeonprocessorULV [[maybe_unused]] = 0xA7,
-      Dual_CoreIntelXeonprocessor7100Series [[maybe_unused]] = 0xA8,
-      Quad_CoreIntelXeonprocessor5400Series [[maybe_unused]] = 0xA9,
-      Quad_CoreIntelXeonprocessor [[maybe_unused]] = 0xAA,
-      Dual_CoreIntelXeonprocessor5200Series [[maybe_unused]] = 0xAB,
-      Dual_CoreIntelXeonprocessor7200Series [[maybe_unused]] = 0xAC,
-      Quad_CoreIntelXeonprocessor7300Series [[maybe_unused]] = 0xAD,
-      Quad_CoreIntelXeonprocessor7400Series [[maybe_unused]] = 0xAE,
-      Multi_CoreIntelXeonprocessor7400Series [[maybe_unused]] = 0xAF,
-      PentiumIIIXeonprocessor [[maybe_unused]] = 0xB0,
-      PentiumIIIProcessorwithIntelSpeedStepTechnology [[maybe_unused]] = 0xB1,
-      Pentium4Processor [[maybe_unused]] = 0xB2,
-      IntelXeonprocessor [[maybe_unused]] = 0xB3,
-      AS400Family [[maybe_unused]] = 0xB4,
-      IntelXeonprocessorMP [[maybe_unused]] = 0xB5,
-      AMDAthlonXPProcessorFamily [[maybe_unused]] = 0xB6,
-      AMDAthlonMPProcessorFamily [[maybe_unused]] = 0xB7,
-      IntelItanium2processor [[maybe_unused]] = 0xB8,
-      IntelPentiumMprocessor [[maybe_unused]] = 0xB9,
-      IntelCeleronDprocessor [[maybe_unused]] = 0xBA,
-      IntelPentiumDprocessor [[maybe_unused]] = 0xBB,
-      IntelPentiumProcessorExtremeEdition [[maybe_unused]] = 0xBC,
-      IntelCoreSoloProcessor [[maybe_unused]] = 0xBD,
-      Reserved [[maybe_unused]] = 0xBE,
-      IntelCore2DuoProcessor [[maybe_unused]] = 0xBF,
-      IntelCore2Soloprocessor [[maybe_unused]] = 0xC0,
-      IntelCore2Extremeprocessor [[maybe_unused]] = 0xC1,
-      IntelCore2Quadprocessor [[maybe_unused]] = 0xC2,
-      IntelCore2Extrememobileprocessor [[maybe_unused]] = 0xC3,
-      IntelCore2Duomobileprocessor [[maybe_unused]] = 0xC4,
-      IntelCore2Solomobileprocessor [[maybe_unused]] = 0xC5,
-      IntelCorei7processor [[maybe_unused]] = 0xC6,
-      Dual_CoreIntelCeleronprocessor [[maybe_unused]] = 0xC7,
-      IBM390Family [[maybe_unused]] = 0xC8,
-      G4 [[maybe_unused]] = 0xC9,
-      G5 [[maybe_unused]] = 0xCA,
-      ESA_390G6 [[maybe_unused]] = 0xCB,
-      z_Architecturebase [[maybe_unused]] = 0xCC,
-      IntelCorei5processor [[maybe_unused]] = 0xCD,
-      IntelCorei3processor [[maybe_unused]] = 0xCE,
-      IntelCorei9processor [[maybe_unused]] = 0xCF,
-      VIAC7_MProcessorFamily [[maybe_unused]] = 0xD2,
-      VIAC7_DProcessorFamily [[maybe_unused]] = 0xD3,
-      VIAC7ProcessorFamily [[maybe_unused]] = 0xD4,
-      VIAEdenProcessorFamily [[maybe_unused]] = 0xD5,
-      Multi_CoreIntelXeonprocessor [[maybe_unused]] = 0xD6,
-      Dual_CoreIntelXeonprocessor3xxxSeries [[maybe_unused]] = 0xD7,
-      Quad_CoreIntelXeonprocessor3xxxSeries [[maybe_unused]] = 0xD8,
-      VIANanoProcessorFamily [[maybe_unused]] = 0xD9,
-      Dual_CoreIntelXeonprocessor5xxxSeries [[maybe_unused]] = 0xDA,
-      Quad_CoreIntelXeonprocessor5xxxSeries [[maybe_unused]] = 0xDB,
-      Dual_CoreIntelXeonprocessor7xxxSeries [[maybe_unused]] = 0xDD,
-      Quad_CoreIntelXeonprocessor7xxxSeries [[maybe_unused]] = 0xDE,
-      Multi_CoreIntelXeonprocessor7xxxSeries [[maybe_unused]] = 0xDF,
-      Multi_CoreIntelXeonprocessor3400Series [[maybe_unused]] = 0xE0,
-      AMDOpteron3000SeriesProcessor [[maybe_unused]] = 0xE4,
-      AMDSempronIIProcessor [[maybe_unused]] = 0xE5,
-      EmbeddedAMDOpteronQuad_CoreProcessorFamily [[maybe_unused]] = 0xE6,
-      AMDPhenomTriple_CoreProcessorFamily [[maybe_unused]] = 0xE7,
-      AMDTurionUltraDual_CoreMobileProcessorFamily [[maybe_unused]] = 0xE8,
-      AMDTurionDual_CoreMobileProcessorFamily [[maybe_unused]] = 0xE9,
-      AMDAthlonDual_CoreProcessorFamily [[maybe_unused]] = 0xEA,
-      AMDSempronSIProcessorFamily [[maybe_unused]] = 0xEB,
-      AMDPhenomIIProcessorFamily [[maybe_unused]] = 0xEC,
-      AMDAthlonIIProcessorFamily [[maybe_unused]] = 0xED,
-      Six_CoreAMDOpteronProcessorFamily [[maybe_unused]] = 0xEE,
-      AMDSempronMProcessorFamily [[maybe_unused]] = 0xEF,
-      i860 [[maybe_unused]] = 0xFA,
-      i960 [[maybe_unused]] = 0xFB,
-      ARMv7 [[maybe_unused]] = 0x100,
-      ARMv8 [[maybe_unused]] = 0x101,
-      ARMv9 [[maybe_unused]] = 0x102,
-      ReservedforfutureusebyARM [[maybe_unused]] = 0x103,
-      SH_3 [[maybe_unused]] = 0x104,
-      SH_4 [[maybe_unused]] = 0x105,
-      ARM [[maybe_unused]] = 0x118,
-      StrongARM [[maybe_unused]] = 0x119,
-      _6x86 [[maybe_unused]] = 0x12C,
-      MediaGX [[maybe_unused]] = 0x12D,
-      MII [[maybe_unused]] = 0x12E,
-      WinChip [[maybe_unused]] = 0x140,
-      DSP [[maybe_unused]] = 0x15E,
-      VideoProcessor [[maybe_unused]] = 0x1F4,
-      RISC_VRV32 [[maybe_unused]] = 0x200,
-      RISC_VRV64 [[maybe_unused]] = 0x201,
-      RISC_VRV128 [[maybe_unused]] = 0x202,
-      LoongArch [[maybe_unused]] = 0x258,
-      Loongson1ProcessorFamily [[maybe_unused]] = 0x259,
-      Loongson2ProcessorFamily [[maybe_unused]] = 0x25A,
-      Loongson3ProcessorFamily [[maybe_unused]] = 0x25B,
-      Loongson2KProcessorFamily [[maybe_unused]] = 0x25C,
-      Loongson3AProcessorFamily [[maybe_unused]] = 0x25D,
-      Loongson3BProcessorFamily [[maybe_unused]] = 0x25E,
-      Loongson3CProcessorFamily [[maybe_unused]] = 0x25F,
-      Loongson3DProcessorFamily [[maybe_unused]] = 0x260,
-      Loongson3EProcessorFamily [[maybe_unused]] = 0x261,
-      Dual_CoreLoongson2KProcessor2xxxSeries [[maybe_unused]] = 0x262,
-      Quad_CoreLoongson3AProcessor5xxxSeries [[maybe_unused]] = 0x26C,
-      Multi_CoreLoongson3AProcessor5xxxSeries [[maybe_unused]] = 0x26D,
-      Quad_CoreLoongson3BProcessor5xxxSeries [[maybe_unused]] = 0x26E,
-      Multi_CoreLoongson3BProcessor5xxxSeries [[maybe_unused]] = 0x26F,
-      Multi_CoreLoongson3CProcessor5xxxSeries [[maybe_unused]] = 0x270,
-      Multi_CoreLoongson3DProcessor5xxxSeries [[maybe_unused]] = 0x271,
-    };
+  template<class String>
+  struct Basic_bios_info final : Structure {
+    std::optional<String> vendor;
+    std::optional<String> version;
+    std::optional<String> release_date;
+    Byte rom_size{};
+  };
+  using Bios_info = Basic_bios_info<std::string>;
+  using Bios_info_view = Basic_bios_info<std::string_view>;
+
+  template<class String>
+  struct Basic_sys_info final : Structure {
+    std::optional<String> manufacturer;
+    std::optional<String> product;
+    std::optional<String> version;
+    std::optional<String> serial_number;
+    rnd::Uuid uuid{};
+  };
+  using Sys_info = Basic_sys_info<std::string>;
+  using Sys_info_view = Basic_sys_info<std::string_view>;
+
+  template<class String>
+  struct Basic_baseboard_info final : Structure {
+    std::optional<String> manufacturer;
+    std::optional<String> product;
+    std::optional<String> version;
+    std::optional<String> serial_number;
+  };
+  using Baseboard_info = Basic_baseboard_info<std::string>;
+  using Baseboard_info_view = Basic_baseboard_info<std::string_view>;
+
+  template<class String>
+  struct Basic_processor_info final : Structure {
+    using Type = Processor_type;
+    using Upgrade = Processor_upgrade;
+    using Family = Processor_family;
 
     // 2.0+
-    std::optional<std::string> socket;
+    std::optional<String> socket;
     Type type{Type::Unspecified};
     Family family{Family::Unspecified};
-    std::optional<std::string> manufacturer;
+    std::optional<String> manufacturer;
     Qword id{};
-    std::optional<std::string> version;
+    std::optional<String> version;
     Byte voltage{};
     Word external_clock{};
     Word max_speed{};
@@ -445,9 +520,9 @@ public:
     Word l3_cache_handle{};
 
     // 2.3+
-    std::optional<std::string> serial_number;
-    std::optional<std::string> asset_tag;
-    std::optional<std::string> part_number;
+    std::optional<String> serial_number;
+    std::optional<String> asset_tag;
+    std::optional<String> part_number;
 
     // 2.5+
     Byte core_count{};
@@ -466,268 +541,1267 @@ public:
     // 3.6+
     Word thread_enabled{};
   };
+  using Processor_info = Basic_processor_info<std::string>;
+  using Processor_info_view = Basic_processor_info<std::string_view>;
 
-  Smbios_table(const Byte* const data, const std::size_t size)
-    : data_(size)
-  {
-    std::memcpy(data_.data(), data, size);
-    if (size != header().length)
-      throw std::invalid_argument{"invalid SMBIOS firmware table provided"};
-  }
+  /// System enclosure or chassis (type 3).
+  template<class String>
+  struct Basic_system_enclosure_info final : Structure {
+    // 2.0+
+    std::optional<String> manufacturer;
+    /// The chassis type (bits 6:0) and the lock presence flag (bit 7).
+    Byte type{};
+    std::optional<String> version;
+    std::optional<String> serial_number;
+    std::optional<String> asset_tag;
 
-  static Smbios_table from_system()
-  {
-    Smbios_table result;
-    auto& rd = result.data_;
-#ifdef _WIN32
-    rd.resize(GetSystemFirmwareTable('RSMB', 0, nullptr, 0));
-    if (rd.empty() || !GetSystemFirmwareTable('RSMB', 0, rd.data(), rd.size()))
-      throw winbase::Sys_exception{"cannot get SMBIOS firmware table"};
-#elif __linux__
-    // Read entry point as Header.
+    // 2.1+
+    Byte boot_up_state{};
+    Byte power_supply_state{};
+    Byte thermal_state{};
+    Byte security_status{};
+
+    // 2.3+
+    Dword oem_defined{};
+    /// The height in rack units, or `0` if unspecified.
+    Byte height{};
+    Byte power_cord_count{};
+    Byte contained_element_count{};
+    Byte contained_element_record_length{};
+
+    // 2.7+
+    std::optional<String> sku_number;
+  };
+  using System_enclosure_info = Basic_system_enclosure_info<std::string>;
+  using System_enclosure_info_view = Basic_system_enclosure_info<std::string_view>;
+
+  /// Cache information (type 7).
+  template<class String>
+  struct Basic_cache_info final : Structure {
+    // 2.0+
+    std::optional<String> socket_designation;
+    /// The level (bits 2:0), socketed (bit 3), location (bits 6:5),
+    /// enabled (bit 7) and operational mode (bits 9:8).
+    Word configuration{};
+    Word maximum_size{};
+    Word installed_size{};
+    Word supported_sram_type{};
+    Word current_sram_type{};
+
+    // 2.1+
+    /// The speed in nanoseconds, or `0` if unknown.
+    Byte speed{};
+    Byte error_correction_type{};
+    Byte system_cache_type{};
+    Byte associativity{};
+
+    // 3.1+
+    Dword maximum_size_2{};
+    Dword installed_size_2{};
+
+    /// @returns The cache level starting from `1`.
+    Byte level() const noexcept
     {
-      const std::filesystem::path entry_point_path{"/sys/firmware/dmi/tables/"
-        "smbios_entry_point"};
-      std::ifstream entry_point{entry_point_path, std::ios::binary};
-      if (!entry_point)
-        throw std::runtime_error{"cannot open "+entry_point_path.string()};
-      constexpr const std::streamoff sm2_entry_point_size{31};
-      constexpr const std::streamoff sm3_entry_point_size{24};
-      const auto entry_point_size = seekg_size(entry_point);
-      if (entry_point_size < std::min(sm2_entry_point_size, sm3_entry_point_size))
-        throw std::runtime_error{"cannot get SMBIOS table: invalid entry point"};
-      std::string header;
-      header.resize(entry_point_size);
-      if (!entry_point.read(header.data(), header.size()))
-        throw std::runtime_error{"cannot read "+entry_point_path.string()};
-      constexpr const std::string_view sm2_anchor{"_SM_"};
-      constexpr const std::string_view sm3_anchor{"_SM3_"};
-      rd.resize(sizeof(Header));
-      auto* const h = reinterpret_cast<Header*>(rd.data());
-      if (std::string_view{header.data(), sm2_anchor.size()} == sm2_anchor) {
-        h->major_version = header[0x06];
-        h->minor_version = header[0x07];
-        h->dmi_revision = header[0x0A];
-      } else if (std::string_view{header.data(), sm3_anchor.size()} == sm3_anchor) {
-        h->major_version = header[0x07];
-        h->minor_version = header[0x08];
-        h->dmi_revision = header[0x0A];
-      } else
-        throw std::runtime_error{"cannot get SMBIOS table: unsupported version"};
-      h->used_20_calling_method = 0;
+      return static_cast<Byte>((configuration & 0x7) + 1);
     }
 
-    // Read DMI (SMBIOS Structure Table) and complete header.
+    /// @returns The maximum size of the cache in bytes.
+    Qword maximum_size_bytes() const noexcept
     {
-      const std::filesystem::path dmi_path{"/sys/firmware/dmi/tables/DMI"};
-      std::ifstream dmi{dmi_path, std::ios::binary};
-      if (!dmi)
-        throw std::runtime_error{"cannot open "+dmi_path.string()};
-      DMITIGR_ASSERT(rd.size() == sizeof(Header));
-      const auto dmi_size = seekg_size(dmi);
-      rd.resize(sizeof(Header) + dmi_size);
-      if (!dmi.read(reinterpret_cast<char*>(rd.data()) + sizeof(Header), dmi_size))
-        throw std::runtime_error{"cannot read "+dmi_path.string()};
-      reinterpret_cast<Header*>(rd.data())->length = rd.size();
+      return cache_size_bytes(maximum_size, maximum_size_2);
     }
-#else
-    #error Unsupported OS family
-#endif
-    return result;
+
+    /// @returns The installed size of the cache in bytes.
+    Qword installed_size_bytes() const noexcept
+    {
+      return cache_size_bytes(installed_size, installed_size_2);
+    }
+
+  private:
+    static Qword cache_size_bytes(const Word size, const Dword size_2) noexcept
+    {
+      // The granularity is either 1K or 64K as denoted by the highest bit.
+      if (size == 0xFFFF)
+        return (size_2 & 0x80000000 ? Qword{64} : Qword{1}) *
+          (size_2 & 0x7FFFFFFF) * 1024;
+      return (size & 0x8000 ? Qword{64} : Qword{1}) * (size & 0x7FFF) * 1024;
+    }
+  };
+  using Cache_info = Basic_cache_info<std::string>;
+  using Cache_info_view = Basic_cache_info<std::string_view>;
+
+  /// System slot (type 9).
+  template<class String>
+  struct Basic_system_slot_info final : Structure {
+    // 2.0+
+    std::optional<String> designation;
+    Byte type{};
+    Byte data_bus_width{};
+    Byte current_usage{};
+    Byte length{};
+    Word id{};
+    Byte characteristics_1{};
+
+    // 2.1+
+    Byte characteristics_2{};
+
+    // 2.6+
+    Word segment_group_number{};
+    Byte bus_number{};
+    /// The device number (bits 7:3) and the function number (bits 2:0).
+    Byte device_function_number{};
+
+    // 3.2+
+    Byte data_bus_width_base{};
+    Byte peer_grouping_count{};
+
+    // 3.4+
+    Byte slot_information{};
+    Byte slot_physical_width{};
+    Word slot_pitch{};
+
+    // 3.5+
+    Byte slot_height{};
+  };
+  using System_slot_info = Basic_system_slot_info<std::string>;
+  using System_slot_info_view = Basic_system_slot_info<std::string_view>;
+
+  /// Physical memory array (type 16).
+  struct Memory_array_info final : Structure {
+    // 2.1+
+    Byte location{};
+    Byte use{};
+    Byte error_correction{};
+    /// The maximum capacity in kilobytes, or `0x80000000` if the extended
+    /// maximum capacity must be used instead.
+    Dword maximum_capacity{};
+    Word error_information_handle{};
+    Word memory_device_count{};
+
+    // 2.7+
+    Qword extended_maximum_capacity{};
+
+    /// @returns The maximum capacity in bytes.
+    Qword maximum_capacity_bytes() const noexcept
+    {
+      return maximum_capacity == 0x80000000 ? extended_maximum_capacity :
+        Qword{maximum_capacity} * 1024;
+    }
+  };
+
+  /// Memory device (type 17).
+  template<class String>
+  struct Basic_memory_device_info final : Structure {
+    // 2.1+
+    Word memory_array_handle{};
+    Word error_information_handle{};
+    Word total_width{};
+    Word data_width{};
+    /// The size in megabytes (bit 15 is clear) or kilobytes (bit 15 is set),
+    /// or `0x7FFF` if the extended size must be used instead.
+    Word size{};
+    Byte form_factor{};
+    Byte device_set{};
+    std::optional<String> device_locator;
+    std::optional<String> bank_locator;
+    Byte memory_type{};
+    Word type_detail{};
+
+    // 2.3+
+    /// The maximum speed in MT/s, or `0xFFFF` if the extended speed must be
+    /// used instead.
+    Word speed{};
+    std::optional<String> manufacturer;
+    std::optional<String> serial_number;
+    std::optional<String> asset_tag;
+    std::optional<String> part_number;
+
+    // 2.6+
+    /// The rank (bits 3:0).
+    Byte attributes{};
+
+    // 2.7+
+    /// The size in megabytes (bits 30:0).
+    Dword extended_size{};
+    Word configured_memory_speed{};
+
+    // 2.8+
+    /// The voltages in millivolts.
+    Word minimum_voltage{};
+    Word maximum_voltage{};
+    Word configured_voltage{};
+
+    // 3.2+
+    Byte memory_technology{};
+    Word memory_operating_mode_capability{};
+    std::optional<String> firmware_version;
+    Word module_manufacturer_id{};
+    Word module_product_id{};
+    Word memory_subsystem_controller_manufacturer_id{};
+    Word memory_subsystem_controller_product_id{};
+    Qword non_volatile_size{};
+    Qword volatile_size{};
+    Qword cache_size{};
+    Qword logical_size{};
+
+    // 3.3+
+    Dword extended_speed{};
+    Dword extended_configured_memory_speed{};
+
+    /// @returns The size in bytes, or `0` if no device installed or unknown.
+    Qword size_bytes() const noexcept
+    {
+      if (size == 0xFFFF)
+        return 0;
+      else if (size == 0x7FFF)
+        return Qword{extended_size & 0x7FFFFFFF} << 20;
+      else
+        return Qword{size & 0x7FFFu} << (size & 0x8000 ? 10 : 20);
+    }
+  };
+  using Memory_device_info = Basic_memory_device_info<std::string>;
+  using Memory_device_info_view = Basic_memory_device_info<std::string_view>;
+
+  /// Memory array mapped address (type 19).
+  struct Memory_array_mapped_address_info final : Structure {
+    // 2.1+
+    /// The starting address in kilobytes, or `0xFFFFFFFF` if the extended
+    /// starting address must be used instead.
+    Dword starting_address{};
+    Dword ending_address{};
+    Word memory_array_handle{};
+    Byte partition_width{};
+
+    // 2.7+
+    /// The address in bytes.
+    Qword extended_starting_address{};
+    Qword extended_ending_address{};
+
+    /// @returns The starting address in bytes.
+    Qword starting_address_bytes() const noexcept
+    {
+      return starting_address == 0xFFFFFFFF ? extended_starting_address :
+        Qword{starting_address} * 1024;
+    }
+
+    /// @returns The ending address in bytes (inclusive).
+    Qword ending_address_bytes() const noexcept
+    {
+      return starting_address == 0xFFFFFFFF ? extended_ending_address :
+        Qword{ending_address} * 1024 + 1023;
+    }
+  };
+
+  /// IPMI device information (type 38).
+  struct Ipmi_device_info final : Structure {
+    Byte interface_type{};
+    /// The IPMI specification revision in BCD format.
+    Byte specification_revision{};
+    Byte i2c_target_address{};
+    Byte nv_storage_device_address{};
+    Qword base_address{};
+    Byte base_address_modifier{};
+    Byte interrupt_number{};
+  };
+
+  /// A problem found while parsing SMBIOS table.
+  struct Parse_error final {
+    /// The error code.
+    enum class Code {
+      /// The structure is not entirely within the table.
+      truncated_structure = 1,
+      /// The length of the formatted area is less than the header length.
+      invalid_structure_length,
+      /// The strings of the structure are not terminated within the table.
+      unterminated_strings
+    };
+
+    /// The error code.
+    Code code{};
+    /// The offset of the malformed structure from the beginning of the table.
+    Dword offset{};
+  };
+
+  /// The structure index of SMBIOS table.
+  class Index final {
+  public:
+    /// An entry of the index.
+    struct Entry final {
+      /// The offset of the structure from the beginning of the table.
+      Dword offset{};
+      /// The position of the first string offset in the string offsets.
+      Dword strings_position{};
+      /// The number of strings of the structure.
+      Dword string_count{};
+    };
+
+    /// Constructs an empty index.
+    Index() = default;
+
+    /**
+     * @brief Builds the index of `size` bytes of `data` by walking it only once.
+     *
+     * @details Each structure is validated to be entirely within the table.
+     * The walk stops at either the end-of-table structure or the first
+     * malformed structure, which is reported in `errors()` rather than
+     * indexed. Thus, the structures of the index can be accessed without
+     * further bounds checking.
+     */
+    Index(const Byte* const data, const std::size_t size)
+    {
+      DMITIGR_ASSERT(data);
+      std::array<Dword, 256> type_counts{};
+      for (std::size_t offset{sizeof(Header)}; offset < size;) {
+        using Code = Parse_error::Code;
+        const auto error = [this, offset](const Code code)
+        {
+          errors_.push_back(Parse_error{code, static_cast<Dword>(offset)});
+        };
+        if (size - offset < sizeof(Structure)) {
+          error(Code::truncated_structure);
+          break;
+        }
+        const Byte type = data[offset];
+        const Byte length = data[offset + 1];
+        if (length < sizeof(Structure)) {
+          error(Code::invalid_structure_length);
+          break;
+        } else if (length > size - offset) {
+          error(Code::truncated_structure);
+          break;
+        }
+
+        Entry entry;
+        entry.offset = static_cast<Dword>(offset);
+        entry.strings_position = static_cast<Dword>(strings_.size());
+
+        // Scan the unformed section which is terminated by two zeros.
+        std::size_t pos{offset + length};
+        if (size - pos >= 2 && !data[pos] && !data[pos + 1]) {
+          strings_.push_back(static_cast<Dword>(pos));
+          pos += 2;
+        } else {
+          while (pos < size && data[pos]) {
+            const void* const zero = std::memchr(data + pos, 0, size - pos);
+            if (!zero) {
+              pos = size;
+              break;
+            }
+            strings_.push_back(static_cast<Dword>(pos));
+            pos = static_cast<const Byte*>(zero) - data + 1;
+            ++entry.string_count;
+          }
+          if (pos >= size) {
+            strings_.resize(entry.strings_position);
+            error(Code::unterminated_strings);
+            break;
+          }
+          strings_.push_back(static_cast<Dword>(pos));
+          ++pos;
+        }
+
+        ++type_counts[type];
+        entries_.push_back(entry);
+        offset = pos;
+        if (type == static_cast<Byte>(Structure_type::end_of_table))
+          break;
+      }
+
+      // Sort the entries by type (counting sort preserves the table order).
+      for (std::size_t t{}; t < type_counts.size(); ++t)
+        type_bounds_[t + 1] = type_bounds_[t] + type_counts[t];
+      entries_by_type_.resize(entries_.size());
+      auto positions = type_bounds_;
+      for (std::size_t i{}; i < entries_.size(); ++i) {
+        const auto type = data[entries_[i].offset];
+        entries_by_type_[positions[type]++] = static_cast<Dword>(i);
+      }
+    }
+
+    /// @returns The entries in the order of their appearance in the table.
+    const std::vector<Entry>& entries() const noexcept
+    {
+      return entries_;
+    }
+
+    /// @returns The problems found while building the index.
+    const std::vector<Parse_error>& errors() const noexcept
+    {
+      return errors_;
+    }
+
+    /// @returns The positions of entries of the given `type`.
+    std::pair<const Dword*, const Dword*> positions(const Byte type) const noexcept
+    {
+      const auto* const b = entries_by_type_.data();
+      return {b + type_bounds_[type], b + type_bounds_[type + 1]};
+    }
+
+    /**
+     * @returns The string `idx` of the structure `entry` of the table `data`.
+     *
+     * @par Requires
+     * `(entry && 0 < idx && idx <= entry.string_count)`.
+     */
+    std::string_view string(const Byte* const data, const Entry& entry,
+      const Dword idx) const noexcept
+    {
+      DMITIGR_ASSERT(data);
+      DMITIGR_ASSERT(0 < idx && idx <= entry.string_count);
+      const auto pos = entry.strings_position + idx;
+      const auto offset = strings_[pos - 1];
+      return {reinterpret_cast<const char*>(data + offset),
+        strings_[pos] - offset - 1};
+    }
+
+  private:
+    /// The structures in the order of their appearance in the table.
+    std::vector<Entry> entries_;
+    /**
+     * For each structure: the offsets of its strings followed by the offset
+     * of the byte which follows the terminating zero of its last string.
+     */
+    std::vector<Dword> strings_;
+    /// The positions of `entries_` ordered by structure type.
+    std::vector<Dword> entries_by_type_;
+    /// The bounds of the ranges of `entries_by_type_` indexed by structure type.
+    std::array<Dword, 257> type_bounds_{};
+    /// The problems found while building the index.
+    std::vector<Parse_error> errors_;
+  };
+
+  class Structure_iterator;
+
+  /**
+   * @brief A lightweight reference to a structure of the table.
+   *
+   * @remarks The referenced data must outlive the instances of this class.
+   */
+  class Structure_ref final {
+  public:
+    /// Constructs invalid instance.
+    Structure_ref() = default;
+
+    /// @returns `true` if this instance is valid.
+    explicit operator bool() const noexcept
+    {
+      return ptr_;
+    }
+
+    /// @returns The structure type.
+    Structure_type type() const noexcept
+    {
+      DMITIGR_ASSERT(ptr_);
+      return static_cast<Structure_type>(ptr_[0]);
+    }
+
+    /// @returns The length of the formatted area of the structure.
+    Byte length() const noexcept
+    {
+      DMITIGR_ASSERT(ptr_);
+      return ptr_[1];
+    }
+
+    /// @returns The structure handle.
+    Word handle() const noexcept
+    {
+      DMITIGR_ASSERT(ptr_);
+      Word result;
+      std::memcpy(&result, ptr_ + 2, sizeof(result));
+      return result;
+    }
+
+    /// @returns The raw bytes of the formatted area of the structure.
+    const Byte* data() const noexcept
+    {
+      return ptr_;
+    }
+
+    /**
+     * @returns The string `idx` of the structure, or `std::nullopt` if `idx`
+     * is zero or there is no such a string.
+     *
+     * @remarks The string is found in constant time if the view is indexed.
+     */
+    std::optional<std::string_view> string(const Byte idx) const noexcept
+    {
+      DMITIGR_ASSERT(ptr_);
+      if (!idx)
+        return std::nullopt;
+      else if (entry_)
+        return idx <= entry_->string_count ?
+          std::make_optional(index_->string(table_, *entry_, idx)) : std::nullopt;
+
+      const char* str = unformed_section();
+      const char* const end = reinterpret_cast<const char*>(table_ + table_size_);
+      for (Byte i{1}; str < end && *str; ++i) {
+        const auto* const zero = static_cast<const char*>(
+          std::memchr(str, 0, end - str));
+        if (!zero)
+          break;
+        else if (i == idx)
+          return std::string_view{str, static_cast<std::size_t>(zero - str)};
+        str = zero + 1;
+      }
+      return std::nullopt;
+    }
+
+  private:
+    friend Smbios_view;
+    friend Structure_iterator;
+
+    const Byte* table_{};
+    std::size_t table_size_{};
+    const Index* index_{};
+    const Index::Entry* entry_{};
+    const Byte* ptr_{};
+
+    Structure_ref(const Smbios_view& view, const Byte* const ptr,
+      const Index::Entry* const entry = nullptr) noexcept
+      : table_{view.data_}
+      , table_size_{view.size_}
+      , index_{view.index_}
+      , entry_{entry}
+      , ptr_{ptr}
+    {}
+
+    const char* unformed_section() const noexcept
+    {
+      return reinterpret_cast<const char*>(ptr_) + length();
+    }
+
+    /// @returns The next structure or invalid instance.
+    Structure_ref next() const noexcept
+    {
+      DMITIGR_ASSERT(ptr_);
+      Structure_ref result{*this};
+      if (entry_) {
+        const auto& entries = index_->entries();
+        result.entry_ = entry_ + 1 != entries.data() + entries.size() ?
+          entry_ + 1 : nullptr;
+        result.ptr_ = result.entry_ ? table_ + result.entry_->offset : nullptr;
+        return result;
+      }
+
+      if (type() == Structure_type::end_of_table)
+        return Structure_ref{};
+
+      bool is_prev_char_zero{};
+      const char* const end = reinterpret_cast<const char*>(table_ + table_size_);
+      for (const char* ptr{unformed_section()}; ptr + 1 < end; ++ptr) {
+        if (*ptr == 0) {
+          if (is_prev_char_zero) {
+            result.ptr_ = checked(reinterpret_cast<const Byte*>(ptr + 1),
+              table_ + table_size_);
+            return result.ptr_ ? result : Structure_ref{};
+          } else
+            is_prev_char_zero = true;
+        } else
+          is_prev_char_zero = false;
+      }
+      return Structure_ref{};
+    }
+
+    /**
+     * @returns `ptr` if the structure it points to is entirely within the
+     * table which ends at `end`, or `nullptr` otherwise.
+     */
+    static const Byte* checked(const Byte* const ptr, const Byte* const end) noexcept
+    {
+      DMITIGR_ASSERT(ptr <= end);
+      const auto size = static_cast<std::size_t>(end - ptr);
+      return size >= sizeof(Structure) && ptr[1] >= sizeof(Structure) &&
+        ptr[1] <= size ? ptr : nullptr;
+    }
+  };
+
+  /**
+   * @brief A forward iterator over the structures of the table.
+   *
+   * @details The structures are dereferenced by value, since `Structure_ref`
+   * is a cheap reference to the table. So the result of the dereference
+   * remains valid after the iterator is advanced or destroyed.
+   */
+  class Structure_iterator final {
+  public:
+    /// The result of `operator->()`.
+    class Arrow_proxy final {
+    public:
+      const Structure_ref* operator->() const noexcept
+      {
+        return &ref_;
+      }
+
+    private:
+      friend Structure_iterator;
+
+      Structure_ref ref_;
+
+      explicit Arrow_proxy(const Structure_ref& ref) noexcept
+        : ref_{ref}
+      {}
+    };
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Structure_ref;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Arrow_proxy;
+    using reference = Structure_ref;
+
+    /// Constructs the past-the-end iterator.
+    Structure_iterator() = default;
+
+    reference operator*() const noexcept
+    {
+      return ref_;
+    }
+
+    pointer operator->() const noexcept
+    {
+      return Arrow_proxy{ref_};
+    }
+
+    Structure_iterator& operator++() noexcept
+    {
+      DMITIGR_ASSERT(ref_);
+      if (position_) {
+        if (++position_ != last_position_)
+          ref_.ptr_ = ref_.table_ + (ref_.entry_ =
+            &ref_.index_->entries()[*position_])->offset;
+        else
+          ref_ = Structure_ref{};
+      } else {
+        do {
+          ref_ = ref_.next();
+        } while (ref_ && type_ && ref_.type() != *type_);
+      }
+      return *this;
+    }
+
+    Structure_iterator operator++(int) noexcept
+    {
+      auto result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const Structure_iterator& lhs,
+      const Structure_iterator& rhs) noexcept
+    {
+      return lhs.ref_.data() == rhs.ref_.data();
+    }
+
+    friend bool operator!=(const Structure_iterator& lhs,
+      const Structure_iterator& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+
+  private:
+    friend Smbios_view;
+
+    Structure_ref ref_;
+    std::optional<Structure_type> type_;
+    const Dword* position_{};
+    const Dword* last_position_{};
+  };
+
+  /// A lazy forward range of the structures of the table.
+  class Structure_range final {
+  public:
+    using iterator = Structure_iterator;
+    using const_iterator = Structure_iterator;
+
+    /// Constructs the empty range.
+    Structure_range() = default;
+
+    iterator begin() const noexcept
+    {
+      return first_;
+    }
+
+    iterator end() const noexcept
+    {
+      return {};
+    }
+
+    /// @returns `true` if the range is empty.
+    bool empty() const noexcept
+    {
+      return begin() == end();
+    }
+
+  private:
+    friend Smbios_view;
+
+    Structure_iterator first_;
+
+    explicit Structure_range(Structure_iterator first) noexcept
+      : first_{std::move(first)}
+    {}
+  };
+
+  /**
+   * @brief Constructs the view of `size` bytes of `data`.
+   *
+   * @details If `index` is specified, it's used for the lookups. Otherwise,
+   * the structures are found by walking the table and no memory is allocated.
+   * In either case the structures which are not entirely within the table
+   * are never accessed, and the fields beyond the formatted area of the
+   * structure are treated as not provided.
+   *
+   * @par Requires
+   * `(data && size == header().length)`. If `index` is specified it must be
+   * built on the same data and must outlive the view.
+   */
+  Smbios_view(const Byte* const data, const std::size_t size,
+    const Index* const index = nullptr)
+    : data_{data}
+    , size_{size}
+    , index_{index}
+  {
+    if (!data || size < sizeof(Header) || size != header().length)
+      throw std::invalid_argument{"invalid SMBIOS firmware table provided"};
   }
 
   Header header() const
   {
-    return *reinterpret_cast<const Header*>(data_.data());
+    Header result;
+    std::memcpy(&result, data_, sizeof(result));
+    return result;
   }
 
-  const std::vector<Byte>& raw() const noexcept
+  /// @returns The viewed data.
+  const Byte* data() const noexcept
   {
     return data_;
   }
 
-  Bios_info bios_info() const
+  /// @returns The size of the viewed data.
+  std::size_t size() const noexcept
   {
-    const auto* const s = structure(0);
-    auto result = make_structure<Bios_info>(*s);
-    result.vendor = field<std::optional<std::string>>(s, 0x4);
-    result.version = field<std::optional<std::string>>(s, 0x5);
-    result.release_date = field<std::optional<std::string>>(s, 0x8);
-    result.rom_size = field<Byte>(s, 0x9);
-    return result;
+    return size_;
   }
 
-  Sys_info sys_info() const
+  /// @returns The index, or `nullptr` if the view is not indexed.
+  const Index* index() const noexcept
   {
-    const auto* const s = structure(1);
-    auto result = make_structure<Sys_info>(*s);
-    result.manufacturer = field<std::optional<std::string>>(s, 0x4);
-    result.product = field<std::optional<std::string>>(s, 0x5);
-    result.version = field<std::optional<std::string>>(s, 0x6);
-    result.serial_number = field<std::optional<std::string>>(s, 0x7);
-    result.uuid = field<std::array<Byte, 16>>(s, 0x8);
-    return result;
+    return index_;
   }
 
-  std::optional<Baseboard_info> baseboard_info() const
+  /// @returns The range of all the structures of the table.
+  Structure_range structures() const noexcept
   {
-    const auto* const s = structure(2, true);
-    if (!s)
-      return std::nullopt;
-    auto result = make_structure<Baseboard_info>(*s);
-    result.manufacturer = field<std::optional<std::string>>(s, 0x4);
-    result.product = field<std::optional<std::string>>(s, 0x5);
-    result.version = field<std::optional<std::string>>(s, 0x6);
-    result.serial_number = field<std::optional<std::string>>(s, 0x7);
-    return result;
+    Structure_iterator first;
+    if (index_) {
+      if (!index_->entries().empty())
+        first.ref_ = Structure_ref{*this, data_ + index_->entries()[0].offset,
+          index_->entries().data()};
+    } else if (const auto* const ptr = Structure_ref::checked(
+        data_ + sizeof(Header), data_ + size_))
+      first.ref_ = Structure_ref{*this, ptr};
+    return Structure_range{std::move(first)};
   }
 
-  std::vector<Processor_info> processors_info() const
-  {
-    const auto header = this->header();
-
-    std::vector<Processor_info> result;
-    for (auto* s = first_structure(); s; s = next_structure(s)) {
-      if (s->structure_type != 0x04)
-        continue;
-
-      result.emplace_back(make_structure<Processor_info>(*s));
-      auto& info = result.back();
-
-      if (header.is_version_ge(2,0)) {
-        info.socket = field<decltype(info.socket)>(s, 0x04);
-        info.type = static_cast<decltype(info.type)>(
-          field<std::underlying_type_t<decltype(info.type)>>(s, 0x05)
-        );
-        info.family = static_cast<decltype(info.family)>(field<Byte>(s, 0x06));
-        info.manufacturer = field<decltype(info.manufacturer)>(s, 0x07);
-        info.id = field<decltype(info.id)>(s, 0x08);
-        info.version = field<decltype(info.version)>(s, 0x10);
-        info.voltage = field<decltype(info.voltage)>(s, 0x11);
-        info.external_clock = field<decltype(info.external_clock)>(s, 0x12);
-        info.max_speed = field<decltype(info.max_speed)>(s, 0x14);
-        info.current_speed = field<decltype(info.current_speed)>(s, 0x16);
-        info.status = field<decltype(info.status)>(s, 0x18);
-        info.upgrade = static_cast<decltype(info.upgrade)>(
-          field<std::underlying_type_t<decltype(info.upgrade)>>(s, 0x19)
-        );
+  /**
+   * @returns The range of the structures of the given `type`.
+   *
+   * @remarks The structures are found in constant time if the view is indexed.
+   */
+  Structure_range structures(const Structure_type type) const noexcept
+  {
+    Structure_iterator first;
+    if (index_) {
+      const auto [i, e] = index_->positions(static_cast<Byte>(type));
+      if (i != e) {
+        const auto& entry = index_->entries()[*i];
+        first.ref_ = Structure_ref{*this, data_ + entry.offset, &entry};
+        first.position_ = i;
+        first.last_position_ = e;
       }
+    } else {
+      first = structures().begin();
+      first.type_ = type;
+      if (first.ref_ && first.ref_.type() != type)
+        ++first;
+    }
+    return Structure_range{std::move(first)};
+  }
 
-      if (header.is_version_ge(2,1)) {
-        info.l1_cache_handle = field<decltype(info.l1_cache_handle)>(s, 0x1A);
-        info.l2_cache_handle = field<decltype(info.l2_cache_handle)>(s, 0x1C);
-        info.l3_cache_handle = field<decltype(info.l3_cache_handle)>(s, 0x1E);
-      }
+  /**
+   * @returns BIOS information.
+   *
+   * @tparam String Either `std::string` or `std::string_view`. In the latter
+   * case the strings of the result point to the viewed data.
+   */
+  template<class String = std::string>
+  Basic_bios_info<String> bios_info() const
+  {
+    return decode<Basic_bios_info<String>>(structure(0));
+  }
 
-      if (header.is_version_ge(2,3)) {
-        info.serial_number = field<decltype(info.serial_number)>(s, 0x20);
-        info.asset_tag = field<decltype(info.asset_tag)>(s, 0x21);
-        info.part_number = field<decltype(info.part_number)>(s, 0x22);
-      }
+  /// @returns System information.
+  template<class String = std::string>
+  Basic_sys_info<String> sys_info() const
+  {
+    return decode<Basic_sys_info<String>>(structure(1));
+  }
 
-      if (header.is_version_ge(2,5)) {
-        info.core_count = field<decltype(info.core_count)>(s, 0x23);
-        info.core_enabled = field<decltype(info.core_enabled)>(s, 0x24);
-        info.thread_count = field<decltype(info.thread_count)>(s, 0x25);
-        info.characteristics = field<decltype(info.characteristics)>(s, 0x26);
-      }
+  /// @returns Baseboard information if provided.
+  template<class String = std::string>
+  std::optional<Basic_baseboard_info<String>> baseboard_info() const
+  {
+    if (const auto s = structure(2, true))
+      return decode<Basic_baseboard_info<String>>(s);
+    else
+      return std::nullopt;
+  }
 
-      if (header.is_version_ge(2,6)) {
-        info.family_2 = static_cast<decltype(info.family_2)>(
-          field<std::underlying_type_t<decltype(info.family_2)>>(s, 0x28)
-        );
+  /// @returns System enclosures information.
+  template<class String = std::string>
+  std::vector<Basic_system_enclosure_info<String>> system_enclosures_info() const
+  {
+    auto result = decode_all<Basic_system_enclosure_info<String>>(
+      Structure_type::system_enclosure);
+    if (header().is_version_ge(2,7)) {
+      auto s = structures(Structure_type::system_enclosure).begin();
+      for (auto& info : result) {
+        const auto offset = 0x15 +
+          info.contained_element_count * info.contained_element_record_length;
+        info.sku_number = field<decltype(info.sku_number)>(*s++, offset);
       }
+    }
+    return result;
+  }
 
-      if (header.is_version_ge(3,0)) {
-        info.core_count_2 = field<decltype(info.core_count_2)>(s, 0x2A);
-        info.core_enabled_2 = field<decltype(info.core_enabled_2)>(s, 0x2C);
-        info.thread_count_2 = field<decltype(info.thread_count_2)>(s, 0x2E);
-      }
+  /// @returns Processors information.
+  template<class String = std::string>
+  std::vector<Basic_processor_info<String>> processors_info() const
+  {
+    return decode_all<Basic_processor_info<String>>(
+      Structure_type::processor_information);
+  }
+
+  /// @returns Caches information.
+  template<class String = std::string>
+  std::vector<Basic_cache_info<String>> caches_info() const
+  {
+    return decode_all<Basic_cache_info<String>>(
+      Structure_type::cache_information);
+  }
+
+  /**
+   * @returns Information of the cache identified by `handle` (for example,
+   * `Processor_info::l2_cache_handle`) if provided.
+   */
+  template<class String = std::string>
+  std::optional<Basic_cache_info<String>> cache_info(const Word handle) const
+  {
+    for (const auto& s : structures(Structure_type::cache_information)) {
+      if (s.handle() == handle)
+        return decode<Basic_cache_info<String>>(s);
+    }
+    return std::nullopt;
+  }
 
-      if (header.is_version_ge(3,6)) {
-        info.thread_enabled = field<decltype(info.thread_enabled)>(s, 0x30);
+  /// @returns System slots information.
+  template<class String = std::string>
+  std::vector<Basic_system_slot_info<String>> system_slots_info() const
+  {
+    auto result = decode_all<Basic_system_slot_info<String>>(
+      Structure_type::system_slots);
+    if (header().is_version_ge(3,4)) {
+      const bool is_35{header().is_version_ge(3,5)};
+      auto s = structures(Structure_type::system_slots).begin();
+      for (auto& info : result) {
+        // The fields which follow the peer groups of 5 bytes each.
+        const auto offset = 0x13 + info.peer_grouping_count * 5;
+        info.slot_information = field<Byte>(*s, offset);
+        info.slot_physical_width = field<Byte>(*s, offset + 1);
+        info.slot_pitch = field<Word>(*s, offset + 2);
+        if (is_35)
+          info.slot_height = field<Byte>(*s, offset + 4);
+        ++s;
       }
     }
     return result;
   }
 
+  /// @returns Physical memory arrays information.
+  std::vector<Memory_array_info> memory_arrays_info() const
+  {
+    return decode_all<Memory_array_info>(Structure_type::physical_memory_array);
+  }
+
+  /// @returns Memory devices information.
+  template<class String = std::string>
+  std::vector<Basic_memory_device_info<String>> memory_devices_info() const
+  {
+    return decode_all<Basic_memory_device_info<String>>(
+      Structure_type::memory_device);
+  }
+
+  /// @returns Memory array mapped addresses information.
+  std::vector<Memory_array_mapped_address_info>
+  memory_array_mapped_addresses_info() const
+  {
+    return decode_all<Memory_array_mapped_address_info>(
+      Structure_type::memory_array_mapped_address);
+  }
+
+  /// @returns IPMI device information if provided.
+  std::optional<Ipmi_device_info> ipmi_device_info() const
+  {
+    if (const auto s = structure(38, true))
+      return decode<Ipmi_device_info>(s);
+    else
+      return std::nullopt;
+  }
+
 private:
-  std::vector<Byte> data_;
+  const Byte* data_{};
+  std::size_t size_{};
+  const Index* index_{};
 
-  Smbios_table() = default;
+  // ---------------------------------------------------------------------------
+  // Field descriptors
+  // ---------------------------------------------------------------------------
+
+  template<typename T, bool = std::is_enum_v<T>>
+  struct Raw_field_type final {
+    using Type = T;
+  };
+
+  template<typename T>
+  struct Raw_field_type<T, true> final {
+    using Type = std::underlying_type_t<T>;
+  };
+
+  /**
+   * A descriptor of the field of the formatted area of structure `S`, which
+   * is stored as `R` at `offset` and provided since SMBIOS `version`.
+   */
+  template<class S, typename T, typename R>
+  struct Field final {
+    using Raw = R;
+    T S::* member{};
+    Byte offset{};
+    Word version{};
+  };
+
+  template<typename R = void, class S, typename T>
+  static constexpr auto make_field(T S::* const member, const Byte offset,
+    const Byte major_version = 2, const Byte minor_version = 0) noexcept
+  {
+    using Raw = std::conditional_t<std::is_void_v<R>,
+      typename Raw_field_type<T>::Type, R>;
+    return Field<S, T, Raw>{member, offset,
+      static_cast<Word>(major_version << 8 | minor_version)};
+  }
+
+  template<class>
+  struct Fields_tag final {};
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_bios_info<String>>) noexcept
+  {
+    using S = Basic_bios_info<String>;
+    return std::make_tuple(
+      make_field(&S::vendor, 0x04),
+      make_field(&S::version, 0x05),
+      make_field(&S::release_date, 0x08),
+      make_field(&S::rom_size, 0x09));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_sys_info<String>>) noexcept
+  {
+    using S = Basic_sys_info<String>;
+    return std::make_tuple(
+      make_field(&S::manufacturer, 0x04),
+      make_field(&S::product, 0x05),
+      make_field(&S::version, 0x06),
+      make_field(&S::serial_number, 0x07),
+      make_field<std::array<Byte, 16>>(&S::uuid, 0x08));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_baseboard_info<String>>) noexcept
+  {
+    using S = Basic_baseboard_info<String>;
+    return std::make_tuple(
+      make_field(&S::manufacturer, 0x04),
+      make_field(&S::product, 0x05),
+      make_field(&S::version, 0x06),
+      make_field(&S::serial_number, 0x07));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_system_enclosure_info<String>>) noexcept
+  {
+    using S = Basic_system_enclosure_info<String>;
+    return std::make_tuple(
+      make_field(&S::manufacturer, 0x04),
+      make_field(&S::type, 0x05),
+      make_field(&S::version, 0x06),
+      make_field(&S::serial_number, 0x07),
+      make_field(&S::asset_tag, 0x08),
+      make_field(&S::boot_up_state, 0x09, 2,1),
+      make_field(&S::power_supply_state, 0x0A, 2,1),
+      make_field(&S::thermal_state, 0x0B, 2,1),
+      make_field(&S::security_status, 0x0C, 2,1),
+      make_field(&S::oem_defined, 0x0D, 2,3),
+      make_field(&S::height, 0x11, 2,3),
+      make_field(&S::power_cord_count, 0x12, 2,3),
+      make_field(&S::contained_element_count, 0x13, 2,3),
+      make_field(&S::contained_element_record_length, 0x14, 2,3));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_processor_info<String>>) noexcept
+  {
+    using S = Basic_processor_info<String>;
+    return std::make_tuple(
+      make_field(&S::socket, 0x04),
+      make_field(&S::type, 0x05),
+      make_field<Byte>(&S::family, 0x06),
+      make_field(&S::manufacturer, 0x07),
+      make_field(&S::id, 0x08),
+      make_field(&S::version, 0x10),
+      make_field(&S::voltage, 0x11),
+      make_field(&S::external_clock, 0x12),
+      make_field(&S::max_speed, 0x14),
+      make_field(&S::current_speed, 0x16),
+      make_field(&S::status, 0x18),
+      make_field(&S::upgrade, 0x19),
+      make_field(&S::l1_cache_handle, 0x1A, 2,1),
+      make_field(&S::l2_cache_handle, 0x1C, 2,1),
+      make_field(&S::l3_cache_handle, 0x1E, 2,1),
+      make_field(&S::serial_number, 0x20, 2,3),
+      make_field(&S::asset_tag, 0x21, 2,3),
+      make_field(&S::part_number, 0x22, 2,3),
+      make_field(&S::core_count, 0x23, 2,5),
+      make_field(&S::core_enabled, 0x24, 2,5),
+      make_field(&S::thread_count, 0x25, 2,5),
+      make_field(&S::characteristics, 0x26, 2,5),
+      make_field(&S::family_2, 0x28, 2,6),
+      make_field(&S::core_count_2, 0x2A, 3,0),
+      make_field(&S::core_enabled_2, 0x2C, 3,0),
+      make_field(&S::thread_count_2, 0x2E, 3,0),
+      make_field(&S::thread_enabled, 0x30, 3,6));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_cache_info<String>>) noexcept
+  {
+    using S = Basic_cache_info<String>;
+    return std::make_tuple(
+      make_field(&S::socket_designation, 0x04),
+      make_field(&S::configuration, 0x05),
+      make_field(&S::maximum_size, 0x07),
+      make_field(&S::installed_size, 0x09),
+      make_field(&S::supported_sram_type, 0x0B),
+      make_field(&S::current_sram_type, 0x0D),
+      make_field(&S::speed, 0x0F, 2,1),
+      make_field(&S::error_correction_type, 0x10, 2,1),
+      make_field(&S::system_cache_type, 0x11, 2,1),
+      make_field(&S::associativity, 0x12, 2,1),
+      make_field(&S::maximum_size_2, 0x13, 3,1),
+      make_field(&S::installed_size_2, 0x17, 3,1));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_system_slot_info<String>>) noexcept
+  {
+    using S = Basic_system_slot_info<String>;
+    return std::make_tuple(
+      make_field(&S::designation, 0x04),
+      make_field(&S::type, 0x05),
+      make_field(&S::data_bus_width, 0x06),
+      make_field(&S::current_usage, 0x07),
+      make_field(&S::length, 0x08),
+      make_field(&S::id, 0x09),
+      make_field(&S::characteristics_1, 0x0B),
+      make_field(&S::characteristics_2, 0x0C, 2,1),
+      make_field(&S::segment_group_number, 0x0D, 2,6),
+      make_field(&S::bus_number, 0x0F, 2,6),
+      make_field(&S::device_function_number, 0x10, 2,6),
+      make_field(&S::data_bus_width_base, 0x11, 3,2),
+      make_field(&S::peer_grouping_count, 0x12, 3,2));
+  }
+
+  static constexpr auto fields(Fields_tag<Memory_array_info>) noexcept
+  {
+    using S = Memory_array_info;
+    return std::make_tuple(
+      make_field(&S::location, 0x04, 2,1),
+      make_field(&S::use, 0x05, 2,1),
+      make_field(&S::error_correction, 0x06, 2,1),
+      make_field(&S::maximum_capacity, 0x07, 2,1),
+      make_field(&S::error_information_handle, 0x0B, 2,1),
+      make_field(&S::memory_device_count, 0x0D, 2,1),
+      make_field(&S::extended_maximum_capacity, 0x0F, 2,7));
+  }
+
+  template<class String>
+  static constexpr auto fields(Fields_tag<Basic_memory_device_info<String>>) noexcept
+  {
+    using S = Basic_memory_device_info<String>;
+    return std::make_tuple(
+      make_field(&S::memory_array_handle, 0x04, 2,1),
+      make_field(&S::error_information_handle, 0x06, 2,1),
+      make_field(&S::total_width, 0x08, 2,1),
+      make_field(&S::data_width, 0x0A, 2,1),
+      make_field(&S::size, 0x0C, 2,1),
+      make_field(&S::form_factor, 0x0E, 2,1),
+      make_field(&S::device_set, 0x0F, 2,1),
+      make_field(&S::device_locator, 0x10, 2,1),
+      make_field(&S::bank_locator, 0x11, 2,1),
+      make_field(&S::memory_type, 0x12, 2,1),
+      make_field(&S::type_detail, 0x13, 2,1),
+      make_field(&S::speed, 0x15, 2,3),
+      make_field(&S::manufacturer, 0x17, 2,3),
+      make_field(&S::serial_number, 0x18, 2,3),
+      make_field(&S::asset_tag, 0x19, 2,3),
+      make_field(&S::part_number, 0x1A, 2,3),
+      make_field(&S::attributes, 0x1B, 2,6),
+      make_field(&S::extended_size, 0x1C, 2,7),
+      make_field(&S::configured_memory_speed, 0x20, 2,7),
+      make_field(&S::minimum_voltage, 0x22, 2,8),
+      make_field(&S::maximum_voltage, 0x24, 2,8),
+      make_field(&S::configured_voltage, 0x26, 2,8),
+      make_field(&S::memory_technology, 0x28, 3,2),
+      make_field(&S::memory_operating_mode_capability, 0x29, 3,2),
+      make_field(&S::firmware_version, 0x2B, 3,2),
+      make_field(&S::module_manufacturer_id, 0x2C, 3,2),
+      make_field(&S::module_product_id, 0x2E, 3,2),
+      make_field(&S::memory_subsystem_controller_manufacturer_id, 0x30, 3,2),
+      make_field(&S::memory_subsystem_controller_product_id, 0x32, 3,2),
+      make_field(&S::non_volatile_size, 0x34, 3,2),
+      make_field(&S::volatile_size, 0x3C, 3,2),
+      make_field(&S::cache_size, 0x44, 3,2),
+      make_field(&S::logical_size, 0x4C, 3,2),
+      make_field(&S::extended_speed, 0x54, 3,3),
+      make_field(&S::extended_configured_memory_speed, 0x58, 3,3));
+  }
 
+  static constexpr auto fields(Fields_tag<Memory_array_mapped_address_info>) noexcept
+  {
+    using S = Memory_array_mapped_address_info;
+    return std::make_tuple(
+      make_field(&S::starting_address, 0x04, 2,1),
+      make_field(&S::ending_address, 0x08, 2,1),
+      make_field(&S::memory_array_handle, 0x0C, 2,1),
+      make_field(&S::partition_width, 0x0E, 2,1),
+      make_field(&S::extended_starting_address, 0x0F, 2,7),
+      make_field(&S::extended_ending_address, 0x17, 2,7));
+  }
+
+  static constexpr auto fields(Fields_tag<Ipmi_device_info>) noexcept
+  {
+    using S = Ipmi_device_info;
+    return std::make_tuple(
+      make_field(&S::interface_type, 0x04),
+      make_field(&S::specification_revision, 0x05),
+      make_field(&S::i2c_target_address, 0x06),
+      make_field(&S::nv_storage_device_address, 0x07),
+      make_field(&S::base_address, 0x08),
+      make_field(&S::base_address_modifier, 0x10),
+      make_field(&S::interrupt_number, 0x11));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Decoding
+  // ---------------------------------------------------------------------------
+
+  /**
+   * @returns The structure `S` decoded from `s` according to the field
+   * descriptors of `S`.
+   *
+   * @details The descriptors are expanded at compile time, so each field is
+   * decoded by a fixed-size copy guarded by the version and length checks.
+   */
   template<class S>
-  static S make_structure(const Structure& s)
+  S decode(const Structure_ref& s) const
   {
-    static_assert(std::is_base_of_v<Structure, S>);
-    S result;
-    result.structure_type = s.structure_type;
-    result.structure_length = s.structure_length;
-    result.structure_handle = s.structure_handle;
+    static constexpr auto descriptors = fields(Fields_tag<S>{});
+    const auto h = header();
+    const Word version = static_cast<Word>(h.major_version << 8 | h.minor_version);
+    auto result = make_structure<S>(s);
+    std::apply([&result, &s, version](const auto&... descriptor)
+    {
+      (decode_field(result, s, version, descriptor), ...);
+    }, descriptors);
     return result;
   }
 
-  const Structure* structure(const Byte type,
-    const bool no_throw_if_not_found = false) const
+  template<class S, typename T, typename R>
+  static void decode_field(S& result, const Structure_ref& s, const Word version,
+    const Field<S, T, R>& descriptor)
   {
-    for (auto* s = first_structure(); s; s = next_structure(s)) {
-      if (s->structure_type == type)
-        return s;
-    }
-    if (no_throw_if_not_found)
-      return nullptr;
-    else
-      throw std::runtime_error{"no BIOS information structure of type "
-        +std::to_string(type)+" found in SMBIOS"};
+    if (version >= descriptor.version)
+      result.*descriptor.member = static_cast<T>(field<R>(s, descriptor.offset));
   }
 
-  static const char* unformed_section(const Structure* const s) noexcept
+  /// @returns The decoded structures of the given `type`.
+  template<class S>
+  std::vector<S> decode_all(const Structure_type type) const
   {
-    DMITIGR_ASSERT(s);
-    return reinterpret_cast<const char*>(s) + s->structure_length;
+    std::vector<S> result;
+    if (index_) {
+      const auto [i, e] = index_->positions(static_cast<Byte>(type));
+      result.reserve(e - i);
+    }
+    for (const auto& s : structures(type))
+      result.push_back(decode<S>(s));
+    return result;
   }
 
-  const Structure* first_structure() const noexcept
+  template<class S>
+  static S make_structure(const Structure_ref& s)
   {
-    return reinterpret_cast<const Structure*>(data_.data() + sizeof(Header));
+    static_assert(std::is_base_of_v<Structure, S>);
+    DMITIGR_ASSERT(s);
+    S result;
+    result.structure_type = static_cast<Byte>(s.type());
+    result.structure_length = s.length();
+    result.structure_handle = s.handle();
+    return result;
   }
 
-  const Structure* next_structure(const Structure* const s) const noexcept
+  Structure_ref structure(const Byte type,
+    const bool no_throw_if_not_found = false) const
   {
-    DMITIGR_ASSERT(s);
-    bool is_prev_char_zero{};
-    const std::ptrdiff_t length = data_.size() - sizeof(Header);
-    const auto* const fst = first_structure();
-    for (const char* ptr{unformed_section(s)};
-         ptr + 1 - reinterpret_cast<const char*>(fst) < length; ++ptr) {
-      if (*ptr == 0) {
-        if (is_prev_char_zero)
-          return reinterpret_cast<const Structure*>(ptr + 1);
-        else
-          is_prev_char_zero = true;
-      } else
-        is_prev_char_zero = false;
-    }
-    return nullptr;
+    if (const auto range = structures(Structure_type{type}); !range.empty())
+      return *range.begin();
+    else if (no_throw_if_not_found)
+      return Structure_ref{};
+    else
+      throw std::runtime_error{"no BIOS information structure of type "
+        +std::to_string(type)+" found in SMBIOS"};
   }
 
   template<typename T>
-  static T field(const Structure* const s, const std::ptrdiff_t offset)
+  static T field(const Structure_ref& s, const std::ptrdiff_t offset)
   {
+    DMITIGR_ASSERT(s);
     DMITIGR_ASSERT(offset >= 0x0);
     using Dt = std::decay_t<T>;
-    const Byte* const ptr = reinterpret_cast<const Byte*>(s) + offset;
-    if constexpr (std::is_same_v<Dt, std::optional<std::string>>) {
-      const int idx = *ptr;
-      if (!idx)
+    constexpr bool is_string = std::is_same_v<Dt, std::optional<std::string>> ||
+      std::is_same_v<Dt, std::optional<std::string_view>>;
+
+    // The fields beyond the formatted area are treated as not provided.
+    constexpr std::size_t field_size = is_string ? sizeof(Byte) : sizeof(Dt);
+    if (static_cast<std::size_t>(offset) + field_size > s.length())
+      return Dt{};
+
+    const Byte* const ptr = s.data() + offset;
+    if constexpr (is_string) {
+      using String = typename Dt::value_type;
+      if (const auto result = s.string(*ptr))
+        return String{*result};
+      else
         return std::nullopt;
-      const char* str = unformed_section(s);
-      for (int i{1}; i < idx; ++i) {
-        std::string_view view{str};
-        str = view.data() + view.size() + 1;
-        DMITIGR_ASSERT(*str != 0);
-      }
-      return std::string{str};
     } else if constexpr (Is_std_array<Dt>::value) {
       using V = typename Dt::value_type;
       if constexpr (std::is_same_v<V, Byte>) {
@@ -739,12 +1813,301 @@ private:
     } else if constexpr (
       std::is_same_v<Dt, Byte>  || std::is_same_v<Dt, Word> ||
       std::is_same_v<Dt, Dword> || std::is_same_v<Dt, Qword>) {
-      return *reinterpret_cast<const Dt*>(ptr);
+      Dt result;
+      std::memcpy(&result, ptr, sizeof(result));
+      return result;
     } else
       static_assert(false_value<T>, "unsupported type");
   }
 };
 
+// -----------------------------------------------------------------------------
+// Smbios_table
+// -----------------------------------------------------------------------------
+
+/// SMBIOS table.
+class Smbios_table final {
+public:
+  using Byte = Smbios_view::Byte;
+  using Word = Smbios_view::Word;
+  using Dword = Smbios_view::Dword;
+  using Qword = Smbios_view::Qword;
+  using Header = Smbios_view::Header;
+  using Structure = Smbios_view::Structure;
+  using Structure_type = Smbios_view::Structure_type;
+  using Structure_ref = Smbios_view::Structure_ref;
+  using Structure_iterator = Smbios_view::Structure_iterator;
+  using Structure_range = Smbios_view::Structure_range;
+  using Parse_error = Smbios_view::Parse_error;
+  using Processor_type = Smbios_view::Processor_type;
+  using Processor_upgrade = Smbios_view::Processor_upgrade;
+  using Processor_family = Smbios_view::Processor_family;
+  template<class String>
+  using Basic_bios_info = Smbios_view::Basic_bios_info<String>;
+  using Bios_info = Smbios_view::Bios_info;
+  using Bios_info_view = Smbios_view::Bios_info_view;
+  template<class String>
+  using Basic_sys_info = Smbios_view::Basic_sys_info<String>;
+  using Sys_info = Smbios_view::Sys_info;
+  using Sys_info_view = Smbios_view::Sys_info_view;
+  template<class String>
+  using Basic_baseboard_info = Smbios_view::Basic_baseboard_info<String>;
+  using Baseboard_info = Smbios_view::Baseboard_info;
+  using Baseboard_info_view = Smbios_view::Baseboard_info_view;
+  template<class String>
+  using Basic_processor_info = Smbios_view::Basic_processor_info<String>;
+  using Processor_info = Smbios_view::Processor_info;
+  using Processor_info_view = Smbios_view::Processor_info_view;
+  template<class String>
+  using Basic_system_enclosure_info = Smbios_view::Basic_system_enclosure_info<String>;
+  using System_enclosure_info = Smbios_view::System_enclosure_info;
+  using System_enclosure_info_view = Smbios_view::System_enclosure_info_view;
+  template<class String>
+  using Basic_cache_info = Smbios_view::Basic_cache_info<String>;
+  using Cache_info = Smbios_view::Cache_info;
+  using Cache_info_view = Smbios_view::Cache_info_view;
+  template<class String>
+  using Basic_system_slot_info = Smbios_view::Basic_system_slot_info<String>;
+  using System_slot_info = Smbios_view::System_slot_info;
+  using System_slot_info_view = Smbios_view::System_slot_info_view;
+  using Memory_array_info = Smbios_view::Memory_array_info;
+  template<class String>
+  using Basic_memory_device_info = Smbios_view::Basic_memory_device_info<String>;
+  using Memory_device_info = Smbios_view::Memory_device_info;
+  using Memory_device_info_view = Smbios_view::Memory_device_info_view;
+  using Memory_array_mapped_address_info = Smbios_view::Memory_array_mapped_address_info;
+  using Ipmi_device_info = Smbios_view::Ipmi_device_info;
+
+  /// Constructs the copy of `size` bytes of `data`.
+  Smbios_table(const Byte* const data, const std::size_t size)
+    : Smbios_table{Smbios_view{data, size}}
+  {}
+
+  /// Constructs the copy of the data of `view`.
+  explicit Smbios_table(const Smbios_view& view)
+    : data_(view.data(), view.data() + view.size())
+    , index_{data_.data(), data_.size()}
+  {}
+
+  /**
+   * @returns The SMBIOS table of the system.
+   *
+   * @remarks On Linux, the table is read from sysfs directly into the buffer
+   * allocated once, without any intermediate copies.
+   */
+  static Smbios_table from_system()
+  {
+    Smbios_table result;
+    auto& rd = result.data_;
+#ifdef _WIN32
+    rd.resize(GetSystemFirmwareTable('RSMB', 0, nullptr, 0));
+    if (rd.empty() || !GetSystemFirmwareTable('RSMB', 0, rd.data(), rd.size()))
+      throw winbase::Sys_exception{"cannot get SMBIOS firmware table"};
+    else if (rd.size() < sizeof(Header))
+      throw std::runtime_error{"cannot get SMBIOS table: invalid size"};
+
+    // RawSMBIOSData::Length doesn't include the header, so normalize it like
+    // on Linux to denote the size of the whole table.
+    {
+      const auto length = static_cast<Dword>(rd.size());
+      std::memcpy(rd.data() + offsetof(Header, length), &length, sizeof(length));
+    }
+#elif __linux__
+    // Read entry point as Header.
+    {
+      constexpr const char* entry_point_path{"/sys/firmware/dmi/tables/"
+        "smbios_entry_point"};
+      const auto entry_point = posix::open(entry_point_path);
+      constexpr const std::size_t sm2_entry_point_size{31};
+      constexpr const std::size_t sm3_entry_point_size{24};
+      std::array<char, std::max(sm2_entry_point_size, sm3_entry_point_size)> header;
+      const auto entry_point_size = posix::pread_full(entry_point,
+        header.data(), header.size());
+      if (entry_point_size < 0)
+        throw Sys_exception{std::string{"cannot read "}+entry_point_path};
+      else if (static_cast<std::size_t>(entry_point_size) <
+        std::min(sm2_entry_point_size, sm3_entry_point_size))
+        throw std::runtime_error{"cannot get SMBIOS table: invalid entry point"};
+      constexpr const std::string_view sm2_anchor{"_SM_"};
+      constexpr const std::string_view sm3_anchor{"_SM3_"};
+      Header h;
+      if (std::string_view{header.data(), sm2_anchor.size()} == sm2_anchor) {
+        h.major_version = header[0x06];
+        h.minor_version = header[0x07];
+        h.dmi_revision = header[0x0A];
+      } else if (std::string_view{header.data(), sm3_anchor.size()} == sm3_anchor) {
+        h.major_version = header[0x07];
+        h.minor_version = header[0x08];
+        h.dmi_revision = header[0x0A];
+      } else
+        throw std::runtime_error{"cannot get SMBIOS table: unsupported version"};
+      h.used_20_calling_method = 0;
+      rd.resize(sizeof(Header));
+      std::memcpy(rd.data(), &h, sizeof(h));
+    }
+
+    // Read DMI (SMBIOS Structure Table) right after header and complete it.
+    {
+      constexpr const char* dmi_path{"/sys/firmware/dmi/tables/DMI"};
+      const auto dmi = posix::open(dmi_path);
+      DMITIGR_ASSERT(rd.size() == sizeof(Header));
+      posix::read_all(dmi, rd);
+      const auto length = static_cast<Dword>(rd.size());
+      std::memcpy(rd.data() + offsetof(Header, length), &length, sizeof(length));
+    }
+#else
+    #error Unsupported OS family
+#endif
+    result.index_ = Smbios_view::Index{rd.data(), rd.size()};
+    return result;
+  }
+
+  /**
+   * @returns The process-wide snapshot of the SMBIOS table of the system.
+   *
+   * @details The snapshot is created by `from_system()` on the first call
+   * (in a thread-safe manner) and is never changed after that, so the
+   * subsequent calls involve neither I/O nor locking. If the first call
+   * throws, the next one retries.
+   */
+  static const Smbios_table& system()
+  {
+    static const Smbios_table result{from_system()};
+    return result;
+  }
+
+  Header header() const
+  {
+    return view().header();
+  }
+
+  const std::vector<Byte>& raw() const noexcept
+  {
+    return data_;
+  }
+
+  /**
+   * @returns The problems found while validating the table on construction.
+   *
+   * @remarks The malformed structure and the structures which follow it are
+   * ignored by the accessors.
+   */
+  const std::vector<Parse_error>& errors() const noexcept
+  {
+    return index_.errors();
+  }
+
+  /// @returns The indexed view of this table.
+  Smbios_view view() const
+  {
+    return Smbios_view{data_.data(), data_.size(), &index_};
+  }
+
+  /// @returns The range of all the structures of the table.
+  Structure_range structures() const
+  {
+    return view().structures();
+  }
+
+  /// @returns The range of the structures of the given `type`.
+  Structure_range structures(const Structure_type type) const
+  {
+    return view().structures(type);
+  }
+
+  /**
+   * @returns BIOS information.
+   *
+   * @see Smbios_view::bios_info().
+   */
+  template<class String = std::string>
+  Basic_bios_info<String> bios_info() const
+  {
+    return view().bios_info<String>();
+  }
+
+  /// @returns System information.
+  template<class String = std::string>
+  Basic_sys_info<String> sys_info() const
+  {
+    return view().sys_info<String>();
+  }
+
+  /// @returns Baseboard information if provided.
+  template<class String = std::string>
+  std::optional<Basic_baseboard_info<String>> baseboard_info() const
+  {
+    return view().baseboard_info<String>();
+  }
+
+  /// @returns Processors information.
+  template<class String = std::string>
+  std::vector<Basic_processor_info<String>> processors_info() const
+  {
+    return view().processors_info<String>();
+  }
+
+  /// @returns System enclosures information.
+  template<class String = std::string>
+  std::vector<Basic_system_enclosure_info<String>> system_enclosures_info() const
+  {
+    return view().system_enclosures_info<String>();
+  }
+
+  /// @returns Caches information.
+  template<class String = std::string>
+  std::vector<Basic_cache_info<String>> caches_info() const
+  {
+    return view().caches_info<String>();
+  }
+
+  /// @returns Information of the cache identified by `handle` if provided.
+  template<class String = std::string>
+  std::optional<Basic_cache_info<String>> cache_info(const Word handle) const
+  {
+    return view().cache_info<String>(handle);
+  }
+
+  /// @returns System slots information.
+  template<class String = std::string>
+  std::vector<Basic_system_slot_info<String>> system_slots_info() const
+  {
+    return view().system_slots_info<String>();
+  }
+
+  /// @returns Physical memory arrays information.
+  std::vector<Memory_array_info> memory_arrays_info() const
+  {
+    return view().memory_arrays_info();
+  }
+
+  /// @returns Memory devices information.
+  template<class String = std::string>
+  std::vector<Basic_memory_device_info<String>> memory_devices_info() const
+  {
+    return view().memory_devices_info<String>();
+  }
+
+  /// @returns Memory array mapped addresses information.
+  std::vector<Memory_array_mapped_address_info>
+  memory_array_mapped_addresses_info() const
+  {
+    return view().memory_array_mapped_addresses_info();
+  }
+
+  /// @returns IPMI device information if provided.
+  std::optional<Ipmi_device_info> ipmi_device_info() const
+  {
+    return view().ipmi_device_info();
+  }
+
+private:
+  std::vector<Byte> data_;
+  Smbios_view::Index index_;
+
+  Smbios_table() = default;
+};
+
 } // namespace dmitigr::os::firmware
 
 #endif  // DMITIGR_OS_SMBIOS_HPP
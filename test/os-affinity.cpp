@@ -0,0 +1,106 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../affinity.hpp"
+
+#include <future>
+#include <iostream>
+#include <thread>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+
+    // Cpu_set.
+    {
+      os::Cpu_set set{0, 3, 64, 1023};
+      ASSERT(set.count() == 4);
+      ASSERT(set.test(3) && set.test(64) && !set.test(1) && !set.test(5000));
+      ASSERT(set.cpus() == (std::vector<unsigned>{0, 3, 64, 1023}));
+      set.reset(3);
+      ASSERT(set.count() == 3 && !set.test(3));
+      set &= os::Cpu_set{0, 1};
+      ASSERT(set == os::Cpu_set{0});
+      set |= os::Cpu_set{2};
+      ASSERT(set == (os::Cpu_set{0, 2}));
+      set.clear();
+      ASSERT(set.empty());
+
+      // The mask covers all the possible CPUs and grows on demand.
+      ASSERT(set.max_size() >= CPU_SETSIZE);
+      ASSERT(set.native_size() == CPU_ALLOC_SIZE(set.max_size()));
+      os::Cpu_set big{1, 5000};
+      ASSERT(big.test(5000) && big.max_size() > 5000);
+      ASSERT(big.native_size() == CPU_ALLOC_SIZE(big.max_size()));
+      ASSERT(big != os::Cpu_set{1});
+      big.reset(5000);
+      ASSERT(big == os::Cpu_set{1} && os::Cpu_set{1} == big);
+      set |= os::Cpu_set{4096};
+      ASSERT(set.cpus() == std::vector<unsigned>{4096});
+      set &= os::Cpu_set{0};
+      ASSERT(set.empty());
+    }
+
+    const auto& topology = os::cpu_topology();
+    const auto initial = os::thread_affinity();
+    ASSERT(!initial.empty());
+    ASSERT(os::process_affinity() == os::process_affinity(os::pid()));
+
+    // Pinning of the calling thread.
+    const auto first = initial.cpus().front();
+    os::pin_thread_to_cpu(first);
+    ASSERT(os::thread_affinity() == os::Cpu_set{first});
+    os::pin_thread_to_core(topology.cpu(first)->core);
+    ASSERT(os::thread_affinity().test(first));
+    os::pin_thread_to_node(topology.cpu(first)->node);
+    ASSERT(os::thread_affinity().test(first));
+    os::set_thread_affinity(initial);
+    ASSERT(os::thread_affinity() == initial);
+
+    // Pinning of other thread (which is kept alive until the checks are done).
+    {
+      std::promise<void> release;
+      std::thread thread{[done = release.get_future()]{done.wait();}};
+      os::set_thread_affinity(thread.native_handle(), os::Cpu_set{first});
+      ASSERT(os::thread_affinity(thread.native_handle()) == os::Cpu_set{first});
+      release.set_value();
+      thread.join();
+    }
+
+    // Pinning of the process.
+    {
+      os::set_process_affinity(os::Cpu_set{first});
+      ASSERT(os::thread_affinity() == os::Cpu_set{first});
+      os::set_process_affinity(initial);
+      ASSERT(os::thread_affinity() == initial);
+    }
+
+    // Planning.
+    {
+      const auto per_core = os::one_thread_per_core();
+      ASSERT(per_core.size() == topology.cores().size());
+      for (const auto& set : per_core)
+        ASSERT(set.count() == 1);
+      const auto spread = os::spread_across_node(0, 2 * topology.cpus().size());
+      ASSERT(spread.size() == 2 * topology.cpus().size());
+      ASSERT(spread.front() == spread[topology.nodes()[0].cpu_count]);
+    }
+
+    // Errors.
+    try {
+      os::set_thread_affinity(os::Cpu_set{});
+      ASSERT(false);
+    } catch (const os::Sys_exception& e) {
+      std::cout << e.what() << ": " << e.condition().message() << std::endl;
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
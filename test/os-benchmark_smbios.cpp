@@ -0,0 +1,134 @@
+// -*- C++ -*-
+//
+// Benchmark of SMBIOS table parsing on synthetic tables of various sizes.
+//
+// Usage: os-benchmark_smbios [seconds_per_case]
+
+#include "../../base/assert.hpp"
+#include "../smbios.hpp"
+#include "os-smbios_fixture.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define ASSERT DMITIGR_ASSERT
+
+namespace {
+
+namespace chrono = std::chrono;
+namespace fw = dmitigr::os::firmware;
+namespace test = dmitigr::os::test;
+
+double seconds_per_case{.05};
+
+/// Prevents the optimizer from discarding `value`.
+template<typename T>
+void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static const void* volatile sink;
+  sink = &value;
+#endif
+}
+
+/// Prints the mean time of `fn()` in nanoseconds.
+template<typename F>
+void measure(const std::string& name, const test::Smbios_spec& spec, F&& fn)
+{
+  using Clock = chrono::steady_clock;
+  std::size_t iteration_count{};
+  const auto started = Clock::now();
+  auto elapsed = Clock::duration{};
+  do {
+    for (std::size_t i{}; i < 16; ++i)
+      fn();
+    iteration_count += 16;
+    elapsed = Clock::now() - started;
+  } while (chrono::duration<double>(elapsed).count() < seconds_per_case);
+  const auto ns = chrono::duration<double, std::nano>(elapsed).count() /
+    iteration_count;
+  std::cout << std::left << std::setw(28) << name
+            << " cpus=" << std::setw(4) << spec.processor_count
+            << " dimms=" << std::setw(5) << spec.memory_device_count
+            << " strlen=" << std::setw(4) << spec.string_size
+            << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+            << ns << " ns" << std::endl;
+}
+
+void run(const test::Smbios_spec& spec)
+{
+  const auto data = test::make_smbios_table(spec);
+  const fw::Smbios_table table{data.data(), data.size()};
+  const fw::Smbios_view view{data.data(), data.size()};
+  ASSERT(table.errors().empty());
+  ASSERT(table.processors_info().size() == spec.processor_count);
+
+  measure("load (copy + index)", spec, [&]
+  {
+    keep(fw::Smbios_table{data.data(), data.size()});
+  });
+  measure("sys_info", spec, [&]{keep(table.sys_info());});
+  measure("sys_info<string_view>", spec, [&]
+  {
+    keep(table.sys_info<std::string_view>());
+  });
+  measure("processors_info", spec, [&]{keep(table.processors_info());});
+  measure("processors_info<string_view>", spec, [&]
+  {
+    keep(table.processors_info<std::string_view>());
+  });
+  measure("view processors_info", spec, [&]
+  {
+    keep(view.processors_info<std::string_view>());
+  });
+  measure("memory_devices_info", spec, [&]
+  {
+    keep(table.memory_devices_info<std::string_view>());
+  });
+  measure("caches_info", spec, [&]
+  {
+    keep(table.caches_info<std::string_view>());
+  });
+  const auto walk = [](const auto& structures)
+  {
+    std::size_t result{};
+    for (const auto& s : structures) {
+      for (fw::Smbios_view::Byte i{1}; const auto str = s.string(i); ++i)
+        result += str->size();
+    }
+    keep(result);
+  };
+  measure("walk indexed", spec, [&]{walk(table.structures());});
+  measure("walk view", spec, [&]{walk(view.structures());});
+}
+
+} // namespace
+
+int main(const int argc, const char* const argv[])
+{
+  try {
+    if (argc > 1)
+      seconds_per_case = std::atof(argv[1]);
+
+    for (const unsigned processor_count : {1, 4, 16, 64, 256})
+      run(test::Smbios_spec{3, 6, processor_count, 16, 16});
+    for (const unsigned memory_device_count : {0, 64, 256, 1024})
+      run(test::Smbios_spec{3, 6, 2, memory_device_count, 16});
+    for (const std::size_t string_size : {1, 32, 128, 255})
+      run(test::Smbios_spec{3, 6, 2, 16, string_size});
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
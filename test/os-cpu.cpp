@@ -0,0 +1,232 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../cpu.hpp"
+#include "os-smbios_fixture.hpp"
+
+#include <iostream>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace fw = dmitigr::os::firmware;
+    namespace os = dmitigr::os;
+    namespace test = dmitigr::os::test;
+    using std::cout;
+    using std::endl;
+
+    // Parsing.
+    ASSERT(os::detail::to_size("48K") == 48 * 1024);
+    ASSERT(os::detail::to_size("2M") == 2 * 1024 * 1024);
+    ASSERT(!os::detail::to_size("K"));
+    ASSERT(os::detail::to_cpu_list("0-2,5,7-8") ==
+      (std::vector<unsigned>{0, 1, 2, 5, 7, 8}));
+    ASSERT(os::detail::to_cpu_list("")->empty());
+    ASSERT(!os::detail::to_cpu_list("3-1"));
+
+    // Synthetic topology: 2 packages of 8 cores of 2 SMT siblings, and the
+    // nodes 0 and 2.
+    {
+      std::vector<os::detail::Raw_cpu> raw;
+      for (unsigned thread{}; thread < 2; ++thread) {
+        for (unsigned package{}; package < 2; ++package) {
+          for (unsigned core{}; core < 8; ++core)
+            raw.push_back({thread * 16 + package * 8 + core, package, core,
+              package * 8 + core, package * 2});
+        }
+      }
+      const auto topology = os::detail::make_cpu_topology(raw,
+        {{0, {10, 21}}, {2, {21, 10}}});
+      ASSERT(topology.cpus().size() == 32);
+      ASSERT(topology.cores().size() == 16);
+      ASSERT(topology.packages().size() == 2);
+      for (unsigned p{}; p < 2; ++p) {
+        const auto& package = topology.packages()[p];
+        ASSERT(package.id == p);
+        ASSERT(package.core_count == 8 && package.cpu_count == 16);
+        unsigned c{};
+        for (const auto& core : topology.cores(package)) {
+          ASSERT(core.id == c && core.package == p);
+          const auto siblings = topology.cpus(core);
+          ASSERT(siblings.size() == 2);
+          ASSERT(siblings[0] == p * 8 + c && siblings[1] == 16 + p * 8 + c);
+          ++c;
+        }
+      }
+      const auto* const cpu = topology.cpu(25);
+      ASSERT(cpu && cpu->id == 25 && cpu->package == 1 && cpu->node == 1);
+      ASSERT(topology.cores()[cpu->core].id == 1);
+      ASSERT(!topology.cpu(32));
+
+      ASSERT(topology.nodes().size() == 2);
+      ASSERT(topology.nodes()[0].id == 0 && topology.nodes()[1].id == 2);
+      const auto node_cpus = topology.cpus(topology.nodes()[1]);
+      ASSERT(node_cpus.size() == 16);
+      for (const auto id : node_cpus)
+        ASSERT(topology.cpu(id)->package == 1);
+      ASSERT(topology.distance(0, 0) == 10 && topology.distance(1, 1) == 10);
+      ASSERT(topology.distance(0, 1) == 21 && topology.distance(1, 0) == 21);
+
+      // Mismatches with the synthetic SMBIOS table.
+      test::Smbios_spec spec;
+      spec.processor_count = 2;
+      auto data = test::make_smbios_table(spec);
+      {
+        const fw::Smbios_table table{data.data(), data.size()};
+        ASSERT(topology.mismatches(table.view()).empty());
+      }
+      data = test::make_smbios_table(test::Smbios_spec{});
+      {
+        const fw::Smbios_table table{data.data(), data.size()};
+        const auto mismatches = topology.mismatches(table.view());
+        ASSERT(mismatches.size() == 1);
+        ASSERT(mismatches[0].code ==
+          os::Cpu_topology::Mismatch::Code::package_count);
+        ASSERT(mismatches[0].firmware_value == 1);
+        ASSERT(mismatches[0].system_value == 2);
+      }
+      raw.pop_back(); // the second sibling of the last core of package 1
+      const auto degraded = os::detail::make_cpu_topology(raw,
+        {{0, {10, 21}}, {2, {21, 10}}});
+      ASSERT(degraded.packages()[1].cpu_count == 15);
+      data = test::make_smbios_table(spec);
+      {
+        const fw::Smbios_table table{data.data(), data.size()};
+        const auto mismatches = degraded.mismatches(table.view());
+        ASSERT(mismatches.size() == 1);
+        ASSERT(mismatches[0].code ==
+          os::Cpu_topology::Mismatch::Code::thread_count);
+        ASSERT(mismatches[0].package == 1);
+        ASSERT(mismatches[0].firmware_value == 16);
+        ASSERT(mismatches[0].system_value == 15);
+      }
+    }
+
+    // Synthetic topology: 1 package of 2 dies with the same core ids.
+    {
+      std::vector<os::detail::Raw_cpu> raw;
+      for (unsigned id{}; id < 8; ++id)
+        raw.push_back({id, 0, id % 4, id, 0});
+      const auto topology = os::detail::make_cpu_topology(raw, {});
+      ASSERT(topology.packages().size() == 1);
+      ASSERT(topology.packages()[0].core_count == 8);
+      ASSERT(topology.cores().size() == 8);
+      for (unsigned i{}; i < 8; ++i) {
+        const auto& core = topology.cores()[i];
+        ASSERT(core.id == i % 4);
+        ASSERT(topology.cpus(core).size() == 1 && topology.cpus(core)[0] == i);
+      }
+    }
+
+    // Caches of the system.
+    {
+      cout << "Caches of CPU 0:" << endl;
+      const auto caches = os::cpu_caches();
+      for (const auto& cache : caches) {
+        ASSERT(cache.level > 0);
+        cout << "  L" << cache.level << " type " << static_cast<int>(cache.type)
+             << ": size " << cache.size << ", line " << cache.line_size
+             << ", ways " << cache.associativity << ", shared by "
+             << cache.shared_cpus.size() << " CPUs"
+             << (cache.firmware_info ? ", SMBIOS" : "") << endl;
+      }
+      for (std::size_t i{1}; i < caches.size(); ++i)
+        ASSERT(caches[i - 1].level <= caches[i].level);
+      if (const auto llc = os::last_level_cache())
+        ASSERT(llc->level == caches.back().level);
+    }
+
+    // Selection of the SMBIOS processor by the package position.
+    {
+      using os::detail::Package_position;
+      test::Smbios_spec spec;
+      spec.processor_count = 2;
+      const auto data = test::make_smbios_table(spec);
+      const fw::Smbios_table table{data.data(), data.size()};
+      const auto view = table.view();
+      const auto caches = os::detail::smbios_caches(view,
+        Package_position{1, 2});
+      ASSERT(caches.size() == 3);
+      for (const auto& cache : caches)
+        ASSERT(cache.socket_designation->find("-Cache1") != std::string::npos);
+      ASSERT(os::detail::smbios_caches(view,
+          Package_position{0, 2}).size() == 3);
+      ASSERT(os::detail::smbios_caches(view, Package_position{0, 1}).empty());
+      ASSERT(os::detail::smbios_caches(view, Package_position{2, 3}).empty());
+      ASSERT(os::detail::smbios_caches(view, std::nullopt).empty());
+
+      const auto data_1 = test::make_smbios_table(test::Smbios_spec{});
+      const fw::Smbios_table table_1{data_1.data(), data_1.size()};
+      ASSERT(os::detail::smbios_caches(table_1.view(),
+          std::nullopt).size() == 3);
+    }
+
+    // Caches fused with the synthetic SMBIOS table.
+    {
+      test::Smbios_spec spec;
+      if (const auto position = os::detail::package_position(0))
+        spec.processor_count = position->count;
+      const auto data = test::make_smbios_table(spec);
+      const fw::Smbios_table table{data.data(), data.size()};
+      const auto view = table.view();
+      const auto caches = os::cpu_caches(0, &view);
+      ASSERT(!caches.empty());
+      for (const auto& cache : caches) {
+        if (cache.level <= 3) {
+          ASSERT(cache.firmware_info);
+          ASSERT(cache.firmware_info->level() == cache.level);
+        }
+      }
+    }
+
+    // Topology of the system.
+    {
+      const auto& topology = os::cpu_topology();
+      ASSERT(&topology == &os::cpu_topology());
+      ASSERT(!topology.cpus().empty());
+      ASSERT(!topology.nodes().empty());
+      cout << "Topology: " << topology.packages().size() << " packages, "
+           << topology.cores().size() << " cores, "
+           << topology.cpus().size() << " CPUs, "
+           << topology.nodes().size() << " nodes" << endl;
+      std::size_t cpu_count{};
+      for (const auto& package : topology.packages()) {
+        for (const auto& core : topology.cores(package)) {
+          for (const auto id : topology.cpus(core)) {
+            const auto* const cpu = topology.cpu(id);
+            ASSERT(cpu);
+            ASSERT(&topology.cores()[cpu->core] == &core);
+            ASSERT(&topology.packages()[cpu->package] == &package);
+            ++cpu_count;
+          }
+        }
+      }
+      ASSERT(cpu_count == topology.cpus().size());
+      cpu_count = 0;
+      for (std::size_t i{}; i < topology.nodes().size(); ++i) {
+        ASSERT(topology.distance(i, i) == 10);
+        for (const auto id : topology.cpus(topology.nodes()[i]))
+          ASSERT(topology.cpu(id)->node == i);
+        cpu_count += topology.nodes()[i].cpu_count;
+      }
+      ASSERT(cpu_count == topology.cpus().size());
+
+      // Cross-check with the synthetic SMBIOS table.
+      const auto data = test::make_smbios_table(test::Smbios_spec{});
+      const fw::Smbios_table table{data.data(), data.size()};
+      for (const auto& mismatch : topology.mismatches(table.view()))
+        cout << "  mismatch " << static_cast<int>(mismatch.code)
+             << " of package " << mismatch.package << ": firmware "
+             << mismatch.firmware_value << ", system "
+             << mismatch.system_value << endl;
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
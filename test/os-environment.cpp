@@ -0,0 +1,211 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../environment.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    using std::cout;
+    using std::endl;
+
+    // Current username.
+    const auto name = os::current_username();
+    ASSERT(!name.empty());
+    ASSERT(os::current_username_cached() == name);
+    ASSERT(&os::current_username_cached() == &os::current_username_cached());
+    cout << "Current username: " << name << endl;
+
+#ifndef _WIN32
+    // Caller-supplied buffer.
+    {
+      char buf[4096];
+      ASSERT(os::current_username(buf, sizeof(buf)) == name);
+
+      char tiny[1];
+      try {
+        os::current_username(tiny, sizeof(tiny));
+        ASSERT(false);
+      } catch (const os::Sys_exception& e) {
+        ASSERT(e.condition() == std::errc::result_out_of_range);
+      }
+
+      // Unknown user is represented by its ID.
+      const uid_t nobody = 4000000000U;
+      ASSERT(os::username(nobody, buf, sizeof(buf)) == "4000000000");
+      ASSERT(os::username(nobody) == "4000000000");
+    }
+
+    // Bulk resolution.
+    {
+      os::Username_resolver resolver{2};
+      ASSERT(resolver.capacity() == 2);
+      ASSERT(resolver.name(0) == os::username(0));
+      ASSERT(resolver.name(4000000001U) == "4000000001");
+      ASSERT(resolver.size() == 2);
+      ASSERT(resolver.name(0) == os::username(0)); // touch 0
+      ASSERT(resolver.name(4000000002U) == "4000000002"); // evicts 4000000001
+      ASSERT(resolver.size() == 2);
+      const auto names = resolver.names({4000000002U, 0, 4000000001U});
+      ASSERT(names.size() == 3);
+      ASSERT(names[0] == "4000000002");
+      ASSERT(names[1] == os::username(0));
+      ASSERT(names[2] == "4000000001");
+      ASSERT(resolver.size() == 2);
+      resolver.clear();
+      ASSERT(!resolver.size());
+    }
+#endif
+
+    // Parsers.
+    {
+      using std::chrono::nanoseconds;
+      using namespace std::chrono_literals;
+      ASSERT(os::detail::to_integer<int>("-42") == -42);
+      ASSERT(os::detail::to_integer<int>("+42") == 42);
+      ASSERT(os::detail::to_integer<unsigned>("0x1F") == 31u);
+      ASSERT(!os::detail::to_integer<unsigned>("-1"));
+      ASSERT(!os::detail::to_integer<int>(""));
+      ASSERT(!os::detail::to_integer<int>("4x"));
+      ASSERT(!os::detail::to_integer<std::int8_t>("128"));
+      ASSERT(os::detail::to_bool("Yes") == true);
+      ASSERT(os::detail::to_bool("off") == false);
+      ASSERT(!os::detail::to_bool("maybe"));
+      ASSERT(os::detail::to_duration("250ms") == nanoseconds{250ms});
+      ASSERT(os::detail::to_duration("30") == nanoseconds{30s});
+      ASSERT(os::detail::to_duration("2min") == nanoseconds{2min});
+      ASSERT(os::detail::to_duration("1h") == nanoseconds{1h});
+      ASSERT(!os::detail::to_duration("ms"));
+      ASSERT(!os::detail::to_duration("10parsecs"));
+      ASSERT(!os::detail::to_duration("1000000d"));
+      ASSERT(os::detail::to_byte_size("64K") == 65536u);
+      ASSERT(os::detail::to_byte_size("2GiB") == 2ULL << 30);
+      ASSERT(os::detail::to_byte_size("512") == 512u);
+      ASSERT(!os::detail::to_byte_size("1X"));
+      ASSERT(!os::detail::to_byte_size("100000000000T"));
+    }
+
+    // Environment snapshot.
+    {
+      const auto set = &os::set_environment_variable;
+      set("DMITIGR_OS_TEST_INT", "-17");
+      set("DMITIGR_OS_TEST_BOOL", "on");
+      set("DMITIGR_OS_TEST_DURATION", "5s");
+      set("DMITIGR_OS_TEST_SIZE", "16M");
+      set("DMITIGR_OS_TEST_BAD", "x");
+
+      os::Environment_snapshot env;
+      ASSERT(!env.is_empty());
+      for (std::size_t i = 1; i < env.size(); ++i)
+        ASSERT(env.name(i - 1) <= env.name(i));
+      const auto index = env.find("DMITIGR_OS_TEST_INT");
+      ASSERT(index);
+      ASSERT(env.entry(*index) == "DMITIGR_OS_TEST_INT=-17");
+      ASSERT(env.value("DMITIGR_OS_TEST_INT") == "-17");
+      ASSERT(env.integer<int>("DMITIGR_OS_TEST_INT") == -17);
+      ASSERT(env.boolean("DMITIGR_OS_TEST_BOOL") == true);
+      ASSERT(env.duration("DMITIGR_OS_TEST_DURATION") == std::chrono::seconds{5});
+      ASSERT(env.byte_size("DMITIGR_OS_TEST_SIZE") == 16u << 20);
+      ASSERT(!env.contains("DMITIGR_OS_TEST_NONE"));
+      ASSERT(!env.integer<int>("DMITIGR_OS_TEST_NONE"));
+      try {
+        env.integer<int>("DMITIGR_OS_TEST_BAD");
+        ASSERT(false);
+      } catch (const std::runtime_error&) {}
+      if (const auto path = os::environment_variable("PATH"))
+        ASSERT(env.value("PATH") == *path);
+
+      // Refresh.
+      set("DMITIGR_OS_TEST_INT", "18");
+      ASSERT(env.integer<int>("DMITIGR_OS_TEST_INT") == -17);
+      env.refresh();
+      ASSERT(env.integer<int>("DMITIGR_OS_TEST_INT") == 18);
+      os::unset_environment_variable("DMITIGR_OS_TEST_INT");
+      ASSERT(!os::environment_variable("DMITIGR_OS_TEST_INT"));
+      try {
+        set("A=B", "C");
+        ASSERT(false);
+      } catch (const std::invalid_argument&) {}
+    }
+
+    // Concurrent mutation and refresh.
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]
+        {
+          const auto variable = "DMITIGR_OS_TEST_THREAD" + std::to_string(t);
+          os::Environment_snapshot env;
+          for (int i = 0; i < 200; ++i) {
+            os::set_environment_variable(variable, std::to_string(i));
+            env.refresh();
+            ASSERT(env.integer<int>(variable) == i);
+          }
+          os::unset_environment_variable(variable);
+        });
+      }
+      for (auto& thread : threads)
+        thread.join();
+    }
+
+    // Child environment.
+    {
+      os::set_environment_variable("DMITIGR_OS_TEST_KEEP", "1");
+      os::set_environment_variable("DMITIGR_OS_TEST_DROP", "1");
+      os::set_environment_variable("DMITIGR_OS_TEST_CHANGE", "1");
+      const os::Environment_snapshot env;
+      os::Environment_builder builder{env};
+      builder.unset("DMITIGR_OS_TEST_DROP")
+        .set("DMITIGR_OS_TEST_CHANGE", "2")
+        .set("DMITIGR_OS_TEST_ADD", "3")
+        .set("AAA_DMITIGR_OS_TEST_FIRST", "")
+        .unset("DMITIGR_OS_TEST_ABSENT");
+      const auto block = builder.build();
+      ASSERT(block.size() == env.size() + 1);
+      std::size_t count{};
+      for (auto e = block.envp(); *e; ++e)
+        ++count;
+      ASSERT(count == block.size());
+      const auto has = [&block](const std::string_view entry)
+      {
+        for (std::size_t i = 0; i < block.size(); ++i)
+          if (block[i] == entry)
+            return true;
+        return false;
+      };
+      ASSERT(has("DMITIGR_OS_TEST_KEEP=1"));
+      ASSERT(!has("DMITIGR_OS_TEST_DROP=1"));
+      ASSERT(has("DMITIGR_OS_TEST_CHANGE=2"));
+      ASSERT(!has("DMITIGR_OS_TEST_CHANGE=1"));
+      ASSERT(has("DMITIGR_OS_TEST_ADD=3"));
+      ASSERT(has("AAA_DMITIGR_OS_TEST_FIRST="));
+      for (std::size_t i = 1; i < block.size(); ++i) {
+        const auto name_of = [](const std::string_view e)
+        {
+          return e.substr(0, e.find('='));
+        };
+        ASSERT(name_of(block[i - 1]) < name_of(block[i]));
+      }
+
+      const auto empty = os::Environment_builder{}.set("X", "y").build();
+      ASSERT(empty.size() == 1 && empty[0] == "X=y" && !empty.envp()[1]);
+      ASSERT(!os::Environment_block{}.size());
+      ASSERT(!*os::Environment_block{}.envp());
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "unknown error" << std::endl;
+    return 2;
+  }
+}
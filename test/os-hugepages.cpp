@@ -0,0 +1,70 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../hugepages.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    using std::cout;
+    using std::endl;
+
+    // Pools.
+    {
+      const auto pools = os::hugepage_pools();
+      for (const auto& pool : pools) {
+        ASSERT(pool.page_size > os::page_size(os::Page_kind::normal));
+        ASSERT(pool.free <= pool.total + pool.surplus);
+        cout << "Pool of " << pool.page_size << " bytes: " << pool.total
+             << " total, " << pool.free << " free, " << pool.reserved
+             << " reserved, " << pool.surplus << " surplus" << endl;
+      }
+      for (std::size_t i{1}; i < pools.size(); ++i)
+        ASSERT(pools[i - 1].page_size < pools[i].page_size);
+
+      const auto meminfo = os::hugepage_meminfo();
+      cout << "Default pool: " << meminfo.default_pool.page_size << " bytes, "
+           << meminfo.default_pool.total << " total; hugetlb "
+           << meminfo.hugetlb << " bytes, anon huge " << meminfo.anon_huge
+           << " bytes" << endl;
+      if (!pools.empty())
+        ASSERT(meminfo.default_pool.page_size);
+      cout << "THP mode: " << os::Large_buffer::transparent_hugepage_mode()
+           << endl;
+    }
+
+    // Allocation.
+    for (const auto kind : {os::Page_kind::huge_1g, os::Page_kind::huge_2m,
+        os::Page_kind::transparent_huge, os::Page_kind::normal}) {
+      const std::size_t size{3 * 1024 * 1024 + 1};
+      os::Large_buffer buffer{size, kind};
+      ASSERT(buffer);
+      ASSERT(buffer.kind() <= kind);
+      ASSERT(buffer.size() >= size);
+      ASSERT(buffer.size() % os::page_size(buffer.kind()) == 0);
+      ASSERT(reinterpret_cast<std::uintptr_t>(buffer.data()) %
+        os::page_size(buffer.kind()) == 0);
+      std::memset(buffer.data(), 1, size);
+      cout << "Preferred " << static_cast<int>(kind) << ", got "
+           << static_cast<int>(buffer.kind()) << endl;
+
+      os::Large_buffer other{std::move(buffer)};
+      ASSERT(!buffer && other);
+      buffer = std::move(other);
+      ASSERT(buffer && !other);
+      ASSERT(buffer.unmap() && !buffer);
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
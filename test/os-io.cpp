@@ -0,0 +1,253 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../io.hpp"
+#include "../ipc_pipe.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#define ASSERT DMITIGR_ASSERT
+
+namespace os = dmitigr::os;
+namespace io = dmitigr::os::io;
+namespace posix = dmitigr::os::posix;
+
+void test(io::Engine& engine)
+{
+  char path[] = "/tmp/dmitigr_os_io_XXXXXX";
+  const posix::Fd_guard file{::mkstemp(path)};
+  ASSERT(file.fd() != -1);
+  ::unlink(path);
+
+  // Batch of writes and reads at offsets.
+  {
+    constexpr std::size_t count{64};
+    constexpr std::size_t size{4096};
+    std::vector<std::string> blocks;
+    for (std::size_t i{}; i < count; ++i)
+      blocks.emplace_back(size, static_cast<char>('a' + i % 26));
+    std::size_t written{};
+    for (std::size_t i{}; i < count; ++i) {
+      engine.write({file, false, blocks[i].data(), size, -1,
+          static_cast<std::int64_t>(i * size)},
+        [&written](const std::error_code error, const std::size_t n)
+        {
+          ASSERT(!error && n == size);
+          ++written;
+        });
+    }
+    ASSERT(engine.pending() == count);
+    engine.run();
+    ASSERT(written == count && !engine.pending());
+
+    std::vector<std::string> read_blocks(count, std::string(size, '\0'));
+    std::size_t read{};
+    for (std::size_t i{}; i < count; ++i) {
+      engine.read({file, false, read_blocks[i].data(), size, -1,
+          static_cast<std::int64_t>(i * size)},
+        [&read](const std::error_code error, const std::size_t n)
+        {
+          ASSERT(!error && n == size);
+          ++read;
+        });
+    }
+    engine.run();
+    ASSERT(read == count && read_blocks == blocks);
+  }
+
+  // Fixed file and registered buffer.
+  {
+    std::vector<char> buffer(4096);
+    engine.register_files({file});
+    engine.register_buffers({{buffer.data(), buffer.size()}});
+    bool is_done{};
+    engine.read({0, true, buffer.data(), buffer.size(), 0, 4096},
+      [&](const std::error_code error, const std::size_t n)
+      {
+        ASSERT(!error && n == buffer.size());
+        ASSERT(buffer.front() == 'b' && buffer.back() == 'b');
+        is_done = true;
+      });
+    engine.run();
+    ASSERT(is_done);
+    engine.register_buffers({});
+    engine.register_files({});
+  }
+
+  // Pipe, chained operations and the end of file.
+  {
+    auto pipe = os::ipc::Pipe::make();
+    std::string received(5, '\0');
+    const std::string message{"hello"};
+    std::size_t eof_count{};
+    engine.read({pipe.reader(), false, received.data(), received.size()},
+      [&](const std::error_code error, const std::size_t n)
+      {
+        ASSERT(!error && n == message.size());
+        // Chained read gets the end of file.
+        engine.read({pipe.reader(), false, received.data(), received.size()},
+          [&](const std::error_code eof_error, const std::size_t eof_size)
+          {
+            ASSERT(!eof_error && !eof_size);
+            ++eof_count;
+          });
+      });
+    ASSERT(!engine.poll());
+    engine.write({pipe.writer(), false, const_cast<char*>(message.data()),
+        message.size()},
+      [&](const std::error_code error, const std::size_t n)
+      {
+        ASSERT(!error && n == message.size());
+        pipe.close_writer();
+      });
+    engine.run();
+    ASSERT(received == message && eof_count == 1);
+  }
+
+  // Errors.
+  {
+    auto pipe = os::ipc::Pipe::make();
+    char c;
+    std::error_code error;
+    engine.read({pipe.writer(), false, &c, 1},
+      [&error](const std::error_code e, std::size_t){error = e;});
+    engine.run();
+    ASSERT(error == std::errc::bad_file_descriptor);
+  }
+
+  // Completion of the operations on the ready descriptor without waiting.
+  {
+    auto pipe = os::ipc::Pipe::make();
+    ASSERT(::write(pipe.writer(), "xy", 2) == 2);
+    char c{};
+    std::size_t events{};
+    engine.read({pipe.reader(), false, &c, 1},
+      [](const std::error_code error, const std::size_t n)
+      {
+        ASSERT(!error && n == 1);
+      });
+    engine.wait_readable({pipe.reader()},
+      [&events](const std::error_code error, const std::size_t revents)
+      {
+        ASSERT(!error);
+        events = revents;
+      });
+    for (int i{}; i < 1000 && engine.pending(); ++i)
+      engine.poll();
+    ASSERT(!engine.pending());
+    ASSERT(c == 'x' && (events & POLLIN));
+  }
+
+  // Readability.
+  {
+    auto pipe = os::ipc::Pipe::make();
+    std::size_t events{};
+    engine.wait_readable({pipe.reader()},
+      [&events](const std::error_code error, const std::size_t revents)
+      {
+        ASSERT(!error);
+        events = revents;
+      });
+    ASSERT(!engine.wait(std::chrono::milliseconds{10}));
+    ASSERT(::write(pipe.writer(), "x", 1) == 1);
+    engine.run();
+    ASSERT(events & POLLIN);
+  }
+
+  // Timeout.
+  {
+    auto pipe = os::ipc::Pipe::make();
+    char c;
+    engine.read({pipe.reader(), false, &c, 1},
+      [](const std::error_code, std::size_t){});
+    ASSERT(!engine.wait(std::chrono::milliseconds{10}));
+    ASSERT(engine.pending() == 1);
+    pipe.close_writer();
+    engine.run();
+  }
+
+  // Throwing callback.
+  {
+    const std::string data{"data"};
+    std::size_t count{};
+    for (int i{}; i < 2; ++i) {
+      engine.write({file, false, const_cast<char*>(data.data()), data.size()},
+        [&count, &data](const std::error_code error, const std::size_t n)
+        {
+          ASSERT(!error && n == data.size());
+          if (!count++)
+            throw std::runtime_error{"callback"};
+        });
+    }
+    try {
+      engine.run();
+      ASSERT(false);
+    } catch (const std::runtime_error&) {}
+    ASSERT(count == 1 && engine.pending() == 1);
+    engine.run();
+    ASSERT(count == 2 && !engine.pending());
+  }
+
+  // Reentrant callback.
+  {
+    const std::string data{"data"};
+    std::vector<int> counts(3);
+    for (std::size_t i{}; i < counts.size(); ++i) {
+      engine.write({file, false, const_cast<char*>(data.data()), data.size()},
+        [&engine, &counts, &data, i](const std::error_code error,
+          const std::size_t n)
+        {
+          ASSERT(!error && n == data.size());
+          ++counts[i];
+          engine.run();
+        });
+    }
+    engine.run();
+    ASSERT(counts == std::vector<int>(counts.size(), 1));
+    ASSERT(!engine.pending());
+  }
+}
+
+int main()
+{
+  try {
+    {
+      io::Engine engine;
+      std::cout << "Default backend: "
+                << (engine.backend() == io::Backend::io_uring ? "io_uring" :
+                  "epoll") << std::endl;
+      test(engine);
+    }
+    {
+      io::Engine engine{256, io::Backend::epoll, 2};
+      ASSERT(engine.backend() == io::Backend::epoll);
+      test(engine);
+    }
+
+    // Fallback when the ring cannot be locked in memory (before Linux 5.12).
+    {
+      ::rlimit old_limit{};
+      ASSERT(!::getrlimit(RLIMIT_MEMLOCK, &old_limit));
+      auto limit = old_limit;
+      limit.rlim_cur = 0;
+      ASSERT(!::setrlimit(RLIMIT_MEMLOCK, &limit));
+      {
+        io::Engine engine;
+        test(engine);
+      }
+      ASSERT(!::setrlimit(RLIMIT_MEMLOCK, &old_limit));
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,170 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../ipc_pipe.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    namespace ipc = dmitigr::os::ipc;
+    namespace posix = dmitigr::os::posix;
+
+    const auto read_string = [](const int fd, const std::size_t size)
+    {
+      std::string result(size, '\0');
+      ASSERT(::read(fd, result.data(), size) == static_cast<ssize_t>(size));
+      return result;
+    };
+    const auto make_temp_file = []
+    {
+      char path[] = "/tmp/dmitigr_os_ipc_pipe_XXXXXX";
+      posix::Fd_guard result{::mkstemp(path)};
+      ASSERT(result.fd() != -1);
+      ::unlink(path);
+      return result;
+    };
+
+    // Anonymous pipe.
+    {
+      auto pipe = ipc::Pipe::make();
+      ASSERT(pipe.reader().fd() != -1 && pipe.writer().fd() != -1);
+      ASSERT(!ipc::is_nonblocking(pipe.reader()));
+      ASSERT(::write(pipe.writer(), "abc", 3) == 3);
+      ASSERT(read_string(pipe.reader(), 3) == "abc");
+
+      // Capacity.
+      const auto capacity = pipe.set_capacity(1 << 20);
+      ASSERT(capacity >= 1 << 20 || capacity == pipe.capacity());
+      ASSERT(pipe.capacity() == capacity);
+
+      // Nonblocking mode.
+      pipe.set_nonblocking();
+      ASSERT(ipc::is_nonblocking(pipe.reader()));
+      char c;
+      ASSERT(::read(pipe.reader(), &c, 1) == -1 && errno == EAGAIN);
+      ASSERT(!ipc::splice(pipe.reader(), make_temp_file(), 1));
+      pipe.set_nonblocking(false);
+      ASSERT(!ipc::is_nonblocking(pipe.writer()));
+
+      // End of file.
+      const auto writer = pipe.release_writer();
+      ASSERT(pipe.writer().fd() == -1 && writer.fd() != -1);
+      pipe.close_reader();
+      ASSERT(pipe.reader().fd() == -1);
+    }
+
+    // vmsplice and tee.
+    {
+      auto first = ipc::Pipe::make();
+      auto second = ipc::Pipe::make();
+      const std::string data{"zero-copy"};
+      ASSERT(ipc::vmsplice(first.writer(), data.data(), data.size()) ==
+        data.size());
+      ASSERT(ipc::tee(first.reader(), second.writer(), data.size()) ==
+        data.size());
+      ASSERT(read_string(first.reader(), data.size()) == data);
+      ASSERT(read_string(second.reader(), data.size()) == data);
+    }
+
+    // Transfer between files (via the intermediate pipe) and pipes.
+    {
+      std::string data(3 * 1024 * 1024 + 7, '\0');
+      for (std::size_t i{}; i < data.size(); ++i)
+        data[i] = static_cast<char>(i % 251);
+      const auto source = make_temp_file();
+      ASSERT(::write(source, data.data(), data.size()) ==
+        static_cast<ssize_t>(data.size()));
+      ASSERT(::lseek(source, 0, SEEK_SET) == 0);
+
+      const auto destination = make_temp_file();
+      ASSERT(ipc::transfer(source, destination) == data.size());
+      ASSERT(::lseek(destination, 0, SEEK_SET) == 0);
+
+      auto pipe = ipc::Pipe::make();
+      std::thread writer{[&destination, &pipe, size = data.size()]
+      {
+        ASSERT(ipc::transfer(destination, pipe.writer(), size - 7) ==
+          size - 7);
+        pipe.close_writer();
+      }};
+      std::string result;
+      result.resize(data.size());
+      std::size_t offset{};
+      while (const auto n = ::read(pipe.reader(), result.data() + offset,
+          result.size() - offset)) {
+        ASSERT(n > 0);
+        offset += n;
+      }
+      writer.join();
+      ASSERT(offset == data.size() - 7);
+      ASSERT(!result.compare(0, offset, data, 0, offset));
+
+      // Positioned splice.
+      auto pipe2 = ipc::Pipe::make();
+      ::loff_t in_offset{5};
+      ASSERT(ipc::splice(source, &in_offset, pipe2.writer(), nullptr, 3) == 3);
+      ASSERT(in_offset == 8);
+      ASSERT(read_string(pipe2.reader(), 3) == data.substr(5, 3));
+    }
+
+    // Transfer to the file opened with O_APPEND (which can't be spliced).
+    {
+      std::string data(100000, '\0');
+      for (std::size_t i{}; i < data.size(); ++i)
+        data[i] = static_cast<char>(i % 251);
+      const auto source = make_temp_file();
+      ASSERT(::write(source, data.data(), data.size()) ==
+        static_cast<ssize_t>(data.size()));
+      ASSERT(::lseek(source, 0, SEEK_SET) == 0);
+
+      char path[] = "/tmp/dmitigr_os_ipc_pipe_XXXXXX";
+      posix::Fd_guard destination{::mkstemp(path)};
+      ASSERT(destination.fd() != -1);
+      ASSERT(::write(destination, "head", 4) == 4);
+      posix::Fd_guard appender{::open(path, O_WRONLY | O_APPEND)};
+      ::unlink(path);
+      ASSERT(appender.fd() != -1);
+      ASSERT(ipc::transfer(source, appender) == data.size());
+      ASSERT(::lseek(source, 0, SEEK_CUR) ==
+        static_cast<off_t>(data.size()));
+      std::string result(4 + data.size(), '\0');
+      ASSERT(::pread(destination, result.data(), result.size(), 0) ==
+        static_cast<ssize_t>(result.size()));
+      ASSERT(result == "head" + data);
+    }
+
+    // Named pipe.
+    {
+      const std::string path{"/tmp/dmitigr_os_ipc_pipe_fifo_"+
+        std::to_string(::getpid())};
+      ASSERT(ipc::make_fifo(path));
+      ASSERT(!ipc::make_fifo(path));
+      try {
+        ipc::open_fifo(path, O_WRONLY | O_NONBLOCK);
+        ASSERT(false);
+      } catch (const os::Sys_exception& e) {
+        ASSERT(e.condition() == std::errc::no_such_device_or_address);
+      }
+      const auto reader = ipc::open_fifo(path, O_RDONLY | O_NONBLOCK);
+      const auto writer = ipc::open_fifo(path, O_WRONLY);
+      ASSERT(::write(writer, "fifo", 4) == 4);
+      ASSERT(read_string(reader, 4) == "fifo");
+      ::unlink(path.c_str());
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
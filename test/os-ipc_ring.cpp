@@ -0,0 +1,144 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../ipc_ring.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace ipc = dmitigr::os::ipc;
+    using namespace std::chrono_literals;
+    using std::string_view;
+
+    // Basics.
+    {
+      auto ring = ipc::Spsc_shm_ring::make(3, 16);
+      ASSERT(ring);
+      ASSERT(ring.capacity() == 4);
+      ASSERT(ring.message_size() == 16);
+      ASSERT(ring.try_publish("one"));
+      const string_view batch[]{"two", "three", "four", "five"};
+      ASSERT(ring.try_publish(batch, 4) == 3);
+      ASSERT(!ring.try_publish("six"));
+      ASSERT(!ring.publish("six", 1ms));
+      try {
+        ring.try_publish(std::string(17, 'x'));
+        ASSERT(false);
+      } catch (const std::invalid_argument&) {}
+
+      std::vector<std::string> messages;
+      const auto push = [&messages](const string_view message)
+      {
+        messages.emplace_back(message);
+      };
+      ASSERT(ring.try_consume(push, 3) == 3);
+      ASSERT(ring.try_consume(push) == 1);
+      ASSERT(messages ==
+        (std::vector<std::string>{"one", "two", "three", "four"}));
+      ASSERT(!ring.try_consume(push));
+      ASSERT(!ring.consume(push, 1, 1ms));
+
+      // Attaching within the process.
+      auto other = ipc::Spsc_shm_ring::attach(ring.token());
+      ASSERT(other.capacity() == ring.capacity());
+      ASSERT(other.try_publish("seven"));
+      ASSERT(ring.try_consume(push) == 1 && messages.back() == "seven");
+      try {
+        ipc::Mpsc_shm_ring::attach(ring.token());
+        ASSERT(false);
+      } catch (const std::runtime_error&) {}
+
+      auto moved = std::move(ring);
+      ASSERT(moved && !ring);
+    }
+
+    // Multiple producers.
+    {
+      constexpr std::size_t producer_count{4};
+      constexpr std::uint32_t message_count{20000};
+      auto ring = ipc::Mpsc_shm_ring::make(64, sizeof(std::uint64_t));
+      std::vector<std::thread> producers;
+      for (std::uint32_t p{}; p < producer_count; ++p) {
+        producers.emplace_back([&ring, p]
+        {
+          for (std::uint32_t i{}; i < message_count; ++i) {
+            const std::uint64_t value{std::uint64_t{p} << 32 | i};
+            ASSERT(ring.publish(string_view{
+                  reinterpret_cast<const char*>(&value), sizeof(value)}));
+          }
+        });
+      }
+      std::vector<std::uint32_t> next(producer_count);
+      std::size_t total{};
+      while (total < producer_count * message_count) {
+        total += ring.consume([&next](const string_view message)
+        {
+          ASSERT(message.size() == sizeof(std::uint64_t));
+          std::uint64_t value;
+          std::memcpy(&value, message.data(), sizeof(value));
+          // Messages of each producer are ordered.
+          ASSERT(next[value >> 32]++ == static_cast<std::uint32_t>(value));
+        });
+      }
+      for (auto& producer : producers)
+        producer.join();
+      for (const auto n : next)
+        ASSERT(n == message_count);
+    }
+
+    // Other process.
+    {
+      constexpr std::uint32_t message_count{100000};
+      auto ring = ipc::Spsc_shm_ring::make(256, 64);
+      const auto token = ring.token();
+      const auto child = ::fork();
+      ASSERT(child != -1);
+      if (!child) {
+        int status{};
+        try {
+          auto peer = ipc::Spsc_shm_ring::attach(ipc::Shm_ring_token{
+              ::getppid(), token.fd});
+          std::vector<std::string> storage(32);
+          std::vector<string_view> batch(storage.size());
+          for (std::uint32_t i{}; i < message_count; i += batch.size()) {
+            for (std::size_t j{}; j < batch.size(); ++j)
+              batch[j] = storage[j] = std::to_string(i + j);
+            peer.publish(batch.data(), batch.size());
+          }
+        } catch (...) {
+          status = 1;
+        }
+        ::_exit(status);
+      }
+
+      std::uint32_t expected{};
+      const auto size = message_count / 32 * 32 + (message_count % 32 ? 32 : 0);
+      while (expected < size) {
+        ring.consume([&expected](const string_view message)
+        {
+          ASSERT(message == std::to_string(expected));
+          ++expected;
+        });
+      }
+      int status{};
+      ASSERT(::waitpid(child, &status, 0) == child);
+      ASSERT(WIFEXITED(status) && !WEXITSTATUS(status));
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,109 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../ipc_socket.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    namespace ipc = dmitigr::os::ipc;
+    using ipc::Unix_socket;
+    using ipc::Unix_socket_type;
+    using std::string_view;
+
+    // Descriptors and credentials.
+    {
+      auto [first, second] = Unix_socket::pair();
+      ASSERT(first && second);
+      ASSERT(first.peer_credentials().pid == os::pid());
+      first.check_peer(os::pid());
+      try {
+        first.check_peer(os::pid() + 1);
+        ASSERT(false);
+      } catch (const std::runtime_error&) {}
+
+      auto pipe = ipc::Pipe::make();
+      second.set_pass_credentials();
+      ASSERT(first.send("pipe", {pipe.writer()}) == 4);
+      char buf[16];
+      const auto received = second.receive(buf, sizeof(buf));
+      ASSERT(received);
+      ASSERT(string_view(buf, received->size) == "pipe");
+      ASSERT(!received->is_truncated);
+      ASSERT(received->fds.size() == 1);
+      ASSERT(received->credentials);
+      ASSERT(received->credentials->pid == os::pid());
+      ASSERT(received->credentials->uid == ::geteuid());
+
+      // The received descriptor refers to the same pipe.
+      pipe.close_writer();
+      ASSERT(::write(received->fds[0], "x", 1) == 1);
+      ASSERT(::read(pipe.reader(), buf, 1) == 1 && buf[0] == 'x');
+
+      // Nonblocking mode.
+      second.set_nonblocking();
+      ASSERT(!second.receive(buf, sizeof(buf)));
+    }
+
+    // Batches.
+    {
+      auto [first, second] = Unix_socket::pair(Unix_socket_type::datagram);
+      std::vector<std::string> storage;
+      for (int i{}; i < 100; ++i)
+        storage.push_back(std::to_string(i));
+      const std::vector<string_view> messages(storage.begin(), storage.end());
+      ASSERT(first.send_batch(messages.data(), messages.size()) == messages.size());
+
+      ipc::Unix_message_batch batch{32, 2};
+      std::size_t total{};
+      while (total < messages.size()) {
+        const auto n = second.receive_batch(batch);
+        ASSERT(n && *n == batch.size() && *n <= batch.capacity());
+        for (std::size_t i{}; i < *n; ++i, ++total) {
+          ASSERT(batch[i] == messages[total]);
+          ASSERT(!batch.is_truncated(i));
+        }
+      }
+      ASSERT(total == messages.size());
+    }
+
+    // Listening socket.
+    {
+      const std::string path{"@dmitigr_os_ipc_socket_" +
+        std::to_string(os::pid())};
+      const auto listener = Unix_socket::listen(path);
+      std::thread client{[&path]
+      {
+        const auto socket = Unix_socket::connect(path);
+        ASSERT(socket.send("hello") == 5);
+      }};
+      const auto connection = listener.accept();
+      ASSERT(connection && *connection);
+      connection->check_peer(os::pid());
+      char buf[8];
+      const auto received = connection->receive(buf, sizeof(buf));
+      ASSERT(received && string_view(buf, received->size) == "hello");
+      client.join();
+
+      try {
+        Unix_socket::connect(path + "_nonexistent");
+        ASSERT(false);
+      } catch (const os::Sys_exception& e) {
+        ASSERT(e.condition() == std::errc::connection_refused);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
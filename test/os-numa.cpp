@@ -0,0 +1,94 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../numa.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    using os::Numa_policy;
+    using std::cout;
+    using std::endl;
+
+    const auto nodes = os::numa_memory_nodes();
+    ASSERT(!nodes.empty());
+    const std::size_t size{4 << 20};
+
+    // Allocation on the node.
+    {
+      auto memory = os::numa_allocate_on_node(size, nodes.front());
+      ASSERT(memory);
+      ASSERT(memory.size() == size);
+      ASSERT(memory.policy() == Numa_policy::bind);
+      cout << "Bound: " << memory.is_bound() << endl;
+      ASSERT(!os::numa_node_of(memory.data()));
+      std::memset(memory.data(), 1, memory.size());
+      if (memory.is_bound())
+        ASSERT(os::numa_node_of(memory.data()) == nodes.front());
+    }
+
+    // Allocation on the invalid node falls back to the node 0.
+    {
+      const auto memory = os::numa_allocate_on_node(size,
+        os::detail::max_numa_node_count - 1, Numa_policy::preferred);
+      ASSERT(!memory.is_bound() || memory.nodes() == std::vector<unsigned>{0});
+    }
+
+    // Interleaved allocation.
+    {
+      auto memory = os::numa_allocate_interleaved(size);
+      ASSERT(!memory.is_bound() || memory.nodes() == nodes);
+      std::memset(memory.data(), 1, memory.size());
+      std::vector<const void*> pages;
+      for (std::size_t i{}; i < memory.size(); i += os::posix::page_size())
+        pages.push_back(static_cast<char*>(memory.data()) + i);
+      for (const auto node : os::numa_nodes_of(pages))
+        ASSERT(node >= 0);
+    }
+
+    // Binding of the range.
+    {
+      auto mapping = os::posix::mmap_anonymous(size);
+      std::memset(mapping.data(), 1, mapping.size());
+      try {
+        os::numa_bind(mapping.data(), mapping.size(), Numa_policy::bind,
+          {nodes.front()}, true);
+        ASSERT(os::numa_node_of(mapping.data()) == nodes.front());
+      } catch (const os::Sys_exception& e) {
+        cout << e.what() << ": " << e.condition().message() << endl;
+      }
+    }
+
+    // Memory resource.
+    {
+      os::Numa_memory_resource resource{nodes.front()};
+      ASSERT(resource.is_equal(os::Numa_memory_resource{nodes.front()}));
+      ASSERT(!resource.is_equal(*std::pmr::new_delete_resource()));
+      std::pmr::unsynchronized_pool_resource pool{&resource};
+      std::pmr::vector<int> vec{&pool};
+      for (int i{}; i < 100000; ++i)
+        vec.push_back(i);
+      ASSERT(vec[99999] == 99999);
+
+      constexpr std::size_t alignment{1 << 21};
+      void* const p = resource.allocate(100, alignment);
+      ASSERT(!(reinterpret_cast<std::uintptr_t>(p) % alignment));
+      std::memset(p, 1, 100);
+      resource.deallocate(p, 100, alignment);
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,215 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../io.hpp"
+#include "../process.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define ASSERT DMITIGR_ASSERT
+
+namespace io = dmitigr::os::io;
+
+namespace {
+
+std::string read_all(const int fd)
+{
+  std::string result;
+  char buf[256];
+  while (true) {
+    const auto n = ::read(fd, buf, sizeof(buf));
+    if (n > 0)
+      result.append(buf, n);
+    else if (!n || errno != EINTR)
+      break;
+  }
+  return result;
+}
+
+} // namespace
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    using namespace std::chrono_literals;
+
+    // Exit code and standard streams.
+    {
+      os::Process_options options;
+      options.path = "sh";
+      options.arguments = {"sh", "-c", "read x; echo out:$x; echo err >&2; exit 3"};
+      options.input = os::Stdio::pipe;
+      options.output = os::Stdio::pipe;
+      options.error = os::Stdio::pipe;
+      auto process = os::Process::spawn(options);
+      ASSERT(process);
+      ASSERT(process.pid() > 0);
+      ASSERT(::write(process.input(), "hi\n", 3) == 3);
+      process.input().close();
+      ASSERT(read_all(process.output()) == "out:hi\n");
+      ASSERT(read_all(process.error()) == "err\n");
+      const auto exit = process.wait();
+      ASSERT(exit.code == 3 && !exit.signal && !exit.is_success());
+      ASSERT(process.exit() && process.exit()->code == 3);
+      ASSERT(!process.send_signal(SIGTERM));
+      ASSERT(process.wait().code == 3);
+    }
+
+    // Environment, working directory and /dev/null.
+    {
+      const auto block = os::Environment_builder{}.set("DMITIGR_OS_X", "42")
+        .build();
+      os::Process_options options;
+      options.path = "/bin/sh";
+      options.is_path_searched = false;
+      options.arguments = {"sh", "-c", "echo $DMITIGR_OS_X:$(pwd)"
+        " && cat"};
+      options.environment = &block;
+      options.working_directory = "/";
+      options.input = os::Stdio::null;
+      options.output = os::Stdio::pipe;
+      auto process = os::Process::spawn(options);
+      ASSERT(read_all(process.output()) == "42:/\n");
+      ASSERT(process.wait().is_success());
+    }
+
+    // Signals and timed waiting.
+    {
+      os::Process_options options;
+      options.path = "sleep";
+      options.arguments = {"sleep", "30"};
+      auto process = os::Process::spawn(options);
+      ASSERT(!process.try_wait());
+      ASSERT(!process.wait(10ms));
+      ASSERT(process.send_signal(SIGTERM));
+      const auto exit = process.wait(5s);
+      ASSERT(exit && exit->signal == SIGTERM && exit->code == -1);
+    }
+
+    // Bulk spawning.
+    {
+      os::Process_options options;
+      options.path = "true";
+      options.output = os::Stdio::null;
+      auto processes = os::Process::spawn(options, 16);
+      ASSERT(processes.size() == 16);
+      for (auto& process : processes)
+        ASSERT(process.wait().is_success());
+    }
+
+    // Process handle.
+    {
+      const auto self = os::Process_handle::open(os::pid());
+      ASSERT(self && self.pid() == os::pid());
+      ASSERT(!self.is_terminated());
+      auto pipe = os::ipc::Pipe::make();
+      const auto reader = self.getfd(pipe.reader());
+      ASSERT(reader.fd() != -1 && reader.fd() != pipe.reader());
+      ASSERT(::write(pipe.writer(), "x", 1) == 1);
+      char c{};
+      ASSERT(::read(reader, &c, 1) == 1 && c == 'x');
+
+      os::Process_options options;
+      options.path = "sleep";
+      options.arguments = {"sleep", "30"};
+      auto process = os::Process::spawn(options);
+      ASSERT(process.handle());
+      ASSERT(process.handle().pid() == process.pid());
+      ASSERT(!process.handle().wait_termination(10ms));
+      auto handle = os::Process_handle::open(process.pid());
+      ASSERT(handle.send_signal(SIGKILL));
+      ASSERT(handle.wait_termination(5s));
+      ASSERT(handle.is_terminated());
+      ASSERT(process.handle().is_terminated());
+      ASSERT(process.wait().signal == SIGKILL);
+      ASSERT(handle.pid() == -1);
+      ASSERT(!handle.send_signal(SIGKILL));
+      os::Process_handle moved{std::move(handle)};
+      ASSERT(moved && !handle);
+      ASSERT(moved.close() && !moved);
+    }
+
+    // Termination notifications via the I/O engine.
+    for (const auto backend : {io::Backend::io_uring, io::Backend::epoll}) {
+      std::optional<io::Engine> engine;
+      try {
+        engine.emplace(256, backend, 1);
+      } catch (const os::Sys_exception&) {
+        continue; // io_uring is unavailable
+      }
+      os::Process_options options;
+      options.path = "sh";
+      options.arguments = {"sh", "-c", "exit $0", "0"};
+      std::vector<os::Process> processes;
+      for (int i{}; i < 8; ++i) {
+        options.arguments.back() = std::to_string(i);
+        processes.push_back(os::Process::spawn(options));
+      }
+      std::size_t terminated{};
+      for (std::size_t i{}; i < processes.size(); ++i) {
+        engine->wait_readable({processes[i].handle()},
+          [&, i](const std::error_code error, std::size_t)
+          {
+            ASSERT(!error);
+            const auto exit = processes[i].try_wait();
+            ASSERT(exit && exit->code == static_cast<int>(i));
+            ++terminated;
+          });
+      }
+      engine->run();
+      ASSERT(terminated == processes.size());
+    }
+
+    // Failure.
+    {
+      os::Process_options options;
+      options.path = "/nonexistent/dmitigr-os-test";
+      try {
+        os::Process::spawn(options);
+        ASSERT(false);
+      } catch (const os::Sys_exception& e) {
+        ASSERT(e.condition() == std::errc::no_such_file_or_directory);
+      }
+    }
+
+    // Failure of bulk spawning kills and reaps the processes spawned so far.
+    {
+      ASSERT(::waitpid(-1, nullptr, WNOHANG) == -1 && errno == ECHILD);
+      ::rlimit old_limit{};
+      ASSERT(!::getrlimit(RLIMIT_NOFILE, &old_limit));
+      const int next_fd = ::dup(0);
+      ASSERT(next_fd != -1 && !::close(next_fd));
+      auto limit = old_limit;
+      limit.rlim_cur = static_cast<::rlim_t>(next_fd + 16);
+      ASSERT(!::setrlimit(RLIMIT_NOFILE, &limit));
+      os::Process_options options;
+      options.path = "sleep";
+      options.arguments = {"sleep", "30"};
+      options.input = os::Stdio::pipe;
+      options.output = os::Stdio::pipe;
+      options.error = os::Stdio::pipe;
+      try {
+        os::Process::spawn(options, 64);
+        ASSERT(false);
+      } catch (const os::Sys_exception& e) {
+        ASSERT(e.condition() == std::errc::too_many_files_open);
+      }
+      ASSERT(!::setrlimit(RLIMIT_NOFILE, &old_limit));
+      ASSERT(::waitpid(-1, nullptr, WNOHANG) == -1 && errno == ECHILD);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "unknown error" << std::endl;
+    return 2;
+  }
+}
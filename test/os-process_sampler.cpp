@@ -0,0 +1,112 @@
+// -*- C++ -*-
+
+#include "../../base/assert.hpp"
+#include "../process_sampler.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/wait.h>
+
+#define ASSERT DMITIGR_ASSERT
+
+int main()
+{
+  try {
+    namespace os = dmitigr::os;
+    using namespace std::chrono_literals;
+
+    // Parsing.
+    {
+      os::Process_sample sample;
+      os::detail::parse_proc_stat("42 (a) b (c)) R 1 42 42 0 -1 4194304 "
+        "100 0 7 0 200 300 0 0 20 0 5 0 237894 2703360 323", sample);
+      ASSERT(sample.minor_faults == 100);
+      ASSERT(sample.major_faults == 7);
+      ASSERT(sample.user_time > 0ns && sample.system_time > sample.user_time);
+      ASSERT(sample.thread_count == 5);
+
+      os::detail::parse_proc_io("rchar: 10\nwchar: 20\nsyscr: 1\nsyscw: 2\n"
+        "read_bytes: 4096\nwrite_bytes: 8192\ncancelled_write_bytes: 0\n",
+        sample);
+      ASSERT(sample.read_chars == 10 && sample.write_chars == 20);
+      ASSERT(sample.read_bytes == 4096 && sample.write_bytes == 8192);
+
+      os::detail::parse_proc_status("Name:\tx\nvoluntary_ctxt_switches:\t3\n"
+        "nonvoluntary_ctxt_switches:\t4\n", sample);
+      ASSERT(sample.voluntary_switches == 3 && sample.involuntary_switches == 4);
+
+      os::detail::parse_proc_smaps_rollup("Rss: 8 kB\nPss_Anon: 1 kB\n"
+        "Pss:  4 kB\n", sample);
+      ASSERT(sample.proportional_size == 4096);
+    }
+
+    // The calling process.
+    {
+      os::Process_sampler sampler{os::pid(), {true, true}};
+      ASSERT(sampler.pid() == os::pid());
+      ASSERT(sampler.current().thread_count >= 1);
+      ASSERT(sampler.current().resident_size > 0);
+      ASSERT(sampler.current().proportional_size > 0);
+
+      // Consume some resources.
+      std::vector<char> memory(16 << 20, 1);
+      volatile std::uint64_t sum{};
+      for (int i{}; i < 20000000; ++i)
+        sum = sum + i;
+      std::thread{[]{std::this_thread::sleep_for(1ms);}}.join();
+      if (auto* const file = std::tmpfile()) {
+        std::fwrite(memory.data(), 1, 1 << 20, file);
+        std::fflush(file);
+        std::fclose(file);
+      }
+
+      ASSERT(sampler.update());
+      const auto delta = sampler.delta();
+      ASSERT(sampler.interval() > 0ns);
+      ASSERT(delta.minor_faults >= (16u << 20) / os::posix::page_size() / 2);
+      ASSERT(delta.run_time > 0ns || delta.user_time > 0ns);
+      ASSERT(delta.voluntary_switches > 0);
+      ASSERT(delta.resident_size == sampler.current().resident_size);
+      if (delta.has_io)
+        ASSERT(delta.write_chars >= 1 << 20);
+      std::cout << "user " << delta.user_time.count() << " ns, run "
+                << delta.run_time.count() << " ns, minor faults "
+                << delta.minor_faults << ", RSS "
+                << delta.resident_size << ", PSS "
+                << delta.proportional_size.value_or(0) << ", written "
+                << delta.write_chars << std::endl;
+    }
+
+    // The exited process.
+    {
+      const auto child = ::fork();
+      ASSERT(child != -1);
+      if (!child) {
+        ::pause();
+        ::_exit(0);
+      }
+      os::Process_sampler sampler{child};
+      ASSERT(sampler.update());
+      ASSERT(!::kill(child, SIGKILL));
+      ASSERT(::waitpid(child, nullptr, 0) == child);
+      ASSERT(!sampler.update());
+      try {
+        os::Process_sampler{child};
+        ASSERT(false);
+      } catch (const os::Sys_exception& e) {
+        std::cout << e.what() << std::endl;
+      }
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
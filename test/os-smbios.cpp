@@ -17,7 +17,9 @@ int main()
     using std::cout;
     using std::endl;
 
-    const auto smbios = fw::Smbios_table::from_system();
+    const auto& smbios = fw::Smbios_table::system();
+    ASSERT(&smbios == &fw::Smbios_table::system());
+    ASSERT(smbios.raw() == fw::Smbios_table::from_system().raw());
 #ifdef _WIN32
     {
       std::ofstream out{"smbios.bin", std::ios::binary};
@@ -33,6 +35,9 @@ int main()
     cout << "Minor version: " << static_cast<int>(header.minor_version) << endl;
     cout << "DMI revision: " << static_cast<int>(header.dmi_revision) << endl;
     cout << "Length: " << header.length << endl;
+    for (const auto& error : smbios.errors())
+      cout << "Parse error " << static_cast<int>(error.code)
+           << " at offset " << error.offset << endl;
 
     const auto bios_info = smbios.bios_info();
     cout << "BIOS vendor: " << bios_info.vendor.value_or("") << endl;
@@ -90,6 +95,30 @@ int main()
         cout << "    thread_enabled: " << proc.thread_enabled << endl;
       }
     }
+
+    {
+      cout << "Caches:" << endl;
+      for (const auto& cache : smbios.caches_info<std::string_view>()) {
+        cout << "  Cache " << cache.structure_handle << ":" << endl;
+        cout << "    socket: " << cache.socket_designation.value_or("NULL") << endl;
+        cout << "    level: " << static_cast<int>(cache.level()) << endl;
+        cout << "    installed_size: " << cache.installed_size_bytes() << endl;
+        cout << "    associativity: " << static_cast<int>(cache.associativity) << endl;
+      }
+    }
+
+    {
+      cout << "Memory devices:" << endl;
+      for (const auto& dev : smbios.memory_devices_info<std::string_view>()) {
+        cout << "  Memory device " << dev.structure_handle << ":" << endl;
+        cout << "    device_locator: " << dev.device_locator.value_or("NULL") << endl;
+        cout << "    bank_locator: " << dev.bank_locator.value_or("NULL") << endl;
+        cout << "    size: " << dev.size_bytes() << endl;
+        cout << "    speed: " << dev.speed << endl;
+        cout << "    manufacturer: " << dev.manufacturer.value_or("NULL") << endl;
+        cout << "    part_number: " << dev.part_number.value_or("NULL") << endl;
+      }
+    }
   } catch (const std::exception& e) {
     std::clog << "error: " << e.what() << std::endl;
     return 1;
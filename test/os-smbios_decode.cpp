@@ -0,0 +1,176 @@
+// -*- C++ -*-
+//
+// Decoding of the synthetic SMBIOS tables of various versions.
+
+#include "../../base/assert.hpp"
+#include "../smbios.hpp"
+#include "os-smbios_fixture.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+
+#define ASSERT DMITIGR_ASSERT
+
+namespace {
+
+namespace fw = dmitigr::os::firmware;
+namespace test = dmitigr::os::test;
+
+void check(const test::Smbios_spec& spec)
+{
+  using std::string_view;
+  const auto data = test::make_smbios_table(spec);
+  const fw::Smbios_table table{data.data(), data.size()};
+  ASSERT(table.errors().empty());
+  const auto ge = [&table](const unsigned major, const unsigned minor)
+  {
+    return table.header().is_version_ge(major, minor);
+  };
+
+  // Structure ranges.
+  {
+    const auto view = table.view();
+    const auto structures = view.structures();
+    auto i = structures.begin();
+    ASSERT(i != structures.end());
+    const auto first = *i; // remains valid after the iterator is advanced
+    const auto first_type = i->type();
+    ++i;
+    ASSERT(first.type() == first_type && first.handle() == view.structures()
+      .begin()->handle());
+    std::size_t count{1};
+    fw::Smbios_table::Word max_handle{first.handle()};
+    for (; i != structures.end(); ++i) {
+      max_handle = std::max(max_handle, i->handle());
+      ++count;
+    }
+    const auto max = std::max_element(structures.begin(), structures.end(),
+      [](const auto& lhs, const auto& rhs)
+      {
+        return lhs.handle() < rhs.handle();
+      });
+    ASSERT(max != structures.end() && max->handle() == max_handle);
+    ASSERT(static_cast<std::size_t>(std::distance(structures.begin(),
+      structures.end())) == count);
+
+    const auto processors = view.structures(
+      fw::Smbios_table::Structure_type::processor_information);
+    ASSERT(static_cast<std::size_t>(std::distance(processors.begin(),
+      processors.end())) == spec.processor_count);
+    for (const auto processor : processors)
+      ASSERT(processor.type() ==
+        fw::Smbios_table::Structure_type::processor_information);
+  }
+
+  // Type 3.
+  {
+    const auto enclosures = table.system_enclosures_info<string_view>();
+    ASSERT(enclosures.size() == 1);
+    const auto& e = enclosures[0];
+    ASSERT(e.type == 0x17);
+    ASSERT(e.manufacturer && e.manufacturer->size() == spec.string_size);
+    ASSERT(!e.version);
+    ASSERT(e.boot_up_state == (ge(2,1) ? 3 : 0));
+    ASSERT(e.height == (ge(2,3) ? 2 : 0));
+    ASSERT(e.power_cord_count == (ge(2,3) ? 1 : 0));
+    ASSERT(e.sku_number.has_value() == ge(2,7));
+  }
+
+  // Type 4 linked with type 7.
+  {
+    const auto processors = table.processors_info();
+    const auto caches = table.caches_info();
+    ASSERT(processors.size() == spec.processor_count);
+    ASSERT(caches.size() == 3 * spec.processor_count);
+    for (std::size_t i{}; i < caches.size(); ++i) {
+      const auto& c = caches[i];
+      const auto level = i % 3 + 1;
+      ASSERT(c.level() == level);
+      ASSERT(c.installed_size_bytes() == (32u << (level * 2)) * 1024);
+      ASSERT(c.maximum_size_bytes() == c.installed_size_bytes());
+      ASSERT(c.associativity == (ge(2,1) ? (level == 3 ? 0x0E : 0x07) : 0));
+      ASSERT(c.installed_size_2 == (ge(3,1) ? (32u << (level * 2)) : 0));
+      if (ge(2,1)) {
+        const auto& p = processors[i / 3];
+        const auto handle = level == 1 ? p.l1_cache_handle :
+          level == 2 ? p.l2_cache_handle : p.l3_cache_handle;
+        ASSERT(handle == c.structure_handle);
+      }
+    }
+  }
+
+  // Type 9.
+  {
+    const auto slots = table.system_slots_info<string_view>();
+    ASSERT(slots.size() == 2);
+    for (std::size_t i{}; i < slots.size(); ++i) {
+      const auto& s = slots[i];
+      ASSERT(s.designation && s.designation->size() == spec.string_size);
+      ASSERT(s.type == 0xB6);
+      ASSERT(s.id == i);
+      ASSERT(s.characteristics_2 == (ge(2,1) ? 1 : 0));
+      ASSERT(s.bus_number == (ge(2,6) ? i : 0));
+      ASSERT(s.peer_grouping_count == (ge(3,2) ? 1 : 0));
+      ASSERT(s.slot_information == (ge(3,4) ? 2 : 0));
+      ASSERT(s.slot_pitch == (ge(3,4) ? 2000 : 0));
+      ASSERT(s.slot_height == (ge(3,5) ? 3 : 0));
+    }
+  }
+
+  // Types 16, 17 and 19.
+  {
+    const auto arrays = table.memory_arrays_info();
+    ASSERT(arrays.size() == 1);
+    const auto& a = arrays[0];
+    ASSERT(a.memory_device_count == spec.memory_device_count);
+    ASSERT(a.maximum_capacity_bytes() == 1ull << 36);
+
+    const auto devices = table.memory_devices_info<string_view>();
+    ASSERT(devices.size() == spec.memory_device_count);
+    for (const auto& d : devices) {
+      ASSERT(d.memory_array_handle == a.structure_handle);
+      ASSERT(d.size_bytes() == 16ull << 30);
+      ASSERT(d.device_locator && d.device_locator->size() == spec.string_size);
+      ASSERT(d.manufacturer.has_value() == ge(2,3));
+      ASSERT(d.speed == (ge(2,3) ? 3200 : 0));
+      ASSERT(d.configured_memory_speed == (ge(2,7) ? 3200 : 0));
+      ASSERT(d.configured_voltage == (ge(2,8) ? 1200 : 0));
+    }
+
+    const auto mapped = table.memory_array_mapped_addresses_info();
+    ASSERT(mapped.size() == 1);
+    ASSERT(mapped[0].memory_array_handle == a.structure_handle);
+    ASSERT(mapped[0].starting_address_bytes() == 0);
+    ASSERT(mapped[0].ending_address_bytes() == 0x00FFFFFFull * 1024 + 1023);
+  }
+
+  // Type 38.
+  {
+    const auto ipmi = table.ipmi_device_info();
+    ASSERT(ipmi);
+    ASSERT(ipmi->interface_type == 1);
+    ASSERT(ipmi->specification_revision == 0x20);
+    ASSERT(ipmi->base_address == 0xCA3);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  try {
+    for (const auto spec : {test::Smbios_spec{2, 1, 1, 1, 1},
+        test::Smbios_spec{2, 3, 1, 1, 8}, test::Smbios_spec{2, 7, 2, 4, 8},
+        test::Smbios_spec{2, 8, 2, 8, 16}, test::Smbios_spec{3, 2, 2, 8, 16},
+        test::Smbios_spec{3, 4, 2, 8, 16}, test::Smbios_spec{3, 6, 8, 32, 255}})
+      check(spec);
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
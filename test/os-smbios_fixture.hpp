@@ -0,0 +1,254 @@
+// -*- C++ -*-
+//
+// Copyright 2024 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Synthetic SMBIOS tables for the tests which must not depend on firmware.
+
+#ifndef DMITIGR_OS_TEST_SMBIOS_FIXTURE_HPP
+#define DMITIGR_OS_TEST_SMBIOS_FIXTURE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace dmitigr::os::test {
+
+/// A builder of SMBIOS table in the format of `Smbios_table::raw()`.
+class Smbios_builder final {
+public:
+  using Byte = std::uint8_t;
+  using Word = std::uint16_t;
+
+  /// Constructs the builder of the table of the given version.
+  Smbios_builder(const Byte major_version, const Byte minor_version)
+    : data_{0, major_version, minor_version, 0, 0, 0, 0, 0}
+  {}
+
+  /// Appends the structure with the formatted area of `length` bytes.
+  Smbios_builder& begin(const Byte type, const Byte length, const Word handle)
+  {
+    structure_ = data_.size();
+    data_.resize(data_.size() + length);
+    data_[structure_] = type;
+    data_[structure_ + 1] = length;
+    set(0x2, handle);
+    return *this;
+  }
+
+  /// Sets the field of the current structure at `offset` if it fits.
+  template<typename T>
+  Smbios_builder& set(const std::size_t offset, const T value)
+  {
+    if (offset + sizeof(T) <= data_[structure_ + 1])
+      std::memcpy(data_.data() + structure_ + offset, &value, sizeof(T));
+    return *this;
+  }
+
+  /// Appends the strings of the current structure.
+  Smbios_builder& end(const std::initializer_list<std::string> strings = {})
+  {
+    for (const auto& s : strings)
+      data_.insert(data_.end(), s.c_str(), s.c_str() + s.size() + 1);
+    if (!strings.size())
+      data_.push_back(0);
+    data_.push_back(0);
+    return *this;
+  }
+
+  /// @returns The table with the header length set.
+  std::vector<Byte> table() const
+  {
+    auto result = data_;
+    const auto length = static_cast<std::uint32_t>(result.size());
+    std::memcpy(result.data() + 4, &length, sizeof(length));
+    return result;
+  }
+
+  /// @returns The table data as is.
+  std::vector<Byte>& data() noexcept
+  {
+    return data_;
+  }
+
+private:
+  std::vector<Byte> data_;
+  std::size_t structure_{};
+};
+
+/// A specification of the synthetic table.
+struct Smbios_spec final {
+  std::uint8_t major_version{3};
+  std::uint8_t minor_version{6};
+  unsigned processor_count{1};
+  unsigned memory_device_count{2};
+  /// The size of each string of the table.
+  std::size_t string_size{12};
+};
+
+/// @returns The synthetic table which matches the `spec`.
+inline std::vector<std::uint8_t> make_smbios_table(const Smbios_spec& spec)
+{
+  using Word = Smbios_builder::Word;
+  using Dword = std::uint32_t;
+  using Qword = std::uint64_t;
+  const auto ge = [&spec](const unsigned major, const unsigned minor)
+  {
+    return spec.major_version > major ||
+      (spec.major_version == major && spec.minor_version >= minor);
+  };
+  const auto str = [&spec](const std::string& prefix, const unsigned n = 0)
+  {
+    auto result = prefix + std::to_string(n);
+    result.resize(std::max(spec.string_size, std::size_t{1}), 'x');
+    return result;
+  };
+
+  Smbios_builder b{spec.major_version, spec.minor_version};
+  Word handle{};
+
+  b.begin(0, ge(3,1) ? 0x1A : 0x18, handle++)
+    .set<std::uint8_t>(0x4, 1).set<std::uint8_t>(0x5, 2)
+    .set<Word>(0x6, 0xE800).set<std::uint8_t>(0x8, 3).set<std::uint8_t>(0x9, 0xFF)
+    .end({str("Vendor"), str("Version"), "01/01/2024"});
+
+  b.begin(1, ge(2,4) ? 0x1B : 0x19, handle++)
+    .set<std::uint8_t>(0x4, 1).set<std::uint8_t>(0x5, 2)
+    .set<std::uint8_t>(0x6, 3).set<std::uint8_t>(0x7, 4);
+  for (std::size_t i{}; i < 16; ++i)
+    b.set<std::uint8_t>(0x8 + i, static_cast<std::uint8_t>(i * 17));
+  b.end({str("Manufacturer"), str("Product"), str("Version"), str("Serial")});
+
+  b.begin(2, 0x0F, handle++)
+    .set<std::uint8_t>(0x4, 1).set<std::uint8_t>(0x5, 2)
+    .set<std::uint8_t>(0x6, 3).set<std::uint8_t>(0x7, 4)
+    .end({str("Board"), str("Product"), str("Version"), str("Serial")});
+
+  b.begin(3, ge(2,7) ? 0x16 : ge(2,3) ? 0x15 : ge(2,1) ? 0x0D : 0x09, handle++)
+    .set<std::uint8_t>(0x4, 1).set<std::uint8_t>(0x5, 0x17)
+    .set<std::uint8_t>(0x7, 2).set<std::uint8_t>(0x8, 3)
+    .set<std::uint8_t>(0x9, 3).set<std::uint8_t>(0xA, 3)
+    .set<std::uint8_t>(0xB, 3).set<std::uint8_t>(0xC, 3)
+    .set<std::uint8_t>(0x11, 2).set<std::uint8_t>(0x12, 1)
+    .set<std::uint8_t>(0x15, 4)
+    .end({str("Chassis"), str("Serial"), str("Asset"), str("SKU")});
+
+  for (unsigned slot{}; slot < 2; ++slot) {
+    // One peer group of 5 bytes since 3.2.
+    const std::uint8_t length = ge(3,5) ? 0x1D : ge(3,4) ? 0x1C :
+      ge(3,2) ? 0x18 : ge(2,6) ? 0x11 : ge(2,1) ? 0x0D : 0x0C;
+    b.begin(9, length, handle++)
+      .set<std::uint8_t>(0x4, 1).set<std::uint8_t>(0x5, 0xB6)
+      .set<std::uint8_t>(0x6, 0x0D).set<std::uint8_t>(0x7, 3)
+      .set<std::uint8_t>(0x8, 4).set<Word>(0x9, static_cast<Word>(slot))
+      .set<std::uint8_t>(0xB, 0x04).set<std::uint8_t>(0xC, 0x01)
+      .set<Word>(0xD, 0).set<std::uint8_t>(0xF, static_cast<std::uint8_t>(slot))
+      .set<std::uint8_t>(0x10, 0x08).set<std::uint8_t>(0x11, 0x0D)
+      .set<std::uint8_t>(0x12, 1).set<Word>(0x13, 0)
+      .set<std::uint8_t>(0x15, 0).set<std::uint8_t>(0x16, 0)
+      .set<std::uint8_t>(0x17, 0x0D)
+      .set<std::uint8_t>(0x18, 0x02).set<std::uint8_t>(0x19, 0x0D)
+      .set<Word>(0x1A, 2000).set<std::uint8_t>(0x1C, 0x03)
+      .end({str("Slot", slot)});
+  }
+
+  for (unsigned p{}; p < spec.processor_count; ++p) {
+    const Word cache_handle = handle;
+    for (unsigned level{1}; level <= 3; ++level) {
+      b.begin(7, ge(3,1) ? 0x1B : 0x13, handle++)
+        .set<std::uint8_t>(0x4, 1)
+        .set<Word>(0x5, static_cast<Word>(0x180 | (level - 1)))
+        .set<Word>(0x7, static_cast<Word>(32 << (level * 2)))
+        .set<Word>(0x9, static_cast<Word>(32 << (level * 2)))
+        .set<std::uint8_t>(0xF, 4)
+        .set<std::uint8_t>(0x10, level == 1 ? 3 : 5)
+        .set<std::uint8_t>(0x11, level == 3 ? 1 : 8)
+        .set<std::uint8_t>(0x12, level == 3 ? 0x0E : 0x07)
+        .set<Dword>(0x13, static_cast<Dword>(32u << (level * 2)))
+        .set<Dword>(0x17, static_cast<Dword>(32u << (level * 2)))
+        .end({str("L" + std::to_string(level) + "-Cache", p)});
+    }
+
+    const std::uint8_t length = ge(3,6) ? 0x32 : ge(3,0) ? 0x30 : ge(2,6) ? 0x2A :
+      ge(2,5) ? 0x28 : ge(2,3) ? 0x23 : ge(2,1) ? 0x20 : 0x1A;
+    b.begin(4, length, handle++)
+      .set<std::uint8_t>(0x04, 1).set<std::uint8_t>(0x05, 3)
+      .set<std::uint8_t>(0x06, 0xFE).set<std::uint8_t>(0x07, 2)
+      .set<Qword>(0x08, 0xBFEBFBFF000906EAull + p).set<std::uint8_t>(0x10, 3)
+      .set<std::uint8_t>(0x11, 0x8C).set<Word>(0x12, 100)
+      .set<Word>(0x14, 4000).set<Word>(0x16, 3000)
+      .set<std::uint8_t>(0x18, 0x41).set<std::uint8_t>(0x19, 0x3F)
+      .set<Word>(0x1A, cache_handle)
+      .set<Word>(0x1C, static_cast<Word>(cache_handle + 1))
+      .set<Word>(0x1E, static_cast<Word>(cache_handle + 2))
+      .set<std::uint8_t>(0x20, 4).set<std::uint8_t>(0x21, 5)
+      .set<std::uint8_t>(0x22, 6).set<std::uint8_t>(0x23, 8)
+      .set<std::uint8_t>(0x24, 8).set<std::uint8_t>(0x25, 16)
+      .set<Word>(0x26, 0xEC).set<Word>(0x28, 0xC6)
+      .set<Word>(0x2A, 8).set<Word>(0x2C, 8).set<Word>(0x2E, 16)
+      .set<Word>(0x30, 16)
+      .end({str("CPU", p), str("Intel"), str("Xeon", p), str("Serial", p),
+          str("Asset", p), str("Part", p)});
+  }
+
+  const Word array_handle = handle;
+  b.begin(16, ge(2,7) ? 0x17 : 0x0F, handle++)
+    .set<std::uint8_t>(0x4, 3).set<std::uint8_t>(0x5, 3)
+    .set<std::uint8_t>(0x6, 6).set<Dword>(0x7, ge(2,7) ? 0x80000000u : 1u << 26)
+    .set<Word>(0xB, 0xFFFE)
+    .set<Word>(0xD, static_cast<Word>(spec.memory_device_count))
+    .set<Qword>(0xF, Qword{1} << 36)
+    .end();
+
+  for (unsigned m{}; m < spec.memory_device_count; ++m) {
+    const std::uint8_t length = ge(3,3) ? 0x5C : ge(3,2) ? 0x54 :
+      ge(2,8) ? 0x28 : ge(2,7) ? 0x22 : ge(2,6) ? 0x1C : ge(2,3) ? 0x1B : 0x15;
+    b.begin(17, length, handle++)
+      .set<Word>(0x04, array_handle).set<Word>(0x06, 0xFFFE)
+      .set<Word>(0x08, 72).set<Word>(0x0A, 64)
+      .set<Word>(0x0C, 0x4000).set<std::uint8_t>(0x0E, 0x09)
+      .set<std::uint8_t>(0x0F, 0).set<std::uint8_t>(0x10, 1)
+      .set<std::uint8_t>(0x11, 2).set<std::uint8_t>(0x12, 0x1A)
+      .set<Word>(0x13, 0x80).set<Word>(0x15, 3200)
+      .set<std::uint8_t>(0x17, 3).set<std::uint8_t>(0x18, 4)
+      .set<std::uint8_t>(0x19, 5).set<std::uint8_t>(0x1A, 6)
+      .set<std::uint8_t>(0x1B, 2).set<Dword>(0x1C, 0)
+      .set<Word>(0x20, 3200).set<Word>(0x22, 1200)
+      .set<Word>(0x24, 1200).set<Word>(0x26, 1200)
+      .end({str("DIMM", m), str("Bank", m), str("Samsung"), str("Serial", m),
+          str("Asset", m), str("Part", m)});
+  }
+
+  b.begin(19, ge(2,7) ? 0x1F : 0x0F, handle++)
+    .set<Dword>(0x4, 0).set<Dword>(0x8, 0x00FFFFFFu)
+    .set<Word>(0xC, array_handle).set<std::uint8_t>(0xE, 1)
+    .end();
+
+  b.begin(38, 0x12, handle++)
+    .set<std::uint8_t>(0x4, 1).set<std::uint8_t>(0x5, 0x20)
+    .set<std::uint8_t>(0x6, 0x20).set<std::uint8_t>(0x7, 0xFF)
+    .set<Qword>(0x8, 0xCA3).set<std::uint8_t>(0x10, 0).set<std::uint8_t>(0x11, 0)
+    .end();
+
+  b.begin(127, 4, 0xFEFF).end();
+  return b.table();
+}
+
+} // namespace dmitigr::os::test
+
+#endif  // DMITIGR_OS_TEST_SMBIOS_FIXTURE_HPP
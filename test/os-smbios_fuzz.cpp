@@ -0,0 +1,171 @@
+// -*- C++ -*-
+//
+// Fuzz target of SMBIOS table parsing.
+//
+// Being built with `-fsanitize=fuzzer -DDMITIGR_OS_FUZZER` this is a libFuzzer
+// target which can be run as `./os-smbios_fuzz test/os-smbios_fuzz_corpus`.
+// Otherwise, it's a regular test which replays the built-in fixtures, the
+// checked-in corpus and the files specified as the arguments. With the
+// `--throughput` option it reports the number of structures parsed per second.
+
+#include "../../base/assert.hpp"
+#include "../smbios.hpp"
+#include "os-smbios_fixture.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+#define ASSERT DMITIGR_ASSERT
+
+namespace {
+
+namespace fw = dmitigr::os::firmware;
+
+template<class String, class View>
+std::size_t consume_view(const View& view)
+{
+  std::size_t result{};
+  for (const auto& s : view.structures()) {
+    for (fw::Smbios_view::Byte i{1}; s.string(i); ++i)
+      ASSERT(s.string(i)->data());
+    ++result;
+  }
+  try {
+    (void)view.template bios_info<String>();
+  } catch (const std::runtime_error&) {}
+  try {
+    (void)view.template sys_info<String>();
+  } catch (const std::runtime_error&) {}
+  (void)view.template baseboard_info<String>();
+  result += view.template system_enclosures_info<String>().size();
+  result += view.template processors_info<String>().size();
+  result += view.template caches_info<String>().size();
+  result += view.template system_slots_info<String>().size();
+  result += view.memory_arrays_info().size();
+  result += view.template memory_devices_info<String>().size();
+  result += view.memory_array_mapped_addresses_info().size();
+  (void)view.ipmi_device_info();
+  return result;
+}
+
+/// @returns The number of the structures parsed.
+std::size_t consume(const std::uint8_t* const data, const std::size_t size)
+{
+  try {
+    const fw::Smbios_table table{data, size};
+    const fw::Smbios_view view{data, size};
+    return consume_view<std::string>(table) +
+      consume_view<std::string_view>(table.view()) +
+      consume_view<std::string_view>(view);
+  } catch (const std::invalid_argument&) {
+    return 0;
+  }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* const data,
+  const std::size_t size)
+{
+  // Feed the input as is and with the header length fixed up.
+  consume(data, size);
+  if (size >= sizeof(fw::Smbios_view::Header)) {
+    std::vector<std::uint8_t> input(data, data + size);
+    const auto length = static_cast<std::uint32_t>(size);
+    std::memcpy(input.data() + 4, &length, sizeof(length));
+    consume(input.data(), input.size());
+  }
+  return 0;
+}
+
+#ifndef DMITIGR_OS_FUZZER
+int main(const int argc, const char* const argv[])
+{
+  try {
+    namespace fs = std::filesystem;
+    namespace test = dmitigr::os::test;
+    using std::cout;
+    using std::endl;
+
+    bool is_throughput{};
+    std::vector<std::vector<std::uint8_t>> inputs;
+
+    // Collect the inputs.
+    for (const auto spec : {test::Smbios_spec{2, 0, 1, 1, 1},
+        test::Smbios_spec{2, 8, 2, 8, 16}, test::Smbios_spec{3, 0, 4, 16, 32},
+        test::Smbios_spec{3, 6, 8, 32, 255}}) {
+      const auto table = test::make_smbios_table(spec);
+      inputs.push_back(table);
+      // Almost every prefix of a valid table is a malformed table.
+      for (std::size_t i{}; i < table.size(); i += 7) {
+        auto& prefix = inputs.emplace_back(table.begin(), table.begin() + i);
+        if (i >= sizeof(fw::Smbios_view::Header)) {
+          const auto length = static_cast<std::uint32_t>(i);
+          std::memcpy(prefix.data() + 4, &length, sizeof(length));
+        }
+      }
+    }
+    std::vector<fs::path> paths{fs::path{__FILE__}.parent_path() /
+      "os-smbios_fuzz_corpus"};
+    for (int i{1}; i < argc; ++i) {
+      if (std::string_view{argv[i]} == "--throughput")
+        is_throughput = true;
+      else
+        paths.emplace_back(argv[i]);
+    }
+    const auto read_file = [&inputs](const fs::path& path)
+    {
+      std::ifstream file{path, std::ios::binary};
+      ASSERT(file);
+      inputs.emplace_back(std::istreambuf_iterator<char>{file},
+        std::istreambuf_iterator<char>{});
+    };
+    for (const auto& path : paths) {
+      if (fs::is_directory(path)) {
+        for (const auto& entry : fs::directory_iterator{path})
+          read_file(entry.path());
+      } else if (fs::exists(path))
+        read_file(path);
+    }
+
+    // Replay the inputs.
+    for (const auto& input : inputs)
+      LLVMFuzzerTestOneInput(input.data(), input.size());
+    cout << inputs.size() << " inputs replayed" << endl;
+
+    // Measure the throughput.
+    if (is_throughput) {
+      namespace chrono = std::chrono;
+      using Clock = chrono::steady_clock;
+      std::size_t structure_count{};
+      std::size_t iteration_count{};
+      const auto started = Clock::now();
+      auto elapsed = Clock::duration{};
+      while (elapsed < chrono::seconds{3}) {
+        for (const auto& input : inputs)
+          structure_count += consume(input.data(), input.size());
+        ++iteration_count;
+        elapsed = Clock::now() - started;
+      }
+      const auto seconds = chrono::duration<double>(elapsed).count();
+      cout << iteration_count << " iterations in " << seconds << " s: "
+           << static_cast<std::uint64_t>(structure_count / seconds)
+           << " structures/s" << endl;
+    }
+  } catch (const std::exception& e) {
+    std::clog << "error: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::clog << "unknown error" << std::endl;
+    return 2;
+  }
+}
+#endif